@@ -22,6 +22,39 @@ void finalize_grackle () {
     free_chemistry_data();
 }
 
+// Set to 1 when restarting: the ionization state and the derived
+// fields (Vgrac) are read from the checkpoint, so the equilibrium
+// solve is skipped and ions are not re-normalized on the first call.
+static int grackle_restart = 0;
+
+void grackle_set_restart (int restart) {
+    grackle_restart = restart;
+}
+
+// Wall-clock time spent in call_grackle() (total), in solve_chemistry()
+// and in the derived-field calls (cooling time, temperature, pressure),
+// and the number of cells processed. What is left of the total is spent
+// copying PLUTO arrays to and from the Grackle fields.
+static double grackle_time_total = 0., grackle_time_solve = 0., grackle_time_derived = 0.;
+static double grackle_ncells = 0.;
+
+static double grackle_clock () {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1.e-9*(double)ts.tv_nsec;
+}
+
+void grackle_timing_info (double *t_total, double *t_solve, double *t_derived, double *ncells, int reset) {
+    *t_total   = grackle_time_total;
+    *t_solve   = grackle_time_solve;
+    *t_derived = grackle_time_derived;
+    *ncells    = grackle_ncells;
+    if (reset) {
+        grackle_time_total = grackle_time_solve = grackle_time_derived = 0.;
+        grackle_ncells = 0.;
+    }
+}
+
 void normalize_ions_grackle (const Data *d, const chemistry_data *grackle_config_data, int i, int j, int k) {
     // normalize the ion fractions at cell center
     double norm_H = 0., norm_He = 0.;
@@ -53,6 +86,10 @@ void normalize_ions_grackle (const Data *d, const chemistry_data *grackle_config
 }
 
 void call_grackle_equil (const Data *d, Grid *grid) {
+    if (grackle_restart) {
+        print("> call_grackle_equil(): restarting, equilibrium solve skipped\n");
+        return;
+    }
     double time = 13.6*1.0e+09*365*24*60*60/(UNIT_LENGTH/UNIT_VELOCITY); // Age of universe
     call_grackle(d, time, NULL, grid, 0, 0, 0, 0);
 }
@@ -80,6 +117,7 @@ void call_grackle (const Data *d, double dt, timeStep *Dts, Grid *grid, int one_
     static chemistry_data *grackle_config_data;
     static timeStep *Dts_prev_call = NULL;
     static int once_cell_prev = 1;
+    double t_beg = grackle_clock(), t0;
 
     // This ensures that everything in Grackle is refreshed if one cell or equilibrium was called earlier
     if (Dts_prev_call==NULL || once_cell_prev==1) once = 0;
@@ -275,7 +313,7 @@ void call_grackle (const Data *d, double dt, timeStep *Dts, Grid *grid, int one_
             k = cell_k;
         }
         // printLog("DEBUG: (k, j, i, id) = (%d, %d, %d, %d) \n", k, j, i, id);
-        if (once==0 || one_cell==1) normalize_ions_grackle(d, grackle_config_data, i, j, k);
+        if ((once==0 && !grackle_restart) || one_cell==1) normalize_ions_grackle(d, grackle_config_data, i, j, k);
 	    grackle_chemistry_fields.density[id] = (gr_float)d->Vc[RHO][k][j][i];
         if (grackle_config_data->primordial_chemistry >= 1) {
             grackle_chemistry_fields.HI_density[id] = (gr_float)(d->Vc[X_HI][k][j][i]) * grackle_config_data->HydrogenFractionByMass * grackle_chemistry_fields.density[id];
@@ -332,10 +370,14 @@ void call_grackle (const Data *d, double dt, timeStep *Dts, Grid *grid, int one_
     *********************************************************************/
 
     // printLog("Evolving chemistry...\n");
+    PROFILE_BEG(PROF_GRACKLE);
+    t0 = grackle_clock();
     if (solve_chemistry(&grackle_code_units, &grackle_chemistry_fields, dt) == 0) {
         printLog("call_grackle(): Error in solve_chemistry.\n");
         QUIT_PLUTO(1);
     }
+    grackle_time_solve += grackle_clock() - t0;
+    PROFILE_END(PROF_GRACKLE);
 
     // Calculate cooling time.
     static gr_float *cooling_time;
@@ -343,6 +385,7 @@ void call_grackle (const Data *d, double dt, timeStep *Dts, Grid *grid, int one_
         if (cooling_time!=NULL) FreeArray1D(cooling_time);
         cooling_time = ARRAY_1D((one_cell==0)?(grid->np_int[KDIR] * grid->np_int[JDIR] * grid->np_int[IDIR]):1, gr_float);
     }
+    t0 = grackle_clock();
     if (Dts!=NULL) {
         if (calculate_cooling_time(&grackle_code_units, &grackle_chemistry_fields,
                                 cooling_time) == 0) {
@@ -385,6 +428,7 @@ void call_grackle (const Data *d, double dt, timeStep *Dts, Grid *grid, int one_
             QUIT_PLUTO(1);
         }
     }
+    grackle_time_derived += grackle_clock() - t0;
     // int count = 0;
     counter = 0;
     DOM_LOOP(k, j, i) {
@@ -401,6 +445,7 @@ void call_grackle (const Data *d, double dt, timeStep *Dts, Grid *grid, int one_
         }
         // printLog("> step %d t=%e, dt=%e, before: prs/kB = %e, temp = %e, mu=%f\n", g_stepNumber, g_time, g_dt, (d->Vc[PRS][k][j][i]*UNIT_DENSITY*pow(UNIT_VELOCITY,2))/CONST_kB, d->Vgrac[TEMP][k][j][i], d->Vgrac[MU][k][j][i]);
         if (Dts!=NULL) d->Vc[PRS][k][j][i] = pressure[id];
+        if (Dts!=NULL) d->Vgrac[TCOOL][k][j][i] = cooling_time[id];
         d->Vgrac[TEMP][k][j][i] = temperature[id];
         if (one_cell==1)
             d->Vgrac[MU][k][j][i] = (d->Vc[RHO][k][j][i]*UNIT_DENSITY)/(d->Vc[PRS][k][j][i]*UNIT_DENSITY*pow(UNIT_VELOCITY, 2))*(CONST_kB/CONST_mp)*d->Vgrac[TEMP][k][j][i];
@@ -433,6 +478,7 @@ void call_grackle (const Data *d, double dt, timeStep *Dts, Grid *grid, int one_
     }
     if (one_cell==0)
         MeanMolecularWeight(d, grid);
+    if (Dts!=NULL) grackle_restart = 0;
     // printLog(stdout, "pressure = %24.16g dyne/cm^2\n", pressure[1][1][1]*pressure_units);
 
     /*
@@ -460,6 +506,8 @@ void call_grackle (const Data *d, double dt, timeStep *Dts, Grid *grid, int one_
 
     // printLog("dust_temperature = %24.16g K\n", dust_temperature[1][1][1]);
     */
+    grackle_time_total += grackle_clock() - t_beg;
+    grackle_ncells += (one_cell==0)?((double)grid->np_int[KDIR] * grid->np_int[JDIR] * grid->np_int[IDIR]):1.;
     if (one_cell==0) {
         once ++;
     }
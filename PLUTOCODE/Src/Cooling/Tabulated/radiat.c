@@ -15,24 +15,26 @@
 
 extern double gCooling_x1, gCooling_x2, gCooling_x3;
 
+static int    ntab;
+static double *L_tab, *T_tab, E_cost;
+
 /* ***************************************************************** */
-void Radiat (double *v, double *rhs)
+void CoolingTableRead (void)
 /*!
- *   Provide r.h.s. for tabulated cooling.
+ *  Read the tabulated cooling function from "cooltable.dat".
+ *  The table is read by one processor per node and stored in
+ *  node-shared memory (see shared_table.c), so this function is
+ *  collective and is called by Initialize().
  * 
  ******************************************************************* */
 {
-  int    klo, khi, kmid;
-  static int ntab;
-  double  mu, muH, mue, T, Tmid, scrh, dT, prs;
-  static double *L_tab, *T_tab, E_cost;
-  double dummy[4];
-  
-/* -------------------------------------------
-        Read tabulated cooling function
-   ------------------------------------------- */
+  long int n = 0;
+  double *tab, *Tbuf = NULL, *Lbuf = NULL;
 
-  if (T_tab == NULL){
+  if (T_tab != NULL) return;
+
+  E_cost = UNIT_LENGTH/UNIT_DENSITY/pow(UNIT_VELOCITY, 3.0);
+  if (SharedTableBuilder()){
     FILE *fcool;
     printLog (" > Reading table from disk...\n");
     fcool = fopen("cooltable.dat","r");
@@ -40,18 +42,47 @@ void Radiat (double *v, double *rhs)
       printLog ("! Radiat: cooltable.dat could not be found.\n");
       QUIT_PLUTO(1);
     }
-    L_tab = ARRAY_1D(20000, double);
-    T_tab = ARRAY_1D(20000, double);
+    Lbuf = ARRAY_1D(20000, double);
+    Tbuf = ARRAY_1D(20000, double);
 
-    ntab = 0;
-    while (fscanf(fcool, "%lf  %lf\n", T_tab + ntab, 
-                                       L_tab + ntab)!=EOF) {
-      ntab++;
+    while (fscanf(fcool, "%lf  %lf\n", Tbuf + n, Lbuf + n)!=EOF) {
+      n++;
     }
-    E_cost = UNIT_LENGTH/UNIT_DENSITY/pow(UNIT_VELOCITY, 3.0);
     fclose(fcool);
   }
 
+  tab = SharedTableAlloc (2*n, &n);
+  ntab  = n/2;
+  T_tab = tab;
+  L_tab = tab + ntab;
+  if (Tbuf != NULL){
+    for (n = 0; n < ntab; n++){
+      T_tab[n] = Tbuf[n];
+      L_tab[n] = Lbuf[n];
+    }
+    FreeArray1D ((void *)Tbuf);
+    FreeArray1D ((void *)Lbuf);
+  }
+  SharedTableSync();
+}
+
+/* ***************************************************************** */
+void Radiat (double *v, double *rhs)
+/*!
+ *   Provide r.h.s. for tabulated cooling.
+ * 
+ ******************************************************************* */
+{
+  int    klo, khi, kmid;
+  double  mu, muH, mue, T, Tmid, scrh, dT, prs;
+  double dummy[4];
+  
+/* -------------------------------------------
+        Read tabulated cooling function
+   ------------------------------------------- */
+
+  if (T_tab == NULL) CoolingTableRead();
+
 /* ---------------------------------------------
             Get pressure and temperature 
    --------------------------------------------- */
@@ -5,44 +5,70 @@ extern double *g_invT_tab, *g_invY_tab, *g_Y_tab, *g_L_tab, *g_T_tab;
 extern int g_ntab;
 
 /* ***************************************************************** */
-void Radiat (double *v, double *rhs)
+void CoolingTableRead (void)
 /*!
- *   Provide r.h.s. for tabulated cooling.
+ *  Read the Townsend cooling table from "cooltable_townsend.dat".
+ *  The table is read by one processor per node and stored in
+ *  node-shared memory (see shared_table.c), so this function is
+ *  collective and is called by Initialize().
  * 
  ******************************************************************* */
 {
-  //int    klo, khi, kmid;
-  static int ntab;
-  double  mu, muH, mue, mui, T, lam, ne, ni, nH, n, prs; 
-  double E_cost;
-  double dummy[4];
-  
-  FILE *fcool;
+  int  k;
+  long int n = 0, ntab;
+  double *tab, *buf[5] = {NULL}, **dst[5];
 
-/* -------------------------------------------
-        Read tabulated cooling function
-   ------------------------------------------- */
+  if (g_T_tab != NULL) return; //This line ensures reading is done only once per run
+
+  dst[0] = &g_T_tab; dst[1] = &g_L_tab; dst[2] = &g_Y_tab;
+  dst[3] = &g_invY_tab; dst[4] = &g_invT_tab;
 
-  if (g_T_tab == NULL){ //This line ensures reading is done only once per run
+  if (SharedTableBuilder()){
+    FILE *fcool;
     print (" > Reading table %s from disk...\n","cooltable_townsend.dat");
     fcool = fopen("./cooltable_townsend.dat","r");
     if (fcool == NULL){
       print ("! Radiat: %s could not be found.\n","cooltable_townsend.dat");
       QUIT_PLUTO(1);
     }
-    g_L_tab =    ARRAY_1D(20000, double);
-    g_T_tab =    ARRAY_1D(20000, double);
-    g_Y_tab =    ARRAY_1D(20000, double); 
-    g_invT_tab = ARRAY_1D(20000, double);
-    g_invY_tab = ARRAY_1D(20000, double);
+    for (k = 0; k < 5; k++) buf[k] = ARRAY_1D(20000, double);
 
-    ntab = 0;
-    while (fscanf(fcool, "%lf %lf %lf %lf %lf\n", g_T_tab + ntab, 
-                                       g_L_tab + ntab, g_Y_tab + ntab, g_invY_tab + ntab, g_invT_tab + ntab)!=EOF) { 
-	  ntab++;
+    while (fscanf(fcool, "%lf %lf %lf %lf %lf\n", buf[0] + n, 
+                  buf[1] + n, buf[2] + n, buf[3] + n, buf[4] + n)!=EOF) { 
+	  n++;
     }
-    g_ntab = ntab; //number of rows in cooling data
+    fclose(fcool);
   }
+
+  tab  = SharedTableAlloc (5*n, &n);
+  ntab = n/5;
+  for (k = 0; k < 5; k++){
+    *dst[k] = tab + k*ntab;
+    if (buf[k] != NULL){
+      for (n = 0; n < ntab; n++) (*dst[k])[n] = buf[k][n];
+      FreeArray1D ((void *)buf[k]);
+    }
+  }
+  SharedTableSync();
+  g_ntab = ntab; //number of rows in cooling data
+}
+
+/* ***************************************************************** */
+void Radiat (double *v, double *rhs)
+/*!
+ *   Provide r.h.s. for tabulated cooling.
+ * 
+ ******************************************************************* */
+{
+  double  mu, muH, mue, mui, T, lam, ne, ni, nH, n, prs; 
+  double E_cost;
+  double dummy[4];
+  
+/* -------------------------------------------
+        Read tabulated cooling function
+   ------------------------------------------- */
+
+  if (g_T_tab == NULL) CoolingTableRead();
   E_cost = UNIT_DENSITY*UNIT_VELOCITY*UNIT_VELOCITY*UNIT_VELOCITY/UNIT_LENGTH;
   //print("mark %e\n",g_invY_tab[0]);
 /* ---------------------------------------------
@@ -21,6 +21,16 @@
 #define NVAR_COOLING  (NVAR+1)
 #define RHOE   NVAR
 
+/* ********************************************************
+    With COOLING_SUBCYCLE set to YES the source term is
+    sub-cycled in each zone with its own cooling time and
+    dt_cool no longer limits the hydro time step.
+   ******************************************************** */
+
+#ifndef COOLING_SUBCYCLE
+  #define COOLING_SUBCYCLE  NO
+#endif
+
 /* ********************************************************
     Function prototypes
    ******************************************************** */
@@ -35,7 +45,10 @@ void   Numerical_Jacobian (double *, double **);
 #endif
 #if COOLING == POWER_LAW
  void  PowerLawCooling (Data_Arr, double, timeStep *, Grid *);
+#elif COOLING == TABULATED
+ void  CoolingTableRead(void);
 #elif COOLING == TOWNSEND
+ void   CoolingTableRead(void);
  double lambda_interp(double );
  double Y_interp(double );
  double invY_interp(double );
@@ -57,10 +70,12 @@ double SolveODE_ROS34 (double *, double *, double *, double, double);
 #include "grackle.h"
 void grackle_cooling_version_info (char *);
 void finalize_grackle ();
+void grackle_set_restart (int);
 void call_grackle_equil (const Data *, Grid *);
 void normalize_ions_grackle (const Data *, const chemistry_data *, int, int, int);
 void call_grackle (const Data *, double, timeStep *, Grid *, int, int, int, int);
 void call_grackle_equil_by_cell (const Data *, Grid *, int, int, int);
+void grackle_timing_info (double *, double *, double *, double *, int);
   #define NIONS    13
   #define X_HI       (NFLX)
   #define X_HII      (NFLX + 1)
@@ -20,6 +20,11 @@
   \f]
   where \f$ M_R \f$ is the maximum cooling rate (defined by the global variable  
   ::g_maxCoolingRate) and X are the chemical species.
+  When \c COOLING_SUBCYCLE is set to \c YES this estimate is only
+  reported in the log file and does not limit the time step; the
+  Townsend integrator then takes a number of sub-steps set by the
+  cooling time of each zone instead of the global minimum (the other
+  integrators already adapt their step size zone by zone).
   
   \b References
      - "Simulating radiative astrophysical flows with the PLUTO code:
@@ -57,7 +62,7 @@ void CoolingSource (const Data *d, double dt, timeStep *Dts, Grid *grid)
 {
     call_grackle(d, dt, Dts, grid, 0, 0, 0, 0);
 }
-#elif (COOLING != TOWNSEND) && (COOLING ! =GRACKLE)
+#elif (COOLING != TOWNSEND) && (COOLING != GRACKLE)
 /* ********************************************************
     Global coordinates available in the Radiat() function
    ******************************************************** */
@@ -121,6 +126,9 @@ void CoolingSource (const Data *d, double dt, timeStep *Dts, Grid *grid)
     if (d->flag[k][j][i] & FLAG_INTERNAL_BOUNDARY) continue;
     #endif
     if (d->flag[k][j][i] & FLAG_SPLIT_CELL) continue;
+    #if ACTIVE_TILES == YES
+    if (!ActiveTilesCell(k,j,i)) continue;
+    #endif
     NVAR_LOOP(nv) v0[nv] = v1[nv] = d->Vc[nv][k][j][i];
 
   /* ------------------------------------------------------
@@ -373,7 +381,11 @@ void CoolingSource (const Data *d, double dt, timeStep *Dts, Grid *grid)
   
   NVAR_LOOP(nv) k1[nv] = 0.0;  
 
+#if COOLING_SUBCYCLE == NO
   DOM_LOOP(k,j,i){  /* -- span the computational domain to find minimum tcool and global code step gets modified accordingly-- */
+  #if ACTIVE_TILES == YES
+   if (!ActiveTilesCell(k,j,i)) continue;
+  #endif
    NVAR_LOOP(nv) v0[nv] = v1[nv] = d->Vc[nv][k][j][i];
    
    
@@ -404,14 +416,19 @@ void CoolingSource (const Data *d, double dt, timeStep *Dts, Grid *grid)
     -----------------------------------------------------------  */
  
 /* -----------------------------------------------------
- *     Subcycling starts here
+ *     Subcycling starts here. The number of sub-steps is
+ *     the same for all zones or, with COOLING_SUBCYCLE,
+ *     set by the cooling time of each zone. Zones are
+ *     independent so that the zone loop is the outer one.
  * ----------------------------------------------------- */
   dt_sub = 1.0/(1.0/(Dts->dt_cool/n_sub_max) + 2./dt); //Subcycle limit
   int sub_steps = (int)ceil(dt/dt_sub);
   dt_sub = dt/sub_steps;
+#else
+  int sub_steps;
+#endif
   int n_sub = 0; 
-  for (n_sub = 0; n_sub<sub_steps; n_sub++ ){
-    DOM_LOOP(k,j,i){  /* -- span the computational domain -- */
+  DOM_LOOP(k,j,i){  /* -- span the computational domain -- */
       /* --------------------------------------------------
          Skip integration if cell has been tagged with 
          FLAG_INTERNAL_BOUNDARY or FLAG_SPLIT_CELL 
@@ -421,6 +438,28 @@ void CoolingSource (const Data *d, double dt, timeStep *Dts, Grid *grid)
      if (d->flag[k][j][i] & FLAG_INTERNAL_BOUNDARY) continue;
     #endif
      if (d->flag[k][j][i] & FLAG_SPLIT_CELL) continue;
+    #if ACTIVE_TILES == YES
+     if (!ActiveTilesCell(k,j,i)) continue;
+    #endif
+
+    #if COOLING_SUBCYCLE == YES
+     NVAR_LOOP(nv) v0[nv] = d->Vc[nv][k][j][i];
+     mu0 = MeanMolecularWeight(v0, dummy0);
+     T0  = v0[PRS]/v0[RHO]*KELVIN*mu0;
+     #if EOS == IDEAL
+     v0[RHOE] = v0[PRS]/(g_gamma-1.0);
+     #else
+     v0[RHOE] = InternalEnergy(v0, T0);
+     #endif
+     Radiat(v0, k1);
+     tcool = -v0[RHOE]/k1[RHOE];
+     Dts->dt_cool = MIN(Dts->dt_cool, tcool);
+     dt_sub    = 1.0/(1.0/(tcool/n_sub_max) + 2./dt);
+     sub_steps = (int)ceil(dt/dt_sub);
+     dt_sub    = dt/sub_steps;
+    #endif
+
+    for (n_sub = 0; n_sub < sub_steps; n_sub++){
      
      /* ------------------------------------------------------
      1A. Define global coordinates.
@@ -509,9 +548,9 @@ void CoolingSource (const Data *d, double dt, timeStep *Dts, Grid *grid)
       * ------------------------------------------------------ */
      d->Vc[PRS][k][j][i] = prs;
      NIONS_LOOP(nv) d->Vc[nv][k][j][i] = v1[nv];
-    } /* -- End DOM_LOOP(k,j,i) -- */
   //print("Temp %e     step %d     time %e     tcool %e\n",T1,n_sub,g_time,Dts->dt_cool);
-  }   /* -- End Subcycle Loop   -- */
+    }   /* -- End Subcycle Loop   -- */
+  } /* -- End DOM_LOOP(k,j,i) -- */
 }
 
 double lambda_interp(double temperature) {
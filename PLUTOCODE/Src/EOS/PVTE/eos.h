@@ -73,6 +73,13 @@
                                 energy will be redefined accordingly. */
 #endif
 
+#ifndef PVTE_TABLE_CACHE
+ #define PVTE_TABLE_CACHE  YES  /**< Save the EOS tables to binary cache
+                                     files and reload them at the next
+                                     start when the key (EOS law, table
+                                     layout and units) is unchanged. */
+#endif
+
 #if ENTROPY_SWITCH
  #error ! PVTE_LAW not working with ENTROPY_SWITCH
 #endif
@@ -94,6 +101,7 @@ void   MakeInternalEnergyTable();
 void   MakePV_TemperatureTable();
 void   MakeEV_TemperatureTable();
 double Pressure(double *, double);
+unsigned long long PVTE_TableKey (Table2D *, char *);
 /* \endcond */
 
 struct func_param {
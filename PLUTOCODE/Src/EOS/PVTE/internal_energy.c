@@ -69,15 +69,32 @@ void MakeInternalEnergyTable()
  *
  *********************************************************************** */
 {
-  int i,j;
+  int i,j, builder;
   double x, y, q;
   double T, rho, v[NVAR];
+  unsigned long long key;
 
+  builder = InitializeSharedTable2D(&rhoe_tab, 1.0, 1.e8, TV_ENERGY_TABLE_NX, 
+                                    1.e-6, 1.e6, TV_ENERGY_TABLE_NY);  
+  rhoe_tab.interpolation = SPLINE1;
+
+/* -- Only one processor per node builds the (shared) table -- */
+
+  if (!builder){
+    SharedTableSync();
+    return;
+  }
+  #if PVTE_TABLE_CACHE == YES
+  key = PVTE_TableKey(&rhoe_tab, "rhoe(T,rho)");
+  if (ReadTable2DCache("rhoe_tab.cache", &rhoe_tab, key) == 0){
+    printLog ("> MakeInternalEnergyTable(): table read from rhoe_tab.cache\n");
+    SharedTableSync();
+    return;
+  }
+  #endif
   printLog ("> MakeInternalEnergyTable(): Generating table (%d x %d points)\n",
            TV_ENERGY_TABLE_NX, TV_ENERGY_TABLE_NY);
 
-  InitializeTable2D(&rhoe_tab, 1.0, 1.e8, TV_ENERGY_TABLE_NX, 
-                               1.e-6, 1.e6, TV_ENERGY_TABLE_NY);  
   for (j = 0; j < rhoe_tab.ny; j++){
   for (i = 0; i < rhoe_tab.nx; i++){
     T   = rhoe_tab.x[i];
@@ -86,8 +103,6 @@ void MakeInternalEnergyTable()
     rhoe_tab.f[j][i] = InternalEnergyFunc(v,T);
   }}
 
-  rhoe_tab.interpolation = SPLINE1;
-
 /* ----------------------------------------------------------------
     Compute cubic spline coefficients
    ---------------------------------------------------------------- */
@@ -140,7 +155,11 @@ fclose(fp);
 
 
   FinalizeTable2D(&rhoe_tab);
+  SharedTableSync();
   if (prank == 0) WriteBinaryTable2D("rhoe_tab.bin",&rhoe_tab);  
+  #if PVTE_TABLE_CACHE == YES
+  if (prank == 0) WriteTable2DCache("rhoe_tab.cache", &rhoe_tab, key);
+  #endif
 }
 
 /* ********************************************************************* */
@@ -199,11 +218,26 @@ void MakeEV_TemperatureTable()
 {
   int i,j, status;
   double rhoe, rho, Tlo, Thi, T;
+  unsigned long long key;
   struct func_param par;
 
+/* -- Only one processor per node builds the (shared) table -- */
+
+  if (!InitializeSharedTable2D(&Trhoe_tab, 1.e-9, 1.e9, 1200,
+                                           1.e-12, 1.e12, 1200)){
+    SharedTableSync();
+    return;
+  }
+  #if PVTE_TABLE_CACHE == YES
+  key = PVTE_TableKey(&Trhoe_tab, "T(rhoe,rho)");
+  if (ReadTable2DCache("Trhoe_tab.cache", &Trhoe_tab, key) == 0){
+    printLog ("> MakeEV_TemperatureTable(): table read from Trhoe_tab.cache\n");
+    SharedTableSync();
+    return;
+  }
+  #endif
   printLog ("> MakeEV_TemperatureTable(): Generating table...\n");
 
-  InitializeTable2D(&Trhoe_tab, 1.e-9, 1.e9, 1200, 1.e-12, 1.e12, 1200);
   Tlo = 1.0;
   Thi = 1.e12; 
 
@@ -245,7 +279,11 @@ fclose(fp);
    ------------------------------------------------------- */
 
   FinalizeTable2D(&Trhoe_tab);
+  SharedTableSync();
   if (prank == 0)  WriteBinaryTable2D("Trhoe_tab.bin",&Trhoe_tab);  
+  #if PVTE_TABLE_CACHE == YES
+  if (prank == 0)  WriteTable2DCache("Trhoe_tab.cache", &Trhoe_tab, key);
+  #endif
 }
 #undef NRHO
 #undef NRHOE
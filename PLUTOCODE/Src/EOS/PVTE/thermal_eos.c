@@ -38,6 +38,9 @@
   finder) or to replace the runtime computation with a simpler 
   array indexing operation followed by a combination of lookup table 
   and bilinear (direct or inverse) interpolation.
+  When ::PVTE_TABLE_CACHE is enabled, EOS tables are saved to binary
+  cache files (e.g. \c T_tab.cache) and reloaded at the next start
+  if their key, computed by PVTE_TableKey(), has not changed.
   
   \author A. Mignone (mignone@ph.unito.it)\n
           B. Vaidya
@@ -59,6 +62,40 @@ static Table2D  Ttab; /**< A 2D table containing pre-computed values of
 #if NIONS == 0
 static double TFunc(double T, void *par);
 
+/* ********************************************************************* */
+unsigned long long PVTE_TableKey (Table2D *tab, char *name)
+/*!
+ * Compute the key identifying an EOS table in the cache: a hash of
+ * the table name and layout, the unit normalizations and the values
+ * of InternalEnergyFunc() and GetMu() at a few probe points (which
+ * change whenever the EOS law or its parameters change).
+ *
+ * \param [in] tab   pointer to an initialized Table2D structure
+ * \param [in] name  a label identifying the table
+ *
+ *********************************************************************** */
+{
+  int    i, j;
+  double v[NVAR], q[3];
+  double units[4] = {UNIT_DENSITY, UNIT_LENGTH, UNIT_VELOCITY, KELVIN};
+  unsigned long long h = TABLE2D_HASH_INIT;
+
+  h = Table2DHash(h, name, strlen(name));
+  h = Table2DHash(h, units, sizeof(units));
+  h = Table2DKey (tab, h);
+
+  NVAR_LOOP(i) v[i] = 0.0;
+  for (i = 0; i < 4; i++){   /* T   = 1e2 ... 1e8 K  */
+  for (j = 0; j < 3; j++){   /* rho = 1e-4 ... 1e4   */
+    q[0]   = pow(10.0, 2.0 + 2.0*i);
+    v[RHO] = pow(10.0, -4.0 + 4.0*j);
+    q[1]   = InternalEnergyFunc(v, q[0]);
+    GetMu(q[0], v[RHO], q + 2);
+    h = Table2DHash(h, q, sizeof(q));
+  }}
+  return h;
+}
+
 /* ********************************************************************* */
 void MakePV_TemperatureTable()
 /*!
@@ -79,13 +116,12 @@ void MakePV_TemperatureTable()
  *
  *********************************************************************** */
 {
-  int i,j, status;
+  int i,j, status, builder;
   double prs, rho, T1, Tlo, Thi, T, logK = log10(KELVIN);
   double mu_lo, mu_hi;
+  unsigned long long key;
   struct func_param par;
 
-  printLog ("> MakePV_TemperatureTable: Generating table...\n");
-
 /* --------------------------------------------------------------
     Initialize table. The two table axis are given by 
     ln(x) = log(p/rho) and ln(y) = log(rho). 
@@ -93,8 +129,25 @@ void MakePV_TemperatureTable()
     T/mu = 10^7 K, respectively.
    -------------------------------------------------------------- */
 
-  InitializeTable2D(&Ttab,1.0/KELVIN, 1.e7/KELVIN, PV_TEMPERATURE_TABLE_NX, 
-                          1.e-7     , 1.e7, PV_TEMPERATURE_TABLE_NY);
+  builder = InitializeSharedTable2D(&Ttab,1.0/KELVIN, 1.e7/KELVIN,
+                                    PV_TEMPERATURE_TABLE_NX, 
+                                    1.e-7, 1.e7, PV_TEMPERATURE_TABLE_NY);
+
+/* -- Only one processor per node builds the (shared) table -- */
+
+  if (!builder){
+    SharedTableSync();
+    return;
+  }
+  #if PVTE_TABLE_CACHE == YES
+  key = PVTE_TableKey(&Ttab, "T(p/rho,rho)");
+  if (ReadTable2DCache("T_tab.cache", &Ttab, key) == 0){
+    printLog ("> MakePV_TemperatureTable: table read from T_tab.cache\n");
+    SharedTableSync();
+    return;
+  }
+  #endif
+  printLog ("> MakePV_TemperatureTable: Generating table...\n");
 
 /* -----------------------------------------------------------------
     Guess the smallest and largest value of \mu. 
@@ -129,7 +182,11 @@ void MakePV_TemperatureTable()
   }}
   
   FinalizeTable2D(&Ttab);
+  SharedTableSync();
   if (prank == 0)  WriteBinaryTable2D("T_tab.bin",&Ttab);  
+  #if PVTE_TABLE_CACHE == YES
+  if (prank == 0)  WriteTable2DCache("T_tab.cache", &Ttab, key);
+  #endif
 
 #if 0 /* Table-to-Table conversion: attempt to interpolate from another table */
 {
@@ -0,0 +1,517 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Spectral Ornstein-Uhlenbeck turbulence driver.
+
+  The acceleration is the real field
+  \f[
+    \vec{a}(\vec{x}) = 2\sum_m \left[\vec{a}^r_m\cos(\vec{k}_m\cdot\vec{x})
+                              - \vec{a}^i_m\sin(\vec{k}_m\cdot\vec{x})\right]
+  \f]
+  where, for each mode, \f$ \vec{a}^r_m + i\vec{a}^i_m \f$ is the
+  projection of a complex vector whose 6 components are independent
+  OU processes.
+
+  The field is evaluated exploiting the separability of
+  \f$ e^{i\vec{k}\cdot\vec{x}} = e^{ik_xx}e^{ik_yy}e^{ik_zz} \f$:
+  sin/cos of every integer wavenumber along every axis are tabulated
+  once, so that the cell loop costs 6 multiply-adds per mode and no
+  trigonometric function is called.
+
+  The OU sequence is generated by a private generator whose state is
+  the same on all processors (no communication is needed) and is
+  saved, together with the OU phases, in "forced_turb.out" with one
+  record for each restart.out entry.
+
+  \date   Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+
+static ForcedTurb *s_Ft;                  /* Set by ForcedTurb_Init() */
+static unsigned long long s_rng = FT_SEED; /* OU random sequence state */
+
+static double FT_Gaussian (void);
+
+/* ********************************************************************* */
+void ForcedTurb_Init (ForcedTurb *Ft)
+/*!
+ * Select the forced modes, set their amplitudes and allocate memory.
+ *
+ * \param [out] Ft  pointer to the ForcedTurb structure
+ *
+ *********************************************************************** */
+{
+  int    d, m, n[3], nmin[3];
+  double L[3], kk, kc, ksum, norm, zeta = FT_SOL_WEIGHT;
+
+  for (d = 0; d < 3; d++){
+    L[d] = g_domEnd[d] - g_domBeg[d];
+    Ft->nmax[d] = (d < DIMENSIONS ? (int)(FT_KMAX*L[d]/L[IDIR]):0);
+    nmin[d] = -Ft->nmax[d];
+  }
+  nmin[IDIR] = 0;
+
+  if (FT_KMAX < FT_KMIN || FT_DECAY <= 0.0 || FT_ENERGY_RATE < 0.0 ||
+      FT_STIR_FREQ < 1){
+    printLog ("! ForcedTurb_Init(): invalid forcing parameters\n");
+    QUIT_PLUTO(1);
+  }
+
+/* --------------------------------------------------------
+   1. Projection norm: the trace of P^2, with
+      P_ij = zeta*delta_ij + (1 - 2*zeta)*k_i*k_j/k^2,
+      is 1 - 2*zeta + D*zeta^2 in D dimensions.
+   -------------------------------------------------------- */
+
+  norm = 1.0 - 2.0*zeta + DIMENSIONS*zeta*zeta;
+  if (norm < 1.e-12){
+    printLog ("! ForcedTurb_Init(): FT_SOL_WEIGHT = %f leaves no forcing ",
+               zeta);
+    printLog ("in %dD\n", DIMENSIONS);
+    QUIT_PLUTO(1);
+  }
+
+/* --------------------------------------------------------
+   2. Select modes in half of k-space (k and -k give the
+      same real field) with FT_KMIN <= |k| <= FT_KMAX.
+      Two passes: count, then fill.
+   -------------------------------------------------------- */
+
+  kc = 0.5*(FT_KMIN + FT_KMAX);
+  Ft->NModes = 0;
+  for (m = 0; m < 2; m++){
+    int nm = 0;
+    ksum = 0.0;
+    for (n[IDIR] = nmin[IDIR]; n[IDIR] <= Ft->nmax[IDIR]; n[IDIR]++){
+    for (n[JDIR] = nmin[JDIR]; n[JDIR] <= Ft->nmax[JDIR]; n[JDIR]++){
+    for (n[KDIR] = nmin[KDIR]; n[KDIR] <= Ft->nmax[KDIR]; n[KDIR]++){
+      double amp = 1.0;
+
+      if (n[IDIR] == 0 && (n[JDIR] < 0 || (n[JDIR] == 0 && n[KDIR] <= 0))){
+        continue;
+      }
+      kk = 0.0;
+      for (d = 0; d < 3; d++) kk += n[d]*n[d]/(L[d]*L[d]);
+      kk = sqrt(kk)*L[IDIR];            /* In units of 2pi/Lx */
+      if (kk < FT_KMIN || kk > FT_KMAX) continue;
+
+      #if FT_SPECTRUM == FT_PARABOLIC
+      if (FT_KMAX > FT_KMIN) amp = 1.0 - (kk - kc)*(kk - kc)/((FT_KMAX - kc)*(FT_KMAX - kc));
+      if (amp <= 0.0) continue;
+      #endif
+
+      if (m == 1){
+        for (d = 0; d < 3; d++) Ft->Mode[nm][d] = n[d];
+        Ft->Amp[nm] = amp;
+      }
+      ksum += amp*amp;
+      nm++;
+    }}}
+
+    if (m == 0){
+      if (nm == 0){
+        printLog ("! ForcedTurb_Init(): no mode in [FT_KMIN, FT_KMAX]\n");
+        QUIT_PLUTO(1);
+      }
+      Ft->NModes = nm;
+      Ft->Mode   = ARRAY_2D(nm, 3, int);
+      Ft->Amp    = ARRAY_1D(nm, double);
+    }
+  }
+
+/* --------------------------------------------------------
+   3. Normalize amplitudes so that sum(Amp^2) = 1/4: the
+      rms acceleration is then equal to the OU variance.
+   -------------------------------------------------------- */
+
+  for (m = 0; m < Ft->NModes; m++) Ft->Amp[m] *= 0.5/sqrt(ksum);
+
+  Ft->StirFreq      = FT_STIR_FREQ;
+  Ft->StirDecay     = FT_DECAY;
+  Ft->SolWeight     = zeta;
+  Ft->SolWeightNorm = 1.0/sqrt(norm);
+  Ft->EnergyRate    = FT_ENERGY_RATE;
+  Ft->OUVar         = sqrt(FT_ENERGY_RATE/FT_DECAY);
+  Ft->AmpFactor     = 1.0;
+  Ft->InjRate       = FT_ENERGY_RATE;
+  Ft->AccValid      = 0;
+
+  Ft->OUPhases = ARRAY_1D(6*Ft->NModes, double);
+  Ft->aka      = ARRAY_2D(Ft->NModes, 3, double);
+  Ft->akb      = ARRAY_2D(Ft->NModes, 3, double);
+  for (d = 0; d < 3; d++){
+    Ft->Cs[d]  = NULL;
+    Ft->Sn[d]  = NULL;
+    Ft->Acc[d] = (d < DIMENSIONS ? ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, double)
+                                 : NULL);
+  }
+
+  s_Ft  = Ft;
+  s_rng = FT_SEED;
+
+  print ("> ForcedTurb_Init(): k = [%g, %g], zeta = %g, T = %g, eps = %g\n",
+          FT_KMIN, FT_KMAX, zeta, FT_DECAY, FT_ENERGY_RATE);
+}
+
+/* ********************************************************************* */
+void ForcedTurb_OUNoiseInit (double *ph, int n, double var)
+/*!
+ * Draw the initial OU state from its stationary distribution.
+ *
+ * \param [out] ph   array of OU phases
+ * \param [in]  n    number of phases
+ * \param [in]  var  OU variance
+ *********************************************************************** */
+{
+  int i;
+
+  for (i = 0; i < n; i++) ph[i] = var*FT_Gaussian();
+}
+
+/* ********************************************************************* */
+void ForcedTurb_OUNoiseUpdate (double *ph, int n, double var,
+                               double dt, double decay)
+/*!
+ * Advance the OU phases by dt:
+ * \f[
+ *   x \leftarrow f x + \sigma\sqrt{1-f^2}\,\xi \,,\qquad f = e^{-dt/T}
+ * \f]
+ * with \f$ \xi \f$ a unit normal deviate, which is exact for any dt.
+ *
+ * \param [in,out] ph     array of OU phases
+ * \param [in]     n      number of phases
+ * \param [in]     var    OU variance
+ * \param [in]     dt     time increment
+ * \param [in]     decay  OU correlation time
+ *********************************************************************** */
+{
+  int    i;
+  double f = exp(-dt/decay);
+  double s = var*sqrt(1.0 - f*f);
+
+  for (i = 0; i < n; i++) ph[i] = f*ph[i] + s*FT_Gaussian();
+}
+
+/* ********************************************************************* */
+void ForcedTurb_CalcPhases (ForcedTurb *Ft)
+/*!
+ * Project the OU phases with the solenoidal weight zeta,
+ * \f$ P_{ij} = \zeta\delta_{ij} + (1-2\zeta)k_ik_j/k^2 \f$,
+ * and store the real and imaginary parts of the mode amplitudes
+ * in Ft->aka and Ft->akb.
+ * The acceleration field is flagged for recomputation.
+ *
+ *********************************************************************** */
+{
+  int    d, m;
+  double k[3], k2, kr, ki, c, *R, *I;
+  double zeta = Ft->SolWeight;
+
+  for (m = 0; m < Ft->NModes; m++){
+    R = Ft->OUPhases + 6*m;
+    I = R + 3;
+    kr = ki = k2 = 0.0;
+    for (d = 0; d < DIMENSIONS; d++){
+      k[d] = Ft->Mode[m][d]/(g_domEnd[d] - g_domBeg[d]);
+      k2  += k[d]*k[d];
+      kr  += k[d]*R[d];
+      ki  += k[d]*I[d];
+    }
+    c = Ft->Amp[m]*Ft->SolWeightNorm;
+    for (d = 0; d < 3; d++){
+      if (d < DIMENSIONS){
+        Ft->aka[m][d] = c*(zeta*R[d] + (1.0 - 2.0*zeta)*k[d]*kr/k2);
+        Ft->akb[m][d] = c*(zeta*I[d] + (1.0 - 2.0*zeta)*k[d]*ki/k2);
+      }else{
+        Ft->aka[m][d] = Ft->akb[m][d] = 0.0;
+      }
+    }
+  }
+  Ft->AccValid = 0;
+}
+
+/* ********************************************************************* */
+void ForcedTurb_ComputeAcceleration (ForcedTurb *Ft, Grid *grid)
+/*!
+ * Evaluate the acceleration on the whole local grid (ghost zones
+ * included).
+ * At the first call, tabulate cos(k_n x) and sin(k_n x) for every
+ * integer wavenumber 0 <= n <= nmax along each axis.
+ *
+ *********************************************************************** */
+{
+  int    i, j, k, d, m, n;
+  int    ny, nz;
+  double cy, sy, cz, sz, cyz, syz;
+  double pc[3], ps[3], *cx, *sx, *a;
+
+/* --------------------------------------------------------
+   1. Per-axis tables (computed once)
+   -------------------------------------------------------- */
+
+  if (Ft->Cs[IDIR] == NULL){
+    for (d = 0; d < 3; d++){
+      double kd = 2.0*CONST_PI/(g_domEnd[d] - g_domBeg[d]);
+      int    ntot = grid->np_tot[d];
+
+      Ft->Cs[d] = ARRAY_2D(Ft->nmax[d] + 1, ntot, double);
+      Ft->Sn[d] = ARRAY_2D(Ft->nmax[d] + 1, ntot, double);
+      for (n = 0; n <= Ft->nmax[d]; n++){
+        for (i = 0; i < ntot; i++){
+          double x = (d < DIMENSIONS ? grid->x[d][i] - g_domBeg[d]:0.0);
+          Ft->Cs[d][n][i] = cos(kd*n*x);
+          Ft->Sn[d][n][i] = sin(kd*n*x);
+        }
+      }
+    }
+  }
+
+/* --------------------------------------------------------
+   2. Sum modes row by row. For each (j,k) and each mode
+      the y-z factor is combined once; the x loop is
+      then a pair of multiply-adds per component.
+      Negative ny, nz use sin(-t) = -sin(t).
+   -------------------------------------------------------- */
+
+  KTOT_LOOP(k) JTOT_LOOP(j){
+    for (d = 0; d < DIMENSIONS; d++){
+      a = Ft->Acc[d][k][j];
+      ITOT_LOOP(i) a[i] = 0.0;
+    }
+    for (m = 0; m < Ft->NModes; m++){
+      ny = Ft->Mode[m][JDIR];
+      nz = Ft->Mode[m][KDIR];
+      cy = Ft->Cs[JDIR][abs(ny)][j];
+      sy = Ft->Sn[JDIR][abs(ny)][j]*(ny < 0 ? -1.0:1.0);
+      cz = Ft->Cs[KDIR][abs(nz)][k];
+      sz = Ft->Sn[KDIR][abs(nz)][k]*(nz < 0 ? -1.0:1.0);
+      cyz = cy*cz - sy*sz;
+      syz = sy*cz + cy*sz;
+      cx  = Ft->Cs[IDIR][Ft->Mode[m][IDIR]];
+      sx  = Ft->Sn[IDIR][Ft->Mode[m][IDIR]];
+      for (d = 0; d < DIMENSIONS; d++){
+        pc[d] =  2.0*(Ft->aka[m][d]*cyz - Ft->akb[m][d]*syz);
+        ps[d] = -2.0*(Ft->aka[m][d]*syz + Ft->akb[m][d]*cyz);
+        a = Ft->Acc[d][k][j];
+        ITOT_LOOP(i) a[i] += pc[d]*cx[i] + ps[d]*sx[i];
+      }
+    }
+  }
+  Ft->AccValid = 1;
+}
+
+/* ********************************************************************* */
+void ForcedTurb_EnergyControl (ForcedTurb *Ft, const Data *d, double dt,
+                               Grid *grid)
+/*!
+ * Measure the specific energy injection rate of the current
+ * acceleration held constant for a time dt,
+ * \f[
+ *   \epsilon = \frac{1}{M}\int\rho\left(\alpha\vec{v}\cdot\vec{a}
+ *              + \frac{\alpha^2}{2}a^2\,dt\right)dV \,,
+ * \f]
+ * average it over one correlation time and relax the amplitude
+ * factor \f$ \alpha \f$ towards the target rate on the same time
+ * scale.
+ *
+ * \param [in,out] Ft    pointer to the ForcedTurb structure
+ * \param [in]     d     pointer to the PLUTO Data structure
+ * \param [in]     dt    time between two updates of the forcing
+ * \param [in]     grid  pointer to the Grid structure
+ *********************************************************************** */
+{
+  int    i, j, k, n;
+  double sum[3] = {0.0, 0.0, 0.0};
+  double rho, dV, va, a2, rate, ratio, f;
+  double alpha = Ft->AmpFactor;
+
+  DOM_LOOP(k,j,i){
+    rho = d->Vc[RHO][k][j][i];
+    dV  = grid->dV[k][j][i];
+    va  = a2 = 0.0;
+    for (n = 0; n < DIMENSIONS; n++){
+      va += d->Vc[VX1+n][k][j][i]*Ft->Acc[n][k][j][i];
+      a2 += Ft->Acc[n][k][j][i]*Ft->Acc[n][k][j][i];
+    }
+    sum[0] += rho*dV;
+    sum[1] += rho*va*dV;
+    sum[2] += rho*a2*dV;
+  }
+
+  #ifdef PARALLEL
+  MPI_Allreduce (MPI_IN_PLACE, sum, 3, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  #endif
+
+  rate = (alpha*sum[1] + 0.5*alpha*alpha*dt*sum[2])/sum[0];
+  f    = exp(-dt/Ft->StirDecay);
+  Ft->InjRate = f*Ft->InjRate + (1.0 - f)*rate;
+
+  ratio = (Ft->InjRate > 0.0 ? Ft->EnergyRate/Ft->InjRate:4.0);
+  ratio = MAX(ratio, 0.25);
+  ratio = MIN(ratio, 4.0);
+  Ft->AmpFactor *= pow(ratio, 0.5*(1.0 - f));
+}
+
+/* ********************************************************************* */
+void ForcedTurb_CorrectRHS (const Data *d, const Sweep *sweep,
+                            int beg, int end, double dt, Grid *grid)
+/*!
+ * Add the forcing along the current sweep direction to the right
+ * hand side: the momentum gains \f$ \rho a_n\,dt \f$ and the total
+ * energy \f$ \rho v_n a_n\,dt \f$.
+ *
+ * \param [in]     d      pointer to the PLUTO Data structure
+ * \param [in,out] sweep  pointer to the Sweep structure
+ * \param [in]     beg    initial index of computation
+ * \param [in]     end    final index of computation
+ * \param [in]     dt     the time step
+ * \param [in]     grid   pointer to the Grid structure
+ *********************************************************************** */
+{
+  int    i = g_i, j = g_j, k = g_k, n;
+  int   *in = (g_dir == IDIR ? &i : (g_dir == JDIR ? &j : &k));
+  double **v   = sweep->stateC.v;
+  double **rhs = sweep->rhs;
+  double ***A  = d->Ft->Acc[g_dir];
+  double scrh, adt = d->Ft->AmpFactor*dt;
+
+  for (n = beg; n <= end; n++){
+    *in  = n;
+    scrh = v[n][RHO]*A[k][j][i]*adt;
+    rhs[n][MXn] += scrh;
+    #if HAVE_ENERGY
+    rhs[n][ENG] += scrh*v[n][VXn];
+    #endif
+  }
+}
+
+/* ********************************************************************* */
+void ForcedTurb_StateDump (Runtime *ini, int nrec)
+/*!
+ * Write the OU state to "forced_turb.out", one record per
+ * restart.out entry.
+ * Called by processor 0 only.
+ *
+ *********************************************************************** */
+{
+  char fout[512];
+  ForcedTurb *Ft = s_Ft;
+  FILE *fr;
+  long int rsize;
+
+  if (Ft == NULL) return;
+  rsize = sizeof(int) + sizeof(s_rng) + (2 + 6*Ft->NModes)*sizeof(double);
+
+  sprintf (fout,"%s/forced_turb.out",ini->output_dir);
+  if (nrec == 0) {
+    fr = fopen (fout, "wb");
+  }else {
+    fr = fopen (fout, "r+b");
+    if (fr == NULL) fr = fopen (fout, "wb");
+  }
+  if (fr == NULL){
+    printLog ("! ForcedTurb_StateDump(): cannot open %s, ", fout);
+    printLog ("OU state not saved\n");
+    return;
+  }
+  fseek (fr, nrec*rsize, SEEK_SET);
+  fwrite (&Ft->NModes, sizeof(int), 1, fr);
+  fwrite (&s_rng, sizeof(s_rng), 1, fr);
+  fwrite (&Ft->AmpFactor, sizeof(double), 1, fr);
+  fwrite (&Ft->InjRate,   sizeof(double), 1, fr);
+  fwrite (Ft->OUPhases, sizeof(double), 6*Ft->NModes, fr);
+  fclose(fr);
+}
+
+/* ********************************************************************* */
+void ForcedTurb_StateRead (Runtime *ini, int nrec, int swap_endian)
+/*!
+ * Read the OU state saved with record \c nrec of restart.out.
+ * Processor 0 reads and broadcasts the state.
+ * If the record cannot be found the run continues with the initial
+ * OU state.
+ * Collective on MPI_COMM_WORLD.
+ *
+ * \param [in] ini          pointer to the Runtime structure
+ * \param [in] nrec         record number (significant on proc. 0)
+ * \param [in] swap_endian  swap endianity if set to 1
+ *********************************************************************** */
+{
+  int    i, nmodes, found = 0;
+  char   fout[512];
+  double hdr[2];
+  unsigned long long rng;
+  ForcedTurb *Ft = s_Ft;
+  FILE  *fr;
+  long int rsize = sizeof(int) + sizeof(rng) + (2 + 6*Ft->NModes)*sizeof(double);
+
+  if (prank == 0){
+    sprintf (fout,"%s/forced_turb.out",ini->output_dir);
+    fr = fopen (fout, "rb");
+    if (fr != NULL){
+      fseek (fr, nrec*rsize, SEEK_SET);
+      found =    fread (&nmodes, sizeof(int), 1, fr) == 1
+              && fread (&rng, sizeof(rng), 1, fr) == 1
+              && fread (hdr, sizeof(double), 2, fr) == 2;
+      if (swap_endian) SWAP_VAR(nmodes);
+      if (found && nmodes != Ft->NModes){
+        print ("! ForcedTurb_StateRead(): %d modes in forced_turb.out, %d ",
+                nmodes, Ft->NModes);
+        print ("expected\n");
+        QUIT_PLUTO(1);
+      }
+      found = found && (fread (Ft->OUPhases, sizeof(double), 6*nmodes, fr)
+                        == 6*nmodes);
+      fclose(fr);
+    }
+    if (!found){
+      print ("! ForcedTurb_StateRead(): OU state not found in forced_turb.out,\n");
+      print ("!                         a new forcing sequence will be used\n");
+    }else if (swap_endian){
+      SWAP_VAR(rng);
+      SWAP_VAR(hdr[0]);
+      SWAP_VAR(hdr[1]);
+      for (i = 0; i < 6*nmodes; i++) SWAP_VAR(Ft->OUPhases[i]);
+    }
+  }
+
+  #ifdef PARALLEL
+  MPI_Bcast (&found, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  #endif
+  if (!found) return;
+
+  #ifdef PARALLEL
+  MPI_Bcast (&rng, sizeof(rng), MPI_BYTE, 0, MPI_COMM_WORLD);
+  MPI_Bcast (hdr, 2, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+  MPI_Bcast (Ft->OUPhases, 6*Ft->NModes, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+  #endif
+
+  s_rng         = rng;
+  Ft->AmpFactor = hdr[0];
+  Ft->InjRate   = hdr[1];
+  ForcedTurb_CalcPhases (Ft);
+}
+
+/* ********************************************************************* */
+static double FT_Gaussian (void)
+/*!
+ * Return a unit normal deviate (Box-Muller) from the OU sequence.
+ * The sequence is a SplitMix64 generator: its whole state is the
+ * 64-bit integer s_rng, which makes restarts exact.
+ *
+ *********************************************************************** */
+{
+  int i;
+  double u[2];
+  unsigned long long z;
+
+  for (i = 0; i < 2; i++){
+    z = (s_rng += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27))*0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    u[i] = ((z >> 11) + 0.5)/9007199254740992.0;  /* In (0,1) */
+  }
+  return sqrt(-2.0*log(u[0]))*cos(2.0*CONST_PI*u[1]);
+}
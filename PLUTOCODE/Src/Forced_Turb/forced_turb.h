@@ -0,0 +1,106 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Forced turbulence module header file.
+
+  Stochastic driving of turbulence in a periodic Cartesian box.
+  The acceleration field is a sum of Fourier modes with wavenumbers
+  in [FT_KMIN, FT_KMAX] (in units of \f$ 2\pi/L_x \f$) whose complex
+  amplitudes evolve as Ornstein-Uhlenbeck (OU) processes with
+  correlation time \c FT_DECAY.
+  Modes are projected with a solenoidal weight \c FT_SOL_WEIGHT
+  (1 = purely solenoidal, 0 = purely compressive, 0.5 = natural
+  mixture).
+
+  The OU variance is set by the specific energy injection rate
+  \c FT_ENERGY_RATE \f$ \epsilon \f$ as
+  \f$ \sigma = \sqrt{\epsilon/T} \f$, so that the rms acceleration
+  is \f$ \sigma \f$.
+  With \c FT_ENERGY_CONTROL set to \c YES the amplitude is also
+  adjusted at run time so that the measured injection rate, averaged
+  over one correlation time, follows \f$ \epsilon \f$.
+
+  All the parameters may be redefined in definitions.h; they are in
+  code units.
+  The OU state is saved in "forced_turb.out" together with
+  restart.out.
+
+  \date   Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+
+#ifndef FT_KMIN
+  #define FT_KMIN            1.0    /**< Min. forced wavenumber (units of 2pi/Lx) */
+#endif
+
+#ifndef FT_KMAX
+  #define FT_KMAX            3.0    /**< Max. forced wavenumber (units of 2pi/Lx) */
+#endif
+
+#ifndef FT_SPECTRUM
+  #define FT_SPECTRUM        FT_PARABOLIC  /**< Shape of the forcing spectrum */
+#endif
+
+#ifndef FT_SOL_WEIGHT
+  #define FT_SOL_WEIGHT      1.0    /**< Solenoidal weight of the projection */
+#endif
+
+#ifndef FT_DECAY
+  #define FT_DECAY           1.0    /**< OU correlation (decay) time */
+#endif
+
+#ifndef FT_ENERGY_RATE
+  #define FT_ENERGY_RATE     1.0    /**< Specific energy injection rate */
+#endif
+
+#ifndef FT_ENERGY_CONTROL
+  #define FT_ENERGY_CONTROL  NO     /**< Adjust the amplitude to the measured
+                                         injection rate */
+#endif
+
+#ifndef FT_STIR_FREQ
+  #define FT_STIR_FREQ       1      /**< Number of steps between two updates
+                                         of the forcing field */
+#endif
+
+#ifndef FT_SEED
+  #define FT_SEED            140281 /**< Seed of the OU random sequence */
+#endif
+
+#define FT_BAND       1  /**< Constant amplitude in [FT_KMIN, FT_KMAX] */
+#define FT_PARABOLIC  2  /**< Parabolic profile peaking at (FT_KMIN+FT_KMAX)/2 */
+
+#if GEOMETRY != CARTESIAN
+  #error Forced turbulence requires CARTESIAN geometry
+#endif
+
+typedef struct ForcedTurb{
+  int     NModes;       /**< Number of forced modes */
+  int     StirFreq;     /**< Steps between two updates of the forcing */
+  int     AccValid;     /**< 0 when Acc[] must be recomputed from OUPhases */
+  int     nmax[3];      /**< Largest integer wavenumber along each axis */
+  int   **Mode;         /**< Integer wavevector of each mode, Mode[m][dir] */
+  double *Amp;          /**< Spectral amplitude of each mode */
+  double *OUPhases;     /**< OU state, 6 per mode (Re, Im of 3 components) */
+  double **aka, **akb;  /**< Projected Re and Im parts, aka[m][dir] */
+  double  OUVar;        /**< OU variance */
+  double  StirDecay;    /**< OU correlation time */
+  double  SolWeight;    /**< Solenoidal weight */
+  double  SolWeightNorm;/**< Normalization of the projection */
+  double  EnergyRate;   /**< Target specific energy injection rate */
+  double  AmpFactor;    /**< Amplitude correction (energy control) */
+  double  InjRate;      /**< Time-averaged measured injection rate */
+  double **Cs[3], **Sn[3]; /**< Per-axis tables: Cs[dir][n][i] = cos(k_n x_i) */
+  double ***Acc[3];     /**< Acceleration field (one array per direction) */
+} ForcedTurb;
+
+void ForcedTurb_Init (ForcedTurb *);
+void ForcedTurb_OUNoiseInit (double *, int, double);
+void ForcedTurb_OUNoiseUpdate (double *, int, double, double, double);
+void ForcedTurb_CalcPhases (ForcedTurb *);
+void ForcedTurb_ComputeAcceleration (ForcedTurb *, Grid *);
+void ForcedTurb_EnergyControl (ForcedTurb *, const Data *, double, Grid *);
+void ForcedTurb_CorrectRHS (const Data *, const Sweep *, int, int,
+                            double, Grid *);
+void ForcedTurb_StateDump (Runtime *, int);
+void ForcedTurb_StateRead (Runtime *, int, int);
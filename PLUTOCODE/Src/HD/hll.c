@@ -14,6 +14,12 @@
   Also during this step, compute maximum wave propagation speed (cmax)
   for  explicit time step computation.
 
+  With an energy equation, interfaces are processed in blocks of
+  ::HLL_BLOCK_SIZE, in the same way as HLLC_Solver(): states are
+  gathered into contiguous arrays, the Davis estimate and the HLL
+  flux are computed in a single vectorizable loop, and the result
+  is scattered back.
+
   \b Reference:
    - "Riemann Solver and Numerical Methods for Fluid Dynamics"
       by E.F. Toro (Chapter 10)
@@ -26,6 +32,11 @@
 /* ///////////////////////////////////////////////////////////////////// */
 #include"pluto.h"
 
+#ifndef HLL_BLOCK_SIZE
+  #define HLL_BLOCK_SIZE  64  /**< Number of interfaces processed
+                                   together by the vectorized loop. */
+#endif
+
 /* ********************************************************************* */
 void HLL_Solver (const Sweep *sweep, int beg, int end, 
                  double *cmax, Grid *grid)
@@ -41,15 +52,13 @@ void HLL_Solver (const Sweep *sweep, int beg, int end,
  *
  *********************************************************************** */
 {
-  int    nv, i;
+  int    i;
 
   const State   *stateL = &(sweep->stateL);
   const State   *stateR = &(sweep->stateR);
 
   double scrh;
-  double **fL = stateL->flux, **fR = stateR->flux;
-  double  *pL = stateL->prs,   *pR = stateR->prs;
-  double *uR, *uL, *SL, *SR;
+  double *SL, *SR;
 
 #if TIME_STEPPING == CHARACTERISTIC_TRACING
 {
@@ -62,6 +71,126 @@ void HLL_Solver (const Sweep *sweep, int beg, int end,
 }
 #endif
 
+  SL = sweep->SL; SR = sweep->SR;
+
+#if HAVE_ENERGY
+{
+  int    n, nb, ib;
+  double aL, aR, sl, sr, maxMach = g_maxMach;
+  double *vL, *vR;
+
+  double rhoL[HLL_BLOCK_SIZE], rhoR[HLL_BLOCK_SIZE];
+  double vnL[HLL_BLOCK_SIZE],  vnR[HLL_BLOCK_SIZE];
+  double vtL[HLL_BLOCK_SIZE],  vtR[HLL_BLOCK_SIZE];
+  double vbL[HLL_BLOCK_SIZE],  vbR[HLL_BLOCK_SIZE];
+  double prL[HLL_BLOCK_SIZE],  prR[HLL_BLOCK_SIZE];
+  double EL[HLL_BLOCK_SIZE],   ER[HLL_BLOCK_SIZE];
+  double cL[HLL_BLOCK_SIZE],   cR[HLL_BLOCK_SIZE];
+
+  double Frho[HLL_BLOCK_SIZE], Fmn[HLL_BLOCK_SIZE];
+  double Fmt[HLL_BLOCK_SIZE],  Fmb[HLL_BLOCK_SIZE];
+  double Feng[HLL_BLOCK_SIZE], Fprs[HLL_BLOCK_SIZE];
+  double Sl[HLL_BLOCK_SIZE],   Sr[HLL_BLOCK_SIZE];
+  double Cmax[HLL_BLOCK_SIZE], Mach[HLL_BLOCK_SIZE];
+
+  #if EOS != IDEAL
+  SoundSpeed2 (stateL, beg, end, FACE_CENTER, grid);
+  SoundSpeed2 (stateR, beg, end, FACE_CENTER, grid);
+  #endif
+
+  for (ib = beg; ib <= end; ib += HLL_BLOCK_SIZE){
+    nb = MIN(HLL_BLOCK_SIZE, end - ib + 1);
+
+  /* ---------------------------------------------------------
+     1. Gather interface states (see HLLC_Solver())
+     --------------------------------------------------------- */
+
+    for (n = 0; n < nb; n++){
+      vL = stateL->v[ib + n];
+      vR = stateR->v[ib + n];
+
+      rhoL[n] = vL[RHO]; vnL[n] = vL[VXn]; vtL[n] = vL[VXt];
+      vbL[n]  = vL[VXb]; prL[n] = vL[PRS]; EL[n]  = stateL->u[ib + n][ENG];
+
+      rhoR[n] = vR[RHO]; vnR[n] = vR[VXn]; vtR[n] = vR[VXt];
+      vbR[n]  = vR[VXb]; prR[n] = vR[PRS]; ER[n]  = stateR->u[ib + n][ENG];
+
+      #if EOS == IDEAL
+      cL[n] = sqrt(g_gamma*prL[n]/rhoL[n]);
+      cR[n] = sqrt(g_gamma*prR[n]/rhoR[n]);
+      #else
+      cL[n] = sqrt(stateL->a2[ib + n]);
+      cR[n] = sqrt(stateR->a2[ib + n]);
+      #endif
+    }
+
+  /* ---------------------------------------------------------
+     2. Davis estimate (see HLL_Speed()) and HLL flux.
+        Limiting the wave speeds to SL <= 0 <= SR turns
+        the HLL average into the upwind flux at supersonic
+        interfaces, so no branch is needed.
+     --------------------------------------------------------- */
+
+    for (n = 0; n < nb; n++){
+      aL = vnL[n] - cL[n];
+      aR = vnR[n] - cR[n];
+      sl = MIN(aL, aR);
+
+      aL = vnL[n] + cL[n];
+      aR = vnR[n] + cR[n];
+      sr = MAX(aL, aR);
+
+      Sl[n]   = sl;
+      Sr[n]   = sr;
+      Cmax[n] = MAX(fabs(sl), fabs(sr));
+      Mach[n] = (fabs(vnL[n]) + fabs(vnR[n]))/(cL[n] + cR[n]);
+
+      sl   = MIN(sl, 0.0);
+      sr   = MAX(sr, 0.0);
+      scrh = 1.0/(sr - sl);
+      aL   = rhoL[n]*vnL[n];   /* normal momenta */
+      aR   = rhoR[n]*vnR[n];
+
+      Frho[n] = (  sr*aL - sl*aR
+                 + sl*sr*(rhoR[n] - rhoL[n]))*scrh;
+      Fmn[n]  = (  sr*aL*vnL[n] - sl*aR*vnR[n]
+                 + sl*sr*(aR - aL))*scrh;
+      Fmt[n]  = (  sr*aL*vtL[n] - sl*aR*vtR[n]
+                 + sl*sr*(rhoR[n]*vtR[n] - rhoL[n]*vtL[n]))*scrh;
+      Fmb[n]  = (  sr*aL*vbL[n] - sl*aR*vbR[n]
+                 + sl*sr*(rhoR[n]*vbR[n] - rhoL[n]*vbL[n]))*scrh;
+      Feng[n] = (  sr*(EL[n] + prL[n])*vnL[n] - sl*(ER[n] + prR[n])*vnR[n]
+                 + sl*sr*(ER[n] - EL[n]))*scrh;
+      Fprs[n] = (sr*prL[n] - sl*prR[n])*scrh;
+    }
+
+  /* ---------------------------------------
+     3. Scatter fluxes
+     --------------------------------------- */
+
+    for (n = 0; n < nb; n++){
+      i = ib + n;
+      sweep->flux[i][RHO] = Frho[n];
+      sweep->flux[i][MXn] = Fmn[n];
+      sweep->flux[i][MXt] = Fmt[n];
+      sweep->flux[i][MXb] = Fmb[n];
+      sweep->flux[i][ENG] = Feng[n];
+      sweep->press[i] = Fprs[n];
+      SL[i]   = Sl[n];
+      SR[i]   = Sr[n];
+      cmax[i] = Cmax[n];
+      maxMach = MAX(Mach[n], maxMach);
+    }
+  }
+  g_maxMach = maxMach;
+}
+#else
+{
+  int    nv;
+  double **fL = stateL->flux, **fR = stateR->flux;
+  double  *pL = stateL->prs,   *pR = stateR->prs;
+  double *uR, *uL;
+
 /* ----------------------------------------------------
      compute sound speed & fluxes at zone interfaces
    ---------------------------------------------------- */
@@ -72,7 +201,6 @@ void HLL_Solver (const Sweep *sweep, int beg, int end,
   Flux (stateL, beg, end);
   Flux (stateR, beg, end);
 
-  SL = sweep->SL; SR = sweep->SR;
   HLL_Speed (stateL, stateR, SL, SR, beg, end);
   for (i = beg; i <= end; i++) {
 
@@ -105,3 +233,5 @@ void HLL_Solver (const Sweep *sweep, int beg, int end,
     }
   } /* end loops on points */
 }
+#endif
+}
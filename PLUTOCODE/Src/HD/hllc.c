@@ -13,6 +13,15 @@
   
   Also during this step, compute maximum wave propagation speed (cmax) 
   for  explicit time step computation.
+
+  When the energy equation is included, interfaces are processed in
+  blocks of ::HLLC_BLOCK_SIZE: the interface states are first gathered
+  into contiguous arrays, the Davis wave speed estimate, the left/right
+  fluxes and the HLLC flux are then evaluated in a single branch-free
+  loop that the compiler can vectorize and, finally, the result is
+  scattered back into \c sweep->flux.
+  Only the ::NFLX hydrodynamic components are computed here; passive
+  scalars are upwinded separately by AdvectFlux().
    
   \b Reference:
    -   "Riemann Solver and Numerical Methods for Fluid Dynamics"
@@ -24,6 +33,11 @@
 /* ///////////////////////////////////////////////////////////////////// */
 #include"pluto.h"
 
+#ifndef HLLC_BLOCK_SIZE
+  #define HLLC_BLOCK_SIZE  64  /**< Number of interfaces processed
+                                    together by the vectorized loop. */
+#endif
+
 /* ********************************************************************* */
 void HLLC_Solver (const Sweep *sweep, int beg, int end, 
                   double *cmax, Grid *grid)
@@ -38,33 +52,192 @@ void HLLC_Solver (const Sweep *sweep, int beg, int end,
  *
  *********************************************************************** */
 {
-  int    nv, i;
+  int    i;
 
   const State   *stateL = &(sweep->stateL);
   const State   *stateR = &(sweep->stateR);
 
-  double **fL = stateL->flux, **fR = stateR->flux;
-  double  *pL = stateL->prs,   *pR = stateR->prs;
+  double *vL, *vR, *SL, *SR;
 
-  double scrh, vxr, vxl;
-  double usL[NFLX], usR[NFLX], vs;
-  double qL, qR, wL, wR;
-  double *vL, *vR, *uL, *uR, *SL, *SR;
-  #if EOS == ISOTHERMAL
-   double rho, mx;
+  SL = sweep->SL; SR = sweep->SR;
+
+#if HAVE_ENERGY
+{
+  int    n, nb, ib, left;
+  double aL, aR, sl, sr, S, vs, inv, usr;
+  double qL, qR, wL, wR, maxMach = g_maxMach;
+  double rho, vn, vt, vb, p, E, mn, mt, mb;
+
+  double rhoL[HLLC_BLOCK_SIZE], rhoR[HLLC_BLOCK_SIZE];
+  double vnL[HLLC_BLOCK_SIZE],  vnR[HLLC_BLOCK_SIZE];
+  double vtL[HLLC_BLOCK_SIZE],  vtR[HLLC_BLOCK_SIZE];
+  double vbL[HLLC_BLOCK_SIZE],  vbR[HLLC_BLOCK_SIZE];
+  double prL[HLLC_BLOCK_SIZE],  prR[HLLC_BLOCK_SIZE];
+  double EL[HLLC_BLOCK_SIZE],   ER[HLLC_BLOCK_SIZE];
+  double cL[HLLC_BLOCK_SIZE],   cR[HLLC_BLOCK_SIZE];
+
+  double Frho[HLLC_BLOCK_SIZE], Fmn[HLLC_BLOCK_SIZE];
+  double Fmt[HLLC_BLOCK_SIZE],  Fmb[HLLC_BLOCK_SIZE];
+  double Feng[HLLC_BLOCK_SIZE], Fprs[HLLC_BLOCK_SIZE];
+  double Sl[HLLC_BLOCK_SIZE],   Sr[HLLC_BLOCK_SIZE];
+  double Cmax[HLLC_BLOCK_SIZE], Mach[HLLC_BLOCK_SIZE];
+
+  #if EOS != IDEAL
+  SoundSpeed2 (stateL, beg, end, FACE_CENTER, grid);
+  SoundSpeed2 (stateR, beg, end, FACE_CENTER, grid);
   #endif
 
+  for (ib = beg; ib <= end; ib += HLLC_BLOCK_SIZE){
+    nb = MIN(HLLC_BLOCK_SIZE, end - ib + 1);
+
+  /* ---------------------------------------------------------
+     1. Gather interface states into contiguous arrays.
+        The square root is taken here since, with errno
+        setting math, it would prevent vectorization of the
+        loop below.
+     --------------------------------------------------------- */
+
+    for (n = 0; n < nb; n++){
+      vL = stateL->v[ib + n];
+      vR = stateR->v[ib + n];
+
+      rhoL[n] = vL[RHO]; vnL[n] = vL[VXn]; vtL[n] = vL[VXt];
+      vbL[n]  = vL[VXb]; prL[n] = vL[PRS]; EL[n]  = stateL->u[ib + n][ENG];
+
+      rhoR[n] = vR[RHO]; vnR[n] = vR[VXn]; vtR[n] = vR[VXt];
+      vbR[n]  = vR[VXb]; prR[n] = vR[PRS]; ER[n]  = stateR->u[ib + n][ENG];
+
+      #if EOS == IDEAL
+      cL[n] = sqrt(g_gamma*prL[n]/rhoL[n]);
+      cR[n] = sqrt(g_gamma*prR[n]/rhoR[n]);
+      #else
+      cL[n] = sqrt(stateL->a2[ib + n]);
+      cR[n] = sqrt(stateR->a2[ib + n]);
+      #endif
+    }
+
+  /* ---------------------------------------------------------
+     2. Davis estimate (see HLL_Speed()) and HLLC flux.
+        Once the side of the contact wave has been chosen,
+        the flux is F = F(U) + S*(U* - U) where S is the
+        outer wave speed limited to SL <= 0 <= SR, so that
+        it reduces to the upwind flux at supersonic
+        interfaces. Every quantity is computed and stored
+        unconditionally, leaving no branch in the loop.
+     --------------------------------------------------------- */
+
+    for (n = 0; n < nb; n++){
+      aL = vnL[n] - cL[n];
+      aR = vnR[n] - cR[n];
+      sl = MIN(aL, aR);
+
+      aL = vnL[n] + cL[n];
+      aR = vnR[n] + cR[n];
+      sr = MAX(aL, aR);
+
+      Sl[n]   = sl;
+      Sr[n]   = sr;
+      Cmax[n] = MAX(fabs(sl), fabs(sr));
+      Mach[n] = (fabs(vnL[n]) + fabs(vnR[n]))/(cL[n] + cR[n]);
+
+      qL = prL[n] + rhoL[n]*vnL[n]*(vnL[n] - sl);
+      qR = prR[n] + rhoR[n]*vnR[n]*(vnR[n] - sr);
+      wL = rhoL[n]*(vnL[n] - sl);
+      wR = rhoR[n]*(vnR[n] - sr);
+      vs = (qR - qL)/(wR - wL);
+
+      left = (sl > 0.0) | ((sr >= 0.0) & (vs >= 0.0));
+
+      rho = left ? rhoL[n] : rhoR[n];
+      vn  = left ? vnL[n]  : vnR[n];
+      vt  = left ? vtL[n]  : vtR[n];
+      vb  = left ? vbL[n]  : vbR[n];
+      p   = left ? prL[n]  : prR[n];
+      E   = left ? EL[n]   : ER[n];
+      aL  = left ? sl : sr;
+      S   = left ? MIN(sl, 0.0) : MAX(sr, 0.0);
+
+      mn  = rho*vn;
+      mt  = rho*vt;
+      mb  = rho*vb;
+
+      inv = 1.0/(aL - vs);
+      usr = rho*(aL - vn)*inv;
+
+      Frho[n] = mn    + S*(usr - rho);
+      Fmn[n]  = mn*vn + S*(usr*vs - mn);
+      Fmt[n]  = mt*vn + S*(usr*vt - mt);
+      Fmb[n]  = mb*vn + S*(usr*vb - mb);
+      Feng[n] = (E + p)*vn
+                + S*(E*(aL - vn)*inv + (vs - vn)*(usr*vs + p*inv) - E);
+      Fprs[n] = p;
+    }
+
+  /* ---------------------------------------
+     3. Scatter fluxes
+     --------------------------------------- */
+
+    for (n = 0; n < nb; n++){
+      i = ib + n;
+      sweep->flux[i][RHO] = Frho[n];
+      sweep->flux[i][MXn] = Fmn[n];
+      sweep->flux[i][MXt] = Fmt[n];
+      sweep->flux[i][MXb] = Fmb[n];
+      sweep->flux[i][ENG] = Feng[n];
+      sweep->press[i] = Fprs[n];
+      SL[i]   = Sl[n];
+      SR[i]   = Sr[n];
+      cmax[i] = Cmax[n];
+      maxMach = MAX(Mach[n], maxMach);
+    }
+  }
+  g_maxMach = maxMach;
+}
+
+#if SHOCK_FLATTENING == MULTID
 /* ----------------------------------------------------
-    Compute sound speed & fluxes at zone interfaces
+    Revert to HLL in the (few) zones flagged as shocks
    ---------------------------------------------------- */
+{
+  int    nv;
+  double **fL = stateL->flux, **fR = stateR->flux;
+  double  *pL = stateL->prs,   *pR = stateR->prs;
+  double scrh, *uL, *uR;
+
+  for (i = beg; i <= end; i++) {
+    if (!((sweep->flag[i] & FLAG_HLL) || (sweep->flag[i+1] & FLAG_HLL))) continue;
+    if (SL[i] > 0.0 || SR[i] < 0.0) continue;
+
+    Flux (stateL, i, i);
+    Flux (stateR, i, i);
+    uR = stateR->u[i];
+    uL = stateL->u[i];
+
+    scrh  = 1.0/(SR[i] - SL[i]);
+    for (nv = NFLX; nv--; ){
+      sweep->flux[i][nv]  = SL[i]*SR[i]*(uR[nv] - uL[nv])
+                         +  SR[i]*fL[i][nv] - SL[i]*fR[i][nv];
+      sweep->flux[i][nv] *= scrh;
+    }
+    sweep->press[i] = (SR[i]*pL[i] - SL[i]*pR[i])*scrh;
+  }
+}
+#endif
+
+#elif EOS == ISOTHERMAL
+{
+  int    nv;
+  double **fL = stateL->flux, **fR = stateR->flux;
+  double  *pL = stateL->prs,   *pR = stateR->prs;
+  double scrh, *uL, *uR;
+  double usL[NFLX], usR[NFLX], vs;
+  double rho, mx;
 
   SoundSpeed2 (stateL, beg, end, FACE_CENTER, grid);
   SoundSpeed2 (stateR, beg, end, FACE_CENTER, grid);
 
   Flux (stateL, beg, end);
   Flux (stateR, beg, end);
-
-  SL = sweep->SL; SR = sweep->SR;
   HLL_Speed (stateL, stateR, SL, SR, beg, end);
 
   for (i = beg; i <= end; i++) {
@@ -87,9 +260,6 @@ void HLLC_Solver (const Sweep *sweep, int beg, int end,
       vR = stateR->v[i]; uR = stateR->u[i];
       vL = stateL->v[i]; uL = stateL->u[i];
 
-      vxr = vR[VXn];
-      vxl = vL[VXn];
- 
 #if SHOCK_FLATTENING == MULTID   
       if ((sweep->flag[i] & FLAG_HLL) || (sweep->flag[i+1] & FLAG_HLL)){        
          scrh  = 1.0/(SR[i] - SL[i]);
@@ -107,34 +277,6 @@ void HLLC_Solver (const Sweep *sweep, int beg, int end,
                    get u* 
      --------------------------------------- */    
 
-      #if HAVE_ENERGY
-      qL = vL[PRS] + uL[MXn]*(vL[VXn] - SL[i]);
-      qR = vR[PRS] + uR[MXn]*(vR[VXn] - SR[i]);
-
-      wL = vL[RHO]*(vL[VXn] - SL[i]);
-      wR = vR[RHO]*(vR[VXn] - SR[i]);
-
-      vs = (qR - qL)/(wR - wL); /* wR - wL > 0 since SL < 0, SR > 0 */
-/*
-      vs = vR[PRS] - vL[PRS] + uL[MXn]*(SL[i] - vxl) 
-                           - uR[MXn]*(SR[i] - vxr);
-      vs /= vL[RHO]*(SL[i] - vxl) - vR[RHO]*(SR[i] - vxr);
-*/
-
-      usL[RHO] = uL[RHO]*(SL[i] - vxl)/(SL[i] - vs);
-      usR[RHO] = uR[RHO]*(SR[i] - vxr)/(SR[i] - vs);
-      usL[MXn] = usL[RHO]*vs;     usR[MXn] = usR[RHO]*vs;
-      usL[MXt] = usL[RHO]*vL[VXt]; usR[MXt] = usR[RHO]*vR[VXt];
-      usL[MXb] = usL[RHO]*vL[VXb]; usR[MXb] = usR[RHO]*vR[VXb];
-           
-      usL[ENG] =   uL[ENG]/vL[RHO]  
-                 + (vs - vxl)*(vs + vL[PRS]/(vL[RHO]*(SL[i] - vxl)));
-      usR[ENG] =   uR[ENG]/vR[RHO] 
-                 + (vs - vxr)*(vs + vR[PRS]/(vR[RHO]*(SR[i] - vxr)));
-
-      usL[ENG] *= usL[RHO];
-      usR[ENG] *= usR[RHO];
-      #elif EOS == ISOTHERMAL
       scrh = 1.0/(SR[i] - SL[i]);
       rho  = (SR[i]*uR[RHO] - SL[i]*uL[RHO] - fR[i][RHO] + fL[i][RHO])*scrh;
       mx   = (SR[i]*uR[MXn] - SL[i]*uL[MXn] - fR[i][MXn] + fL[i][MXn])*scrh;
@@ -147,21 +289,7 @@ void HLLC_Solver (const Sweep *sweep, int beg, int end,
       vs /= rho;
       usL[MXt] = rho*vL[VXt]; usR[MXt] = rho*vR[VXt];
       usL[MXb] = rho*vL[VXb]; usR[MXb] = rho*vR[VXb];
-      #endif
 
-        
- /* ---- verify consistency condition ------ */
- /*
-      for (nv = 0; nv < NFLX; nv++) {
-        scrh  = (vs - SL[i])*usL[nv] + (SR[i] - vs)*usR[nv];
-        scrh -= SR[i]*uR[i][nv] - SL[i]*uL[i][nv] + 
-                fl[i][nv] - fr[i][nv];
-          if (fabs(scrh) > 1.e-9){
-          printf (" Consistency condition violated\n");
-          printf ("%d %d  %12.6e\n",i,nv, scrh);
-        }
-      }
- */          
 /*  ----  Compute HLLC flux  ----  */
 
       if (vs >= 0.0){
@@ -178,3 +306,5 @@ void HLLC_Solver (const Sweep *sweep, int beg, int end,
     }
   } /* end loops on points */
 }
+#endif
+}
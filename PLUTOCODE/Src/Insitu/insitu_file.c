@@ -0,0 +1,144 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief File-based in-situ plugin for testing the adaptor interface.
+
+  At each call, this plugin computes the minimum, maximum and zone
+  average of the selected fields over the interior zones and
+  processor 0 appends them, together with step and time, to a text
+  file.
+  It reads data only through the views provided by InsituData and can
+  be used as a template for actual adaptors.
+
+  Arguments (from the insitu line of pluto.ini):
+  \verbatim
+  insitu   0.01  -1   ./insitu_file.so   insitu.txt   rho  prs  Tgrac
+  \endverbatim
+  the name of the output file (default "insitu.txt") followed by the
+  names of the fields (default: all of them).
+
+  Compile with (add -DPARALLEL for parallel runs):
+  \verbatim
+  mpicc -shared -fPIC -DPARALLEL -I$(PLUTO_DIR)/Src insitu_file.c -o insitu_file.so
+  \endverbatim
+
+  \date   Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "insitu.h"
+#ifdef PARALLEL
+#include <mpi.h>
+#endif
+
+#define MAX_FIELDS  64
+
+static char  s_fname[256] = "insitu.txt";
+static int   s_nsel;
+static int   s_sel[MAX_FIELDS];
+
+/* ********************************************************************* */
+int InsituPluginInit (const InsituData *data, const char *args)
+/*!
+ * Parse arguments and write the file header.
+ *********************************************************************** */
+{
+  int  n;
+  char buf[1024], *word;
+  FILE *fp;
+
+  if (data->version != INSITU_VERSION) return 1;
+
+  s_nsel = 0;
+  strncpy (buf, args, sizeof(buf) - 1);
+  buf[sizeof(buf) - 1] = '\0';
+  word = strtok (buf, " \t");
+  if (word != NULL){
+    strncpy (s_fname, word, sizeof(s_fname) - 1);
+    word = strtok (NULL, " \t");
+  }
+  for (; word != NULL; word = strtok (NULL, " \t")){
+    for (n = 0; n < data->nfields; n++){
+      if (strcmp(word, data->fields[n].name) == 0) break;
+    }
+    if (n == data->nfields || s_nsel == MAX_FIELDS) return 2;
+    s_sel[s_nsel++] = n;
+  }
+  if (s_nsel == 0){
+    for (n = 0; n < data->nfields && n < MAX_FIELDS; n++) s_sel[s_nsel++] = n;
+  }
+
+  if (data->rank != 0) return 0;
+  fp = fopen (s_fname, "w");
+  if (fp == NULL) return 3;
+  fprintf (fp, "# step  time");
+  for (n = 0; n < s_nsel; n++){
+    const char *name = data->fields[s_sel[n]].name;
+    fprintf (fp, "  %s_min  %s_max  %s_avg", name, name, name);
+  }
+  fprintf (fp, "\n");
+  fclose (fp);
+  return 0;
+}
+
+/* ********************************************************************* */
+int InsituPluginExecute (const InsituData *data)
+/*!
+ * Reduce the selected fields and append one line to the file.
+ *********************************************************************** */
+{
+  int    i, j, k, n;
+  long   nzones = 1;
+  double q, qmin[MAX_FIELDS], qmax[MAX_FIELDS], qsum[MAX_FIELDS];
+  const int *nt = data->ntot;
+  FILE  *fp;
+
+  for (n = 0; n < 3; n++) nzones *= data->np_glob[n];
+
+  for (n = 0; n < s_nsel; n++){
+    const double *f = data->fields[s_sel[n]].data;
+
+    qmin[n] =  1.e300;
+    qmax[n] = -1.e300;
+    qsum[n] =  0.0;
+    for (k = data->beg[2]; k <= data->end[2]; k++){
+    for (j = data->beg[1]; j <= data->end[1]; j++){
+    for (i = data->beg[0]; i <= data->end[0]; i++){
+      q = f[((long)k*nt[1] + j)*nt[0] + i];
+      qmin[n]  = q < qmin[n] ? q:qmin[n];
+      qmax[n]  = q > qmax[n] ? q:qmax[n];
+      qsum[n] += q;
+    }}}
+  }
+
+#ifdef PARALLEL
+  {
+    MPI_Comm comm = MPI_Comm_f2c (data->comm);
+
+    MPI_Allreduce (MPI_IN_PLACE, qmin, s_nsel, MPI_DOUBLE, MPI_MIN, comm);
+    MPI_Allreduce (MPI_IN_PLACE, qmax, s_nsel, MPI_DOUBLE, MPI_MAX, comm);
+    MPI_Allreduce (MPI_IN_PLACE, qsum, s_nsel, MPI_DOUBLE, MPI_SUM, comm);
+  }
+#endif
+
+  if (data->rank != 0) return 0;
+  fp = fopen (s_fname, "a");
+  if (fp == NULL) return 3;
+  fprintf (fp, "%ld  %14.7e", data->step, data->time);
+  for (n = 0; n < s_nsel; n++){
+    fprintf (fp, "  %14.7e  %14.7e  %14.7e", qmin[n], qmax[n], qsum[n]/nzones);
+  }
+  fprintf (fp, "\n");
+  fclose (fp);
+  return 0;
+}
+
+/* ********************************************************************* */
+void InsituPluginFinalize (void)
+/*!
+ * Nothing to release.
+ *********************************************************************** */
+{
+}
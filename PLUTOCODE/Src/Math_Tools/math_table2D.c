@@ -10,6 +10,9 @@
 #include "pluto.h"
 
 void PlotCubic(double a, double b, double c, double d);
+static void Table2DSetAxes (Table2D *, double, double, double, double);
+
+#define TABLE2D_CACHE_MAGIC  "PLUTOT2D"
 
 /* ********************************************************************* */
 void InitializeTable2D (Table2D *tab, double xmin, double xmax, int nx,
@@ -58,9 +61,67 @@ void InitializeTable2D (Table2D *tab, double xmin, double xmax, int nx,
   tab->c  = ARRAY_2D(tab->ny, tab->nx, double);
   tab->d  = ARRAY_2D(tab->ny, tab->nx, double);
 
-  tab->defined = ARRAY_2D(tab->ny, tab->nx, char);
+  tab->dfx  = ARRAY_2D(tab->ny, tab->nx, double);
+  tab->dfy  = ARRAY_2D(tab->ny, tab->nx, double);
+
   for (i = 0; i < tab->nx; i++){
     for (j = 0; j < tab->ny; j++) tab->f[j][i] = 0.0;
+  }
+
+  Table2DSetAxes (tab, xmin, xmax, ymin, ymax);
+}
+
+/* ********************************************************************* */
+int InitializeSharedTable2D (Table2D *tab, double xmin, double xmax, int nx,
+                                           double ymin, double ymax, int ny)
+/*!
+ * Same as InitializeTable2D() but the 2D arrays (\c f, spline
+ * coefficients and forward differences) are allocated only once per
+ * node in shared memory (see shared_table.c).
+ * Collective on MPI_COMM_WORLD.
+ * Only the processor for which the function returns 1 (the builder)
+ * may fill the table and call FinalizeTable2D(); it must be followed
+ * by a call to SharedTableSync() on all processors before the table
+ * is used.
+ *
+ * \return 1 if the calling processor must build the table, 0 otherwise.
+ *********************************************************************** */
+{
+  int  j, n, builder;
+  long int nxy = (long int)nx*ny;
+  double *buf, ***arr[7];
+
+  tab->nx = nx;
+  tab->ny = ny;
+
+  builder = SharedTableBuilder();
+  buf     = SharedTableAlloc (7*nxy, NULL);
+
+  arr[0] = &tab->f; arr[1] = &tab->a; arr[2] = &tab->b; arr[3] = &tab->c;
+  arr[4] = &tab->d; arr[5] = &tab->dfx; arr[6] = &tab->dfy;
+  for (n = 0; n < 7; n++){
+    *arr[n] = ARRAY_1D(ny, double *);
+    for (j = 0; j < ny; j++) (*arr[n])[j] = buf + n*nxy + (long int)j*nx;
+  }
+  if (builder) for (j = 0; j < 7*nxy; j++) buf[j] = 0.0;
+
+  Table2DSetAxes (tab, xmin, xmax, ymin, ymax);
+  return builder;
+}
+
+/* ********************************************************************* */
+void Table2DSetAxes (Table2D *tab, double xmin, double xmax,
+                                   double ymin, double ymax)
+/*!
+ * Allocate and compute the (processor-local) table axes, see
+ * InitializeTable2D().
+ *
+ *********************************************************************** */
+{
+  int i, j;
+
+  tab->defined = ARRAY_2D(tab->ny, tab->nx, char);
+  for (i = 0; i < tab->nx; i++){
     for (j = 0; j < tab->ny; j++) tab->defined[j][i] = 1;
   }
 
@@ -74,9 +135,6 @@ void InitializeTable2D (Table2D *tab, double xmin, double xmax, int nx,
 
   tab->dx   = ARRAY_1D(tab->nx, double);
   tab->dy   = ARRAY_1D(tab->ny, double);
-
-  tab->dfx  = ARRAY_2D(tab->ny, tab->nx, double);
-  tab->dfy  = ARRAY_2D(tab->ny, tab->nx, double);
 /*
    -- (beta) function index bookeeping --
     tab->fmin = ARRAY_1D(tab->ny, double);
@@ -568,6 +626,130 @@ void WriteBinaryTable2D (char *fname, Table2D *tab)
   fclose(fp);
 }
 
+/* ********************************************************************* */
+unsigned long long Table2DHash (unsigned long long h, const void *buf,
+                                size_t nbytes)
+/*!
+ * Update the 64-bit FNV-1a hash \c h with \c nbytes bytes from
+ * \c buf.
+ * Start from ::TABLE2D_HASH_INIT.
+ *
+ *********************************************************************** */
+{
+  size_t n;
+  const unsigned char *b = (const unsigned char *)buf;
+
+  for (n = 0; n < nbytes; n++){
+    h ^= (unsigned long long)b[n];
+    h *= 1099511628211ULL;  /* FNV prime */
+  }
+  return h;
+}
+
+/* ********************************************************************* */
+unsigned long long Table2DKey (Table2D *tab, unsigned long long h)
+/*!
+ * Add the table layout (size, bounds and interpolation type) to the
+ * hash \c h.
+ * 
+ *********************************************************************** */
+{
+  int    n[3] = {tab->nx, tab->ny, tab->interpolation};
+  double q[4] = {tab->lnxmin, tab->lnxmax, tab->lnymin, tab->lnymax};
+
+  h = Table2DHash(h, n, sizeof(n));
+  h = Table2DHash(h, q, sizeof(q));
+  return h;
+}
+
+/* ********************************************************************* */
+int ReadTable2DCache (char *fname, Table2D *tab, unsigned long long key)
+/*!
+ * Read the table values (\c f, spline coefficients and forward
+ * differences) from the binary cache file \c fname written by
+ * WriteTable2DCache().
+ * The table must have been initialized with InitializeTable2D() or
+ * InitializeSharedTable2D() using the same size and bounds.
+ *
+ * \param [in]     fname  the name of the cache file
+ * \param [in,out] tab    pointer to an initialized Table2D structure
+ * \param [in]     key    the expected key (see Table2DKey())
+ *
+ * \return 0 on success, 1 if the file does not exist or does not match
+ *         \c key (in which case the table must be rebuilt).
+ *********************************************************************** */
+{
+  int    n, hdr[2];
+  long int nxy = (long int)tab->nx*tab->ny;
+  char   magic[8];
+  unsigned long long fkey;
+  double **arr[7] = {tab->f, tab->a, tab->b, tab->c, tab->d,
+                     tab->dfx, tab->dfy};
+  FILE *fp;
+
+  fp = fopen(fname, "rb");
+  if (fp == NULL) return 1;
+
+  if (   fread(magic, 1, 8, fp) != 8 
+      || memcmp(magic, TABLE2D_CACHE_MAGIC, 8)
+      || fread(&fkey, sizeof(fkey), 1, fp) != 1 || fkey != key
+      || fread(hdr, sizeof(int), 2, fp) != 2
+      || hdr[0] != tab->nx || hdr[1] != tab->ny){
+    fclose(fp);
+    return 1;
+  }
+
+/* -- 2D arrays are contiguous in memory -- */
+
+  for (n = 0; n < 7; n++){
+    if (fread(arr[n][0], sizeof(double), nxy, fp) != nxy){
+      printLog ("! ReadTable2DCache(): %s is truncated\n", fname);
+      fclose(fp);
+      return 1;
+    }
+  }
+  fclose(fp);
+  return 0;
+}
+
+/* ********************************************************************* */
+void WriteTable2DCache (char *fname, Table2D *tab, unsigned long long key)
+/*!
+ * Write the table values to the binary cache file \c fname:
+ * \verbatim
+     "PLUTOT2D"     (8 bytes)
+     key            (unsigned long long)
+     nx ny          (int)
+     f, a, b, c, d, dfx, dfy   (nx*ny doubles each, row by row)
+   \endverbatim
+ * The file is first written with a temporary name and then renamed
+ * so that other processes never see a partially written cache.
+ *
+ *********************************************************************** */
+{
+  int    n, hdr[2] = {tab->nx, tab->ny};
+  long int nxy = (long int)tab->nx*tab->ny;
+  char   tmp_name[512];
+  double **arr[7] = {tab->f, tab->a, tab->b, tab->c, tab->d,
+                     tab->dfx, tab->dfy};
+  FILE *fp;
+
+  sprintf (tmp_name, "%s.tmp%d", fname, prank);
+  fp = fopen(tmp_name, "wb");
+  if (fp == NULL){
+    printLog ("! WriteTable2DCache(): cannot open %s\n", tmp_name);
+    return;
+  }
+  fwrite (TABLE2D_CACHE_MAGIC, 1, 8, fp);
+  fwrite (&key, sizeof(key), 1, fp);
+  fwrite (hdr, sizeof(int), 2, fp);
+  for (n = 0; n < 7; n++) fwrite (arr[n][0], sizeof(double), nxy, fp);
+  if (fclose(fp) != 0 || rename(tmp_name, fname) != 0){
+    printLog ("! WriteTable2DCache(): cannot write %s\n", fname);
+    remove (tmp_name);
+  }
+}
+
 void PlotCubic(double a, double b, double c, double d)
 {
   double t, f, dt = 1.e-1;
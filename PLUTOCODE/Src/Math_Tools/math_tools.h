@@ -36,6 +36,8 @@
 #define ALF            1.0e-4
 #define MAX_ROOT_EQNS  8
 
+#define TABLE2D_HASH_INIT  14695981039346656037ULL  /**< FNV-1a offset basis */
+
 /* ***********************************************************
     \cond REPEAT_FUNCTION_DOCUMENTATION_IN_HEADER_FILES 
     Function prototyping
@@ -138,10 +140,16 @@ int   Ridder(double (*func)(double, void *), void *,
    --------------------------------------------------- */
 
 void InitializeTable2D (Table2D *, double, double, int, double, double, int);
+int  InitializeSharedTable2D (Table2D *, double, double, int,
+                                         double, double, int);
 void FinalizeTable2D   (Table2D *);
 int  Table2DInterpolate   (Table2D *, double, double, double *);
 int  InverseLookupTable2D (Table2D *, double, double, double *);
 void WriteBinaryTable2D (char *, Table2D *);
+unsigned long long Table2DHash (unsigned long long, const void *, size_t);
+unsigned long long Table2DKey  (Table2D *, unsigned long long);
+int  ReadTable2DCache  (char *, Table2D *, unsigned long long);
+void WriteTable2DCache (char *, Table2D *, unsigned long long);
 
 /* -----------------------------------------------------------
     Functions contained in math_interp.c
@@ -336,6 +336,17 @@ typedef struct particleNode_{
   #define PARTICLES_USE_ARRAY   NO
 #endif
 
+/*! Number of list nodes allocated at once by the particle node pool. */
+#ifndef PARTICLES_POOL_CHUNK
+  #define PARTICLES_POOL_CHUNK  4096
+#endif
+
+/*! Sort particles by cell index every PARTICLES_SORT_FREQ calls to 
+    Particles_BoundaryExchangeEnd() (0 disables sorting). */
+#ifndef PARTICLES_SORT_FREQ
+  #define PARTICLES_SORT_FREQ   10
+#endif
+
 /* Useful macro to loop over particles (ATTENTION: do *NOT* use this
   macro inside loops involving creation / destruction of particles) */
 #define PARTICLES_LOOP(a,b)   for (a = b; a != NULL; a = a->next)
@@ -346,6 +357,8 @@ typedef struct particleNode_{
 
 void    Particles_Boundary(Data *, Grid *);
 void    Particles_BoundaryExchange(Data *, Grid *);
+void    Particles_BoundaryExchangeBegin(Data *, Grid *);
+void    Particles_BoundaryExchangeEnd(Data *, Grid *);
 int     Particles_BoundaryCheck(Particle *p, Grid *grid);
 long    Particles_CheckAll   (particleNode *, int, Grid *);
 int     Particles_CheckSingle(Particle *, int, Grid *);
@@ -362,6 +375,7 @@ void    Particles_CR_StatesSource(const Sweep *, double, int, int, Grid *);
 void    Particles_CR_Update(Data *, timeStep *, double, Grid *);
 #endif
 
+void    Particles_CellWeights (Particle *, int *, double ***, Grid *);
 void    Particles_Density(Particle *, double *);
 void    Particles_Deposit(particleNode *, void (*Func)(Particle *, double *),
                           Data_Arr, int, Grid *);
@@ -438,9 +452,12 @@ void    Particles_SetID(particleNode *);
 void    Particles_SetOutput (Data *, Runtime *);
 
 void    Particles_ShowList(particleNode *, int);
+void    Particles_Sort(Data *, Grid *);
 void    Particles_UserDefBoundary(Data *d, int, Grid *);
 
+void    Particles_PackFields (particleNode *, Output *, void *, size_t);
 void    Particles_WriteBinary(particleNode *, double, Output *, char *);
+void    Particles_WriteHDF5  (particleNode *, double, Output *, char *);
 void    Particles_WriteData(Data *d, Output *, Grid *);
 void    Particles_WriteTab   (particleNode*, char filename[]);
 void    Particles_WriteTrajectory (Particle *, char);
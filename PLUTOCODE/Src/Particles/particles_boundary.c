@@ -8,7 +8,12 @@
  
   The function Particles_Boundary() sets boundary conditions at
   physical boundaries only. The function Particles_BoundaryExchange()
-  exchanges particles between adjacent processors.
+  exchanges particles between adjacent processors (including edge and
+  corner neighbours) in a single round of nonblocking neighbourhood
+  collectives.
+  The exchange can be split into Particles_BoundaryExchangeBegin() and
+  Particles_BoundaryExchangeEnd() to overlap communication with other
+  work.
  
   \authors   A. Mignone (mignone@to.infn.it)\n
              B. Vaidya (bvaidya@unito.it)\n
@@ -205,205 +210,303 @@ if (d_condition)print("Particles_Check = %d, %d, %d; p_nparticles = %d\n",
   DEBUG_FUNC_END ("Particles_Boundary");
 }
 
+static int pex_pending = 0;  /* 1 if an exchange is in progress */
+
+#ifdef PARALLEL
+static MPI_Comm     pex_comm;         /* Graph communicator of neighbours   */
+static MPI_Datatype pex_type;         /* Datatype for a single particle     */
+static MPI_Request  pex_req;          /* Pending payload exchange           */
+static int          pex_nout, pex_nin;
+static int          pex_slot[27];     /* Offset index --> send slot (or -1) */
+static double       pex_shift[26][3]; /* Periodic shift for each send slot  */
+static int          *pex_scount, *pex_sdispl, *pex_rcount, *pex_rdispl;
+static int          *pex_key;
+static long int     pex_nsend_max = 0, pex_nrecv_max = 0, pex_nrecv;
+static Particle     *pex_send_buf, *pex_recv_buf;
+
+/* ********************************************************************* */
+static void Particles_ExchangeSetup(Grid *grid)
+/*!
+ * Build a distributed graph communicator connecting each processor
+ * to its (up to 26) face, edge and corner neighbours.
+ * A neighbour exists across a given side only if the side is not a
+ * physical boundary or when periodic or shearing boundary conditions
+ * are imposed there.
+ * For each send slot, also compute the shift to be applied to particle
+ * coordinates when crossing a periodic boundary.
+ *
+ * \param [in]  grid  pointer to the PLUTO grid structure.
+ *********************************************************************** */
+{
+  int n, dir, side, open, rnk, offs[3], coords[3];
+  int sources[26], destinations[26];
+  int nbound[3][2];
+  MPI_Comm cartcomm;
+
+  AL_Get_cart_comm(SZ, &cartcomm);
+
+  for (dir = 0; dir < 3; dir++){
+    nbound[dir][0] = grid->lbound[dir];
+    nbound[dir][1] = grid->rbound[dir];
+  }
+
+  pex_nout = pex_nin = 0;
+  for (offs[KDIR] = -INCLUDE_KDIR; offs[KDIR] <= INCLUDE_KDIR; offs[KDIR]++){
+  for (offs[JDIR] = -INCLUDE_JDIR; offs[JDIR] <= INCLUDE_JDIR; offs[JDIR]++){
+  for (offs[IDIR] = -INCLUDE_IDIR; offs[IDIR] <= INCLUDE_IDIR; offs[IDIR]++){
+    n = (offs[KDIR] + 1)*9 + (offs[JDIR] + 1)*3 + (offs[IDIR] + 1);
+    pex_slot[n] = -1;
+    if (n == 13) continue;   /* Skip the local processor */
+
+  /* -- Destination: processor at rank_coord + offs -- */
+
+    open = 1;
+    for (dir = 0; dir < 3; dir++){
+      coords[dir] = grid->rank_coord[dir] + offs[dir];
+      if (offs[dir] == 0) continue;
+      side = (offs[dir] > 0);
+      if (!(nbound[dir][side] == 0        ||
+            nbound[dir][side] == PERIODIC ||
+            nbound[dir][side] == SHEARING)) open = 0;
+    }
+    if (open){
+      MPI_Cart_rank(cartcomm, coords, &rnk);
+      for (dir = 0; dir < 3; dir++){
+        pex_shift[pex_nout][dir] = 0.0;
+        if (coords[dir] < 0 || coords[dir] >= grid->nproc[dir]){
+          pex_shift[pex_nout][dir] = -offs[dir]*(g_domEnd[dir] - g_domBeg[dir]);
+        }
+      }
+      pex_slot[n] = pex_nout;
+      destinations[pex_nout++] = rnk;
+    }
+
+  /* -- Source: processor at rank_coord - offs -- */
+
+    open = 1;
+    for (dir = 0; dir < 3; dir++){
+      coords[dir] = grid->rank_coord[dir] - offs[dir];
+      if (offs[dir] == 0) continue;
+      side = (offs[dir] < 0);
+      if (!(nbound[dir][side] == 0        ||
+            nbound[dir][side] == PERIODIC ||
+            nbound[dir][side] == SHEARING)) open = 0;
+    }
+    if (open){
+      MPI_Cart_rank(cartcomm, coords, &rnk);
+      sources[pex_nin++] = rnk;
+    }
+  }}}
+
+/* -----------------------------------------------------------
+   Sources and destinations are listed in the same offset
+   order on every processor, so that repeated neighbours
+   (e.g. with only 1 or 2 processors along a periodic
+   direction) are matched consistently.
+   ----------------------------------------------------------- */
+
+  MPI_Dist_graph_create_adjacent(cartcomm, pex_nin, sources, MPI_UNWEIGHTED,
+                                 pex_nout, destinations, MPI_UNWEIGHTED,
+                                 MPI_INFO_NULL, 0, &pex_comm);
+
+#if PARTICLES_USE_MPI_DATATYPE == YES
+  pex_type = MPI_PARTICLE;
+#else
+  MPI_Type_contiguous(sizeof(Particle), MPI_BYTE, &pex_type);
+  MPI_Type_commit(&pex_type);
+#endif
+
+  pex_scount = ARRAY_1D(26, int);
+  pex_sdispl = ARRAY_1D(26, int);
+  pex_rcount = ARRAY_1D(26, int);
+  pex_rdispl = ARRAY_1D(26, int);
+}
+#endif /* PARALLEL */
+
 /* ********************************************************************* */
 void Particles_BoundaryExchange(Data *d, Grid *grid)
 /*!
- * In parallel mode, exchange/duplicate particles between neighbour
- * processor.
- * The function is done direction-wise: if a particle escapes from the
- * left (right) boundary it is sent to the left (right) processor.
- * The exchange is repeated direction by direction.
+ * In parallel mode, exchange particles between neighbour processors.
+ * Equivalent to Particles_BoundaryExchangeBegin() immediately followed
+ * by Particles_BoundaryExchangeEnd().
  *
  * \param [in]   d        Pointer to PLUTO data structure.
  * \param [in]   grid     Pointer to the PLUTO grid structure.
  *********************************************************************** */
 {
-#ifdef PARALLEL
-  int dir, i, beg, end;
-  int nsendL, nsendR;
-  int nrecvL, nrecvR;
-  int procL, procR;     /* Rank of left and right neighbour processors */
-  int success;
-  static int first_call = 1, **neigh;
-
-  double xbeg, xend;
+  Particles_BoundaryExchangeBegin(d, grid);
+  Particles_BoundaryExchangeEnd(d, grid);
+}
 
+/* ********************************************************************* */
+void Particles_BoundaryExchangeBegin(Data *d, Grid *grid)
+/*!
+ * Start the exchange of particles between neighbour processors.
+ * Each particle leaving the local domain is assigned to one of the
+ * (up to 26) neighbours sharing a face, an edge or a corner, so that
+ * particles crossing a corner are sent directly to their destination.
+ * Particle counts are exchanged with a single neighbourhood collective,
+ * after which the payload exchange is started and left pending.
+ * Departed particles are removed from the local list.
+ * Particles_BoundaryExchangeEnd() must be called before the particle
+ * list is used again; in the meantime, other work (e.g. filling fluid
+ * ghost zones) can proceed.
+ *
+ * \param [in]   d        Pointer to PLUTO data structure.
+ * \param [in]   grid     Pointer to the PLUTO grid structure.
+ *********************************************************************** */
+{
+#ifdef PARALLEL
+  int dir, n, s, offs[3];
+  long int i, nsend;
+  static int first_call = 1;
+  double xbeg[3], xend[3];
   particleNode *curr, *next;
-  Particle *p;         /* Just a shortcut */
-  Particle *recv_bufL, *recv_bufR;  /* Array of received particles (runtime) */
-  Particle *send_bufL, *send_bufR;  /* Array collecting particles to be sent (runtime) */ 
-  particleNode **pstackL, **pstackR; /* Array collecting particle pointers to
-                                        be trasnferred (runtime) */
-  MPI_Status status;
+  Particle *p;
+  MPI_Request req;
 
-  DEBUG_FUNC_BEG("Particles_BoundaryExchange");
+  DEBUG_FUNC_BEG("Particles_BoundaryExchangeBegin");
 
 /* --------------------------------------------------------------
-   1. On first call, finds processor's neighbour ranks from
-      Cartesian topology and the corresponding domain coordinates
-      for each direction.
-   -------------------------------------------------------------- */       
+   0. On first call, build the neighbour communicator.
+      Complete any exchange still in progress.
+   -------------------------------------------------------------- */
 
   if (first_call){
-    neigh = ARRAY_2D(3, 2, int);    
-    GetNeighbourRanks (grid, neigh);
-    first_call = 0;       
-  } 
-  MPI_Barrier (MPI_COMM_WORLD);
-
-/* -------------------------------------------------------------
-   2. Loop on directions and set boundary conditions
-      direction-wise.      
-   ------------------------------------------------------------- */
-        
-  DIM_LOOP(dir){
-
-  /* ------------------------------------------
-     2a. Allocate stack buffer
-         Note: p_nparticles may change from
-               one direction to the next.
-     ------------------------------------------ */
+    Particles_ExchangeSetup(grid);
+    first_call = 0;
+  }
+  if (pex_pending) Particles_BoundaryExchangeEnd(d, grid);
 
-    pstackL = ARRAY_1D(p_nparticles, particleNode *);
-    pstackR = ARRAY_1D(p_nparticles, particleNode *);
-    
-    procR = neigh[dir][1]; /* Rank of processor to the right */
-    procL = neigh[dir][0]; /* Rank of processor to the left */
+  for (dir = 0; dir < 3; dir++){
+    xbeg[dir] = grid->xl[dir][grid->lbeg[dir]];
+    xend[dir] = grid->xr[dir][grid->lend[dir]];
+  }
 
-    nsendL = nsendR = 0;
+/* --------------------------------------------------------------
+   1. Assign each departing particle to a send slot.
+   -------------------------------------------------------------- */
+
+  if (p_nparticles > pex_nsend_max){
+    if (pex_key      != NULL) FreeArray1D(pex_key);
+    if (pex_send_buf != NULL) FreeArray1D(pex_send_buf);
+    pex_nsend_max = 2*p_nparticles;
+    pex_key      = ARRAY_1D(pex_nsend_max, int);
+    pex_send_buf = ARRAY_1D(pex_nsend_max, Particle);
+  }
 
-  /* -------------------------------
-     2b. Set boundary region
-     ------------------------------- */
+  for (s = 0; s < pex_nout; s++) pex_scount[s] = 0;
 
-    beg  = grid->lbeg[dir];
-    end  = grid->lend[dir];
+  nsend = 0;
+  curr  = d->PHead;
+  while (curr != NULL){   /* Loop on particles */
+    next = curr->next;
+    p    = &(curr->p);
 
-    xbeg = grid->xl[dir][beg]; 
-    xend = grid->xr[dir][end];
-    
-  /* -------------------------------------------------------------
-     2c. Count how many particles are leaving the local processor
-         domain from either the left or right side and stack
-         pointers into the arrays pstackL[] and pstackR[].
-     ------------------------------------------------------------- */
-
-    curr = d->PHead;
-    while (curr != NULL){   /* Loop on particles */
-       
-      next = curr->next;
-      p    = &(curr->p);
-
-      if      (p->coord[dir] <  xbeg) pstackL[nsendL++] = curr;
-      else if (p->coord[dir] >= xend) pstackR[nsendR++] = curr;
-
-      curr = next;
-    }  /* End loop on particles */
-
-  /* -------------------------------------------------------------
-     2d. Allocate memory for send buffers and copy particles
-         from stacks 
-     ------------------------------------------------------------- */
-
-    send_bufL = ARRAY_1D(nsendL, Particle);
-    send_bufR = ARRAY_1D(nsendR, Particle);
-
-    for (i = 0; i < nsendL; i++) send_bufL[i] = pstackL[i]->p; 
-    for (i = 0; i < nsendR; i++) send_bufR[i] = pstackR[i]->p; 
-
-  /* ---------------------------------------------------------------
-     2e. Exchange particles between neighbouring processors. 
-         Data is transferred only between neighbours and only if 
-         one or more particles are to be sent/received.
-         No communication should be done if a processor touches
-         a non-periodic physical boundary.
-     --------------------------------------------------------------- */
-     
-    nrecvL = 0;
-    nrecvR = 0;
-    if (procR < 0) {
-      if (nsendR != 0){
-        printLog ("! Particles_BoundaryExchange(): nsendR != 0\n");
-        QUIT_PLUTO(1);
-      }
-      nsendR = 0;
-      procR  = MPI_PROC_NULL;
+    offs[IDIR] = offs[JDIR] = offs[KDIR] = 0;
+    DIM_LOOP(dir){
+      if      (p->coord[dir] <  xbeg[dir]) offs[dir] = -1;
+      else if (p->coord[dir] >= xend[dir]) offs[dir] =  1;
     }
-    if (procL < 0) {
-      if (nsendL != 0){
-        printLog ("! Particles_BoundaryExchange(): nsendL != 0\n");
+    n = (offs[KDIR] + 1)*9 + (offs[JDIR] + 1)*3 + (offs[IDIR] + 1);
+    if (n != 13){
+      s = pex_slot[n];
+      if (s < 0){
+        printLog ("! Particles_BoundaryExchangeBegin(): no neighbour processor");
+        printLog (" at offset (%d, %d, %d)\n", offs[IDIR], offs[JDIR], offs[KDIR]);
         QUIT_PLUTO(1);
       }
-      nsendL = 0;
-      procL  = MPI_PROC_NULL;
+      pex_key[nsend]        = s;
+      pex_send_buf[nsend++] = *p;   /* Temporary copy, sorted below */
+      pex_scount[s]++;
+      Particles_Destroy (curr, d);
     }
+    curr = next;
+  }
 
-    MPI_Sendrecv(&nsendR, 1, MPI_INT, procR, 1, 
-                 &nrecvL, 1, MPI_INT, procL, 1, MPI_COMM_WORLD, &status);
+/* --------------------------------------------------------------
+   2. Exchange counts, while ordering the send buffer by slot
+      and applying periodic shifts.
+   -------------------------------------------------------------- */
 
-    MPI_Sendrecv(&nsendL, 1, MPI_INT, procL, 5, 
-                 &nrecvR, 1, MPI_INT, procR, 5, MPI_COMM_WORLD, &status);
+  MPI_Ineighbor_alltoall(pex_scount, 1, MPI_INT, pex_rcount, 1, MPI_INT,
+                         pex_comm, &req);
 
-    recv_bufL = ARRAY_1D(nrecvL, Particle);
-    recv_bufR = ARRAY_1D(nrecvR, Particle);
-   
-#if PARTICLES_USE_MPI_DATATYPE == YES   
-    MPI_Sendrecv(send_bufR, nsendR, MPI_PARTICLE, procR, 7, 
-                 recv_bufL, nrecvL, MPI_PARTICLE, procL, 7, MPI_COMM_WORLD, &status);
-#else
-    MPI_Sendrecv(send_bufR, sizeof(Particle)*nsendR, MPI_BYTE, procR, 7, 
-                 recv_bufL, sizeof(Particle)*nrecvL, MPI_BYTE, procL, 7, MPI_COMM_WORLD, &status);
-#endif
+  if (nsend > 0){
+    static long int nsort_max = 0;
+    static Particle *sort_buf;
 
-    for(i = 0; i < nrecvL; i++){
-      p = recv_bufL + i;
-      if (grid->lbound[dir] == PERIODIC || grid->lbound[dir] == SHEARING){
-        p->coord[dir] -= g_domEnd[dir] - g_domBeg[dir]; /* Apply Periodicity. */
-      }
-      success = Particles_Insert(p, d, PARTICLES_TRANSFER, grid);
+    if (nsend > nsort_max){
+      if (sort_buf != NULL) FreeArray1D(sort_buf);
+      nsort_max = pex_nsend_max;
+      sort_buf  = ARRAY_1D(nsort_max, Particle);
     }
-     
-#if PARTICLES_USE_MPI_DATATYPE == YES
-    MPI_Sendrecv(send_bufL, nsendL, MPI_PARTICLE, procL , 9, 
-                 recv_bufR, nrecvR, MPI_PARTICLE, procR,  9, MPI_COMM_WORLD, &status);
-#else
-    MPI_Sendrecv(send_bufL, sizeof(Particle)*nsendL, MPI_BYTE, procL , 9, 
-                 recv_bufR, sizeof(Particle)*nrecvR, MPI_BYTE, procR,  9, MPI_COMM_WORLD, &status);
-#endif
+    pex_sdispl[0] = 0;
+    for (s = 1; s < pex_nout; s++) pex_sdispl[s] = pex_sdispl[s-1] + pex_scount[s-1];
+    for (i = 0; i < nsend; i++){
+      s = pex_key[i];
+      p = sort_buf + pex_sdispl[s]++;
+      *p = pex_send_buf[i];
+      for (dir = 0; dir < 3; dir++) p->coord[dir] += pex_shift[s][dir];
+    }
+    for (i = 0; i < nsend; i++) pex_send_buf[i] = sort_buf[i];
+  }
+  pex_sdispl[0] = 0;
+  for (s = 1; s < pex_nout; s++) pex_sdispl[s] = pex_sdispl[s-1] + pex_scount[s-1];
 
-    for(i = 0; i < nrecvR; i++){
-      p = recv_bufR + i;
-      if (grid->rbound[dir] == PERIODIC || grid->rbound[dir] == SHEARING){
-        p->coord[dir] += g_domEnd[dir] - g_domBeg[dir]; /* Apply Periodicity. */
-      }
-      success = Particles_Insert(p, d, PARTICLES_TRANSFER, grid);
-    }     
+  MPI_Wait(&req, MPI_STATUS_IGNORE);
 
-    MPI_Barrier(MPI_COMM_WORLD); /* Synchronize after each sweep */
+/* --------------------------------------------------------------
+   3. Start payload exchange
+   -------------------------------------------------------------- */
 
-/* -------------------------------------------------------
-    Destroy particles that have been transferred
-   ------------------------------------------------------- */
+  pex_nrecv = 0;
+  for (s = 0; s < pex_nin; s++){
+    pex_rdispl[s] = pex_nrecv;
+    pex_nrecv    += pex_rcount[s];
+  }
+  if (pex_nrecv > pex_nrecv_max){
+    if (pex_recv_buf != NULL) FreeArray1D(pex_recv_buf);
+    pex_nrecv_max = 2*pex_nrecv;
+    pex_recv_buf  = ARRAY_1D(pex_nrecv_max, Particle);
+  }
 
-    for (i = 0; i < nsendL; i++) Particles_Destroy (pstackL[i], d); 
-    for (i = 0; i < nsendR; i++) Particles_Destroy (pstackR[i], d); 
+  MPI_Ineighbor_alltoallv(pex_send_buf, pex_scount, pex_sdispl, pex_type,
+                          pex_recv_buf, pex_rcount, pex_rdispl, pex_type,
+                          pex_comm, &pex_req);
 
-/* --------------------------------------------------------
-     Free memory
-   -------------------------------------------------------- */
-      
-    FreeArray1D(pstackL);
-    FreeArray1D(pstackR);
-    FreeArray1D(recv_bufL);
-    FreeArray1D(recv_bufR);
-    FreeArray1D(send_bufL);
-    FreeArray1D(send_bufR);
+  DEBUG_FUNC_END("Particles_BoundaryExchangeBegin");
+#endif /* PARALLEL */
+  pex_pending = 1;
+}
 
-    g_usedMemory -= 2*p_nparticles*sizeof(particleNode *);
-    g_usedMemory -= (nsendL+nsendR)*sizeof(Particle);
-    g_usedMemory -= (nrecvL+nrecvR)*sizeof(Particle);
+/* ********************************************************************* */
+void Particles_BoundaryExchangeEnd(Data *d, Grid *grid)
+/*!
+ * Complete the particle exchange started by
+ * Particles_BoundaryExchangeBegin() and insert the received particles
+ * into the local list.
+ * Nothing is exchanged if no exchange is in progress.
+ *
+ * \param [in]   d        Pointer to PLUTO data structure.
+ * \param [in]   grid     Pointer to the PLUTO grid structure.
+ *********************************************************************** */
+{
+#ifdef PARALLEL
+  long int i;
+#endif
+
+  if (!pex_pending) return;
+  pex_pending = 0;
+
+  DEBUG_FUNC_BEG("Particles_BoundaryExchangeEnd");
+
+#ifdef PARALLEL
+  MPI_Wait(&pex_req, MPI_STATUS_IGNORE);
 
-  }  /* End loop on dimensions */
+  for (i = 0; i < pex_nrecv; i++){
+    Particles_Insert(pex_recv_buf + i, d, PARTICLES_TRANSFER, grid);
+  }
 
 #if DEBUG    
 if (d_condition)print("Particles_Check = %d, %d, %d; p_nparticles = %d\n",
@@ -413,20 +516,26 @@ if (d_condition)print("Particles_Check = %d, %d, %d; p_nparticles = %d\n",
 #endif
    
 #endif /* PARALLEL */
-/*
-  int long count = Particles_CheckAll(d->PHead, 1, grid);
-  if (count != p_nparticles){
-    printLog ("! Particles_BoundaryExchange(): %d particles out of %d are\n",
-           count,p_nparticles);
-    printLog ("! inside the active domain. \n");
-    QUIT_PLUTO(1);
+
+/* --------------------------------------------------------
+   Periodically sort particles by cell index
+   (Particles_Sort() also rebuilds the array, if any).
+   -------------------------------------------------------- */
+
+#if PARTICLES_SORT_FREQ > 0
+  static long int nexchange = 0;
+  if ((++nexchange) % PARTICLES_SORT_FREQ == 0) {
+    Particles_Sort(d, grid);
+    DEBUG_FUNC_END("Particles_BoundaryExchangeEnd");
+    return;
   }
-*/
+#endif
+
 #if PARTICLES_USE_ARRAY == YES
   Particles_ListToArray(d);
 #endif
 
-  DEBUG_FUNC_END("Particles_BoundaryExchange");
+  DEBUG_FUNC_END("Particles_BoundaryExchangeEnd");
 }
 
 /* ********************************************************************* */
@@ -107,6 +107,7 @@ void Particles_CR_Update(Data *data, timeStep *Dts, double dt, Grid *grid)
   #endif
 
   Boundary (data, ALL_DIR, grid);
+  Particles_BoundaryExchangeEnd(data, grid);
 
 /* --------------------------------------------------------
    0. Allocate memory
@@ -576,11 +577,19 @@ omegaL = MAX(omegaL, omL);
 
   /* ----------------------------------------------------
      3e. Set boundary condition after deposition at
-         x^{n+1/2} has been done
+         x^{n+1/2} has been done.
+         After the last sub-cycle the exchange is only
+         started: it is completed by the caller with
+         Particles_BoundaryExchangeEnd(), after filling
+         fluid ghost zones.
      ---------------------------------------------------- */
 
     Particles_Boundary(data, grid);
-    Particles_BoundaryExchange(data, grid);
+    if (kcycle < Dts->Nsub_particles - 1) {
+      Particles_BoundaryExchange(data, grid);
+    }else{
+      Particles_BoundaryExchangeBegin(data, grid);
+    }
 
     #if SHOW_TIMING
     clock0 = clock();
@@ -36,10 +36,21 @@
 #include "pluto.h"
 
 #define NELEM_MAX     64
+#define NSTENCIL      27    /* Size of the 3x3x3 weight array */
+
+static void DepositFlush (Data_Arr, double (*)[NSTENCIL], int *, int);
+static int  DepositInCell (Particle *, int *, Grid *);
+
 /* ********************************************************************* */
 void Particles_Deposit(particleNode *PHead, void (*Func)(Particle *, double *),
                        Data_Arr Q, int nelem, Grid *grid)
 /*!
+ *
+ * Particles are processed in runs of consecutive particles sharing
+ * the same hosting cell (as produced by Particles_Sort()): within a
+ * run the cell search is skipped and contributions are summed
+ * into a contiguous stencil buffer, which is added to \c Q only
+ * once at the end of the run.
  *
  * \param [in]  PHead   pointer to particle Node
  * \param [in]  Func()  pointe to function containing the quantity to
@@ -50,21 +61,26 @@ void Particles_Deposit(particleNode *PHead, void (*Func)(Particle *, double *),
  *
  *********************************************************************** */
 {
-  int    i, j, k, n, dir;
-  int    i1, j1, k1;
+  int    i, j, k, n, m, dir;
+  int    cell[3] = {-1, -1, -1};
   long int np_tot = NX1_TOT*NX2_TOT*NX3_TOT;
-  double qd[NELEM_MAX];
+  double qd[NELEM_MAX], *wflat;
+  static double acc[NELEM_MAX][NSTENCIL];
   static double ***w;
   particleNode *CurNode;
   Particle     *p;
 
 /* --------------------------------------------------------
-   0. Allocate memory
+   0. Allocate memory.
+      Weights outside the active stencil (e.g. w[+-1] in 2D)
+      are never set and remain zero.
    -------------------------------------------------------- */
 
   if (w == NULL) {
     w  = ARRAY_BOX (-1, 1, -1, 1, -1, 1, double);
+    memset ((void *)&w[-1][-1][-1], '\0', NSTENCIL*sizeof(double));
   }
+  wflat = &w[-1][-1][-1];
 
   if (nelem > NELEM_MAX){
     printLog ("! Particles_Deposit: exceeded max number of elements (%d)\n",
@@ -79,6 +95,7 @@ void Particles_Deposit(particleNode *PHead, void (*Func)(Particle *, double *),
 
   for (n = 0; n < nelem; n++) {
     memset ((void *)Q[n][0][0], '\0', np_tot*sizeof(double));
+    for (m = 0; m < NSTENCIL; m++) acc[n][m] = 0.0;
   }
 
 /* --------------------------------------------------------
@@ -89,21 +106,22 @@ void Particles_Deposit(particleNode *PHead, void (*Func)(Particle *, double *),
   PARTICLES_LOOP(CurNode, PHead){
     p = &(CurNode->p);
 
-    Particles_GetWeights(p, p->cell, w, grid);
+    if (DepositInCell(p, cell, grid)){
+      Particles_CellWeights(p, cell, w, grid);
+      for (dir = 0; dir < 3; dir++) p->cell[dir] = cell[dir];
+    }else{                          /* -- a new run begins -- */
+      DepositFlush (Q, acc, cell, nelem);
+      Particles_GetWeights(p, p->cell, w, grid);
+      for (dir = 0; dir < 3; dir++) cell[dir] = p->cell[dir];
+    }
 
     Func(p, qd);    /* Compute quantities to be deposited */
-    i = p->cell[IDIR];
-    j = p->cell[JDIR];
-    k = p->cell[KDIR];
-
     for (n = 0; n < nelem; n++){
-      for (k1 = -INCLUDE_KDIR; k1 <= INCLUDE_KDIR; k1++){
-      for (j1 = -INCLUDE_JDIR; j1 <= INCLUDE_JDIR; j1++){
-      for (i1 = -INCLUDE_IDIR; i1 <= INCLUDE_IDIR; i1++){
-        Q[n][k+k1][j+j1][i+i1] += qd[n]*w[k1][j1][i1];
-      }}}
+      for (m = 0; m < NSTENCIL; m++) acc[n][m] += qd[n]*wflat[m];
     }
   }
+  DepositFlush (Q, acc, cell, nelem);
+
 #elif PARTICLES_DEPOSIT == INTEGER
   long int wq;
   double C = 1.e6, max_qd[16], glob_max_qd[16];
@@ -129,29 +147,31 @@ void Particles_Deposit(particleNode *PHead, void (*Func)(Particle *, double *),
 /* --------------------------------------------------------
    2b. Deposit normalized values (qd/max(qd)) by
        transforming to integer, so that addition is
-       associative.
+       associative (run sums are exact as well).
    -------------------------------------------------------- */
   
   PARTICLES_LOOP(CurNode, PHead){
     p = &(CurNode->p);
 
-    Particles_GetWeights(p, p->cell, w, grid);
+    if (DepositInCell(p, cell, grid)){
+      Particles_CellWeights(p, cell, w, grid);
+      for (dir = 0; dir < 3; dir++) p->cell[dir] = cell[dir];
+    }else{
+      DepositFlush (Q, acc, cell, nelem);
+      Particles_GetWeights(p, p->cell, w, grid);
+      for (dir = 0; dir < 3; dir++) cell[dir] = p->cell[dir];
+    }
 
     Func(p, qd);    /* Compute quantities to be deposited */    
-    i = p->cell[IDIR];
-    j = p->cell[JDIR];
-    k = p->cell[KDIR];
-
     for (n = 0; n < nelem; n++){
       qd[n] /= max_qd[n];
-      for (k1 = -INCLUDE_KDIR; k1 <= INCLUDE_KDIR; k1++){
-      for (j1 = -INCLUDE_JDIR; j1 <= INCLUDE_JDIR; j1++){
-      for (i1 = -INCLUDE_IDIR; i1 <= INCLUDE_IDIR; i1++){
-        wq = (long)(C*qd[n]*w[k1][j1][i1]);
-        Q[n][k+k1][j+j1][i+i1] += wq;
-      }}}
+      for (m = 0; m < NSTENCIL; m++){
+        wq = (long)(C*qd[n]*wflat[m]);
+        acc[n][m] += wq;
+      }
     }
   }
+  DepositFlush (Q, acc, cell, nelem);
 #endif
 
 /* --------------------------------------------------------
@@ -373,3 +393,43 @@ void Particles_Density(Particle *p, double *qd)
   qd[0] = 1.0;
 }
 
+/* ********************************************************************* */
+int DepositInCell(Particle *p, int *cell, Grid *grid)
+/*!
+ *  Return 1 if the particle lies in the zone with indices \c cell
+ *  (the cell of the current run), 0 otherwise.
+ *********************************************************************** */
+{
+  int dir;
+
+  if (cell[IDIR] < 0) return 0;
+  DIM_LOOP(dir){
+    if (   p->coord[dir] <  grid->xl[dir][cell[dir]]
+        || p->coord[dir] >= grid->xr[dir][cell[dir]]) return 0;
+  }
+  return 1;
+}
+
+/* ********************************************************************* */
+void DepositFlush(Data_Arr Q, double (*acc)[NSTENCIL], int *cell, int nelem)
+/*!
+ *  Add the contributions accumulated over a run of particles
+ *  hosted by \c cell to the grid array and reset the buffer.
+ *********************************************************************** */
+{
+  int i, j, k, n, i1, j1, k1, m;
+
+  if (cell[IDIR] < 0) return;
+  i = cell[IDIR];
+  j = cell[JDIR];
+  k = cell[KDIR];
+  for (n = 0; n < nelem; n++){
+    for (k1 = -INCLUDE_KDIR; k1 <= INCLUDE_KDIR; k1++){
+    for (j1 = -INCLUDE_JDIR; j1 <= INCLUDE_JDIR; j1++){
+    for (i1 = -INCLUDE_IDIR; i1 <= INCLUDE_IDIR; i1++){
+      m = ((k1 + 1)*3 + j1 + 1)*3 + i1 + 1;
+      Q[n][k+k1][j+j1][i+i1] += acc[n][m];
+    }}}
+    for (m = 0; m < NSTENCIL; m++) acc[n][m] = 0.0;
+  }
+}
@@ -70,6 +70,7 @@ void Particles_SetOutput (Data *d, Runtime *runtime)
     if (output->type == PARTICLES_FLT_OUTPUT) strcpy (output->ext,"flt");
     if (output->type == PARTICLES_VTK_OUTPUT) strcpy (output->ext,"vtk");
     if (output->type == PARTICLES_TAB_OUTPUT) strcpy (output->ext,"tab");
+    if (output->type == PARTICLES_HDF5_OUTPUT) strcpy (output->ext,"h5");
 
   /* ------------------------------------------------------
      1d. Set default field names (all of them).
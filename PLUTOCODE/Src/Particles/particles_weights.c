@@ -47,12 +47,7 @@ void Particles_GetWeights (Particle *p, int *cell, double ***w, Grid *grid)
  *
  *********************************************************************** */
 {
-  int    err, i, j, k, dir;
-  double *xg, *xc, *xr, *dx, *inv_dx, xp;
-  double w1[3][3], delta, scrh, Wi;
-  #if GEOMETRY != CARTESIAN
-  double den, dR, nu;
-  #endif
+  int err;
 
 /* --------------------------------------------------------
    0. Find the indices of the grid zone hosting 
@@ -69,7 +64,32 @@ void Particles_GetWeights (Particle *p, int *cell, double ***w, Grid *grid)
     Particles_Display(p);
     QUIT_PLUTO(1);
   }
-  
+  Particles_CellWeights (p, cell, w, grid);
+}
+
+/* ********************************************************************* */
+void Particles_CellWeights (Particle *p, int *cell, double ***w, Grid *grid)
+/*! 
+ * Same as Particles_GetWeights() when the indices of the cell
+ * hosting the particle are already known.
+ * Used by Particles_Deposit() for runs of particles sharing the
+ * same cell after Particles_Sort().
+ * 
+ * \param [in]  p       pointer to particle structure
+ * \param [in]  cell    a 3-element array containing the indices (i,j,k) of 
+ *                      the grid cell hosting the particle.
+ * \param [out] w       a 3x3x3 array containing the weights
+ * \param [in]  grid    a pointer to an array of Grid structures
+ *
+ *********************************************************************** */
+{
+  int    i, j, k, dir;
+  double *xg, *xc, *xr, *dx, *inv_dx, xp;
+  double w1[3][3], delta, scrh, Wi;
+  #if GEOMETRY != CARTESIAN
+  double den, dR, nu;
+  #endif
+
 /* -- Set default value for 1D weights  -- */
 
   for (dir = 0; dir < 3; dir++) {
@@ -8,7 +8,7 @@
           B. Vaidya (bvaidya@unito.it)\n
           D. Mukherjee
 
- \date    Oct 31, 2020
+ \date    Oct 18, 2026
  */
 /* ///////////////////////////////////////////////////////////////////// */
 #include "pluto.h"
@@ -30,16 +30,12 @@ void Particles_WriteBinary(particleNode *PHeadRef, double dt_particles,
  *   .
  *   . 
  *
- * All fields are mapped from the particle structure into an array
- * and thus converted to either single or double precision, depending
- * on the function that is being called.
- * Fields can be scalars or array: for each particle nelem indicates
- * the number of elements written for each particle.
- * The field order does not have to match the structure member order but it
- * must be consistent with the sequence declared in Particles_SetOutput()
- * function.
- * Individual fields may be excluded by calling SetOutputVar() 
- * from ChangeOutputVar ().
+ * Fields are packed by Particles_PackFields() directly in the output
+ * precision.
+ * In parallel, the file offset of each processor is obtained with an
+ * exclusive scan of the particle numbers and all processors write
+ * their block with a single collective MPI_File_write_at_all(), while
+ * processor 0 writes the header.
  *
  *  \param [in]  PheadRef      Pointer to the Head Node of Particle List.
  *  \param [in]  dt_particles  Particle time step
@@ -50,18 +46,14 @@ void Particles_WriteBinary(particleNode *PHeadRef, double dt_particles,
 {
   char     fheader[1024];
   size_t   size;
-  int      dir, nv, k, nfields;
+  int      nv, nfields, hlen;
   int     *dump_var = output->dump_var;
   int      nvar     = output->nvar;
-  long int nelem;
-  long int i, offset, nparticles_glob, proc_npart[g_nprocs+1];
-  void    *arr;
-  float   *farr;
-  double  *darr, gamma;
-  particleNode * CurNode;
+  long int i, nelem, offset, nparticles_glob;
+  char    *buf;
   
 /* --------------------------------------------------------
-   0. Allocate memory for required fields
+   0. Count fields and pack them into a contiguous buffer
    -------------------------------------------------------- */
 
   nfields = 0; /* Count how many fields are written to disk */
@@ -73,81 +65,27 @@ void Particles_WriteBinary(particleNode *PHeadRef, double dt_particles,
       nelem += output->field_dim[nv];
     }
   }
-  darr = ARRAY_1D(nelem*p_nparticles, double);
-  farr = ARRAY_1D(nelem*p_nparticles, float);
+  size = (output->type == PARTICLES_FLT_OUTPUT ? sizeof(float):sizeof(double));
+  buf  = ARRAY_1D(nelem*p_nparticles*size + 1, char);
+  Particles_PackFields (PHeadRef, output, buf, size);
   
 /* --------------------------------------------------------
-   1. Loop over particles and map struct. members to array
-   -------------------------------------------------------- */
-    
-  i  = 0;  /* Array index */
-
-  PARTICLES_LOOP(CurNode, PHeadRef){
-
-  /* ------------------------------------------------------
-     1b. Map structure members to array.
-         Important: field order should match the order 
-         given in Particles_SetOutput().
-         Here nv scan *all* fields (nv <= nfields)
-     ------------------------------------------------------ */
-
-    nv = 0;
-    #if PARTICLES == PARTICLES_CR
-    if (dump_var[nv++]) darr[i++] = CurNode->p.id;
-    if (dump_var[nv++]) darr[i++] = CurNode->p.coord[IDIR];
-    if (dump_var[nv++]) darr[i++] = CurNode->p.coord[JDIR];
-    if (dump_var[nv++]) darr[i++] = CurNode->p.coord[KDIR];
-    if (dump_var[nv++]) darr[i++] = CurNode->p.speed[IDIR];
-    if (dump_var[nv++]) darr[i++] = CurNode->p.speed[JDIR];
-    if (dump_var[nv++]) darr[i++] = CurNode->p.speed[KDIR];
-    if (dump_var[nv++]) darr[i++] = CurNode->p.mass;
-    if (dump_var[nv++]) darr[i++] = CurNode->p.tinj;
-    if (dump_var[nv++]) darr[i++] = CurNode->p.color;
-    #endif
-
-    #if PARTICLES == PARTICLES_DUST
-    if (dump_var[nv++]) darr[i++] = CurNode->p.id;
-    if (dump_var[nv++]) darr[i++] = CurNode->p.coord[IDIR];
-    if (dump_var[nv++]) darr[i++] = CurNode->p.coord[JDIR];
-    if (dump_var[nv++]) darr[i++] = CurNode->p.coord[KDIR];
-    if (dump_var[nv++]) darr[i++] = CurNode->p.speed[IDIR];
-    if (dump_var[nv++]) darr[i++] = CurNode->p.speed[JDIR];
-    if (dump_var[nv++]) darr[i++] = CurNode->p.speed[KDIR];
-    if (dump_var[nv++]) darr[i++] = CurNode->p.mass;
-    if (dump_var[nv++]) darr[i++] = CurNode->p.tau_s;
-    if (dump_var[nv++]) darr[i++] = CurNode->p.tinj;
-    if (dump_var[nv++]) darr[i++] = CurNode->p.color;
-    #endif
-
-  } /* End PARTICLES_LOOP() */
-  
-/* --------------------------------------------------------
-   2. Compute the total number of particles and gather
-      each proc. particle number into the proc_npart[1:]
-      array. This serves to compute the file offset. 
+   1. Compute the total number of particles and the offset
+      (in particle units) of this processor.
    -------------------------------------------------------- */
     
   offset = 0L;
 #ifdef PARALLEL
+  MPI_Exscan (&p_nparticles, &offset, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+  if (prank == 0) offset = 0L;   /* -- undefined on proc #0 -- */
   MPI_Allreduce(&p_nparticles, &nparticles_glob, 1,
                 MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
-  MPI_Allgather(&p_nparticles, 1, MPI_LONG, &(proc_npart[1]), 1,
-                MPI_LONG, MPI_COMM_WORLD);
-
-  /* Compute individual processor offset (in particle units) */
-    
-  for(i = 0; i < prank; i++) offset += proc_npart[i+1];
-    
-  MPI_File fhw;
-  MPI_File_open(MPI_COMM_WORLD, filename,
-                MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fhw);
-  MPI_File_close(&fhw);
 #else
   nparticles_glob = p_nparticles;
 #endif
     
 /* --------------------------------------------------------
-   3. Write file header section.
+   2. Build the file header section.
    -------------------------------------------------------- */
   
   sprintf(fheader,"# PLUTO %s binary particle data file\n", PLUTO_VERSION);
@@ -187,48 +125,105 @@ void Particles_WriteBinary(particleNode *PHeadRef, double dt_particles,
     }  
   }
   sprintf(fheader+strlen(fheader),"\n");
-
-  FileWriteHeader(fheader, filename, -1);
+  hlen = strlen(fheader);
     
 /* --------------------------------------------------------
-   4. Write data 
+   3. Write header and data 
    -------------------------------------------------------- */
- 
-  if (output->type == PARTICLES_DBL_OUTPUT) size = sizeof(double);
-  if (output->type == PARTICLES_FLT_OUTPUT) size = sizeof(float);
 
-  offset *= nelem*size; /* Convert offset to bytes */
-  if (output->type == PARTICLES_FLT_OUTPUT){
-    for (i = 0; i < nelem*p_nparticles; i++) farr[i] = (float)darr[i];
-    arr = (void *) farr;
-  }else if (output->type == PARTICLES_DBL_OUTPUT){
-    arr = (void *) darr;
+#ifdef PARALLEL
+  {
+    MPI_File     fh;
+    MPI_Datatype ptype;  /* -- one particle record -- */
+
+    MPI_Bcast (&hlen, 1, MPI_INT, 0, MPI_COMM_WORLD); /* -- proc #0 header -- */
+    MPI_File_open(MPI_COMM_WORLD, filename,
+                  MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh);
+    MPI_File_set_size (fh, 0);  /* Avoid partial fill of pre-existing files */
+    if (prank == 0){
+      MPI_File_write_at (fh, 0, fheader, hlen, MPI_CHAR, MPI_STATUS_IGNORE);
+    }
+    MPI_Type_contiguous (nelem*size, MPI_BYTE, &ptype);
+    MPI_Type_commit (&ptype);
+    MPI_File_write_at_all (fh, (MPI_Offset)hlen + (MPI_Offset)offset*nelem*size,
+                           buf, (int)p_nparticles, ptype, MPI_STATUS_IGNORE);
+    MPI_Type_free (&ptype);
+    MPI_File_close (&fh);
   }
-/*
-if (output->type == PARTICLES_DBL_OUTPUT){
-  i = 0;
-  for (k = 0; k < p_nparticles; k++){
-    for (nv = 0; nv < nfields; nv++){
-      if (darr[i] != darr[i]){
-        printLog ("nan found\n");
-        QUIT_PLUTO(1);
-      }
-      printLog ("np = %d, darr = %f\n",k,darr[i]);
-      i++;
-    }   
+#else
+  {
+    FILE *fp = fopen (filename, "wb");
+
+    fwrite (fheader, sizeof(char), hlen, fp);
+    fwrite (buf, size, nelem*p_nparticles, fp);
+    fclose (fp);
   }
+#endif
+
+  FreeArray1D(buf);   
 }
-*/
-  FileWriteArray(arr, offset, nelem*p_nparticles, size, filename);
+//#endif /* PARTICLES != PARTICLES_LP */
 
-/* --------------------------------------------------------
-   5. Write data 
-   -------------------------------------------------------- */
+/* ********************************************************************* */
+void Particles_PackFields(particleNode *PHeadRef, Output *output,
+                          void *buf, size_t size)
+/*!
+ * Copy the output fields of all local particles into a contiguous
+ * buffer in a single pass over the list, one record of nelem
+ * elements per particle, in single (size = sizeof(float)) or double
+ * precision.
+ * Important: field order should match the order given in
+ * Particles_SetOutput().
+ *
+ *  \param [in]  PheadRef  Pointer to the Head Node of Particle List.
+ *  \param [in]  output    Pointer to output structure
+ *  \param [out] buf       the buffer (nelem*p_nparticles elements)
+ *  \param [in]  size      sizeof(float) or sizeof(double)
+ *********************************************************************** */
+{
+  int    nv;
+  int   *dump_var = output->dump_var;
+  long int i = 0;
+  float  *fbuf = (size == sizeof(float) ? (float *)buf:NULL);
+  double *dbuf = (double *)buf;
+  particleNode *CurNode;
+
+  #define PACK(q)  if (dump_var[nv++]) { \
+                     if (fbuf != NULL) fbuf[i++] = (float)(q); \
+                     else              dbuf[i++] = (q); }
+
+  PARTICLES_LOOP(CurNode, PHeadRef){
+    nv = 0;
+    #if PARTICLES == PARTICLES_CR
+    PACK(CurNode->p.id);
+    PACK(CurNode->p.coord[IDIR]);
+    PACK(CurNode->p.coord[JDIR]);
+    PACK(CurNode->p.coord[KDIR]);
+    PACK(CurNode->p.speed[IDIR]);
+    PACK(CurNode->p.speed[JDIR]);
+    PACK(CurNode->p.speed[KDIR]);
+    PACK(CurNode->p.mass);
+    PACK(CurNode->p.tinj);
+    PACK(CurNode->p.color);
+    #endif
+
+    #if PARTICLES == PARTICLES_DUST
+    PACK(CurNode->p.id);
+    PACK(CurNode->p.coord[IDIR]);
+    PACK(CurNode->p.coord[JDIR]);
+    PACK(CurNode->p.coord[KDIR]);
+    PACK(CurNode->p.speed[IDIR]);
+    PACK(CurNode->p.speed[JDIR]);
+    PACK(CurNode->p.speed[KDIR]);
+    PACK(CurNode->p.mass);
+    PACK(CurNode->p.tau_s);
+    PACK(CurNode->p.tinj);
+    PACK(CurNode->p.color);
+    #endif
+  } /* End PARTICLES_LOOP() */
 
-  FreeArray1D(darr);   
-  FreeArray1D(farr);   
+  #undef PACK
 }
-//#endif /* PARTICLES != PARTICLES_LP */
 
 /* ********************************************************************* */
 void Particles_WriteTab(particleNode* PHeadRef, char filename[128])
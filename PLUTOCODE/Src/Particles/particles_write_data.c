@@ -64,6 +64,14 @@ void Particles_WriteData(Data *d, Output *output, Grid *grid)
 
     Particles_WriteTab(d->PHead, filename);
     
+  }else if (output->type == PARTICLES_HDF5_OUTPUT) { 
+
+    #ifdef USE_HDF5
+    Particles_WriteHDF5(d->PHead, 1.0/d->Dts->invDt_particles,
+                        output, filename);
+    #else
+    print ("! Particles_WriteData(): HDF5 library not available\n");
+    #endif
   }
   
 #ifdef PARALLEL
@@ -0,0 +1,137 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+ \file
+ \brief Writer for particles data in HDF5 format (.h5).
+
+ All particles are stored in a single 2D dataset "particles" of
+ shape (nparticles, nelem), one row per particle with the same field
+ order as the .dbl/.flt binary files (see Particles_PackFields()).
+ Field names and dimensions, time, step number, particle time step
+ and id counter are saved as attributes.
+
+ In parallel, each processor selects the block of rows starting at
+ the exclusive scan of the particle numbers and the data is written
+ with a single collective H5Dwrite() through the MPI-IO driver.
+
+ \date    Oct 18, 2026
+ */
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+#ifdef USE_HDF5
+#define H5_USE_16_API
+#include "hdf5.h"
+
+void WriteHDF5Attribute (hid_t, const char *, hid_t, int, void *);
+
+/* ********************************************************************* */
+void Particles_WriteHDF5(particleNode *PHeadRef, double dt_particles,
+                         Output *output, char *filename)
+/*!
+ *  Write particle data in double precision HDF5 format.
+ *  Collective on MPI_COMM_WORLD.
+ *
+ *  \param [in]  PheadRef      Pointer to the Head Node of Particle List.
+ *  \param [in]  dt_particles  Particle time step
+ *  \param [in]  output        Pointer to output structure
+ *  \param [in]  filename      File name of particle data: particles.nnnn.h5
+ *********************************************************************** */
+{
+  char     names[1024];
+  int      nv, nfields, dims[MAX_OUTPUT_VARS];
+  int     *dump_var = output->dump_var;
+  long int nelem, offset, nparticles_glob, step;
+  double  *buf;
+  hid_t    file_access, file, space, memspace, dataset, xfer;
+  hsize_t  gdims[2], ldims[2], start[2];
+
+/* --------------------------------------------------------
+   0. Count fields and pack them
+   -------------------------------------------------------- */
+
+  nfields  = 0;
+  nelem    = 0;
+  names[0] = '\0';
+  for (nv = 0; nv < output->nvar; nv++) {
+    if (dump_var[nv]) {
+      sprintf (names + strlen(names), "%s ", output->var_name[nv]);
+      dims[nfields++] = output->field_dim[nv];
+      nelem += output->field_dim[nv];
+    }
+  }
+  buf = ARRAY_1D(nelem*p_nparticles + 1, double);
+  Particles_PackFields (PHeadRef, output, buf, sizeof(double));
+
+/* --------------------------------------------------------
+   1. Global size and offset (rows) of this processor
+   -------------------------------------------------------- */
+
+  offset = 0L;
+#ifdef PARALLEL
+  MPI_Exscan (&p_nparticles, &offset, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+  if (prank == 0) offset = 0L;
+  MPI_Allreduce(&p_nparticles, &nparticles_glob, 1,
+                MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+#else
+  nparticles_glob = p_nparticles;
+#endif
+
+/* --------------------------------------------------------
+   2. Create file and dataset
+   -------------------------------------------------------- */
+
+  file_access = H5Pcreate(H5P_FILE_ACCESS);
+#ifdef PARALLEL
+  H5Pset_fapl_mpio(file_access, MPI_COMM_WORLD, MPI_INFO_NULL);
+#endif
+  file = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, file_access);
+  H5Pclose(file_access);
+  if (file < 0){
+    print ("! Particles_WriteHDF5(): cannot create %s\n", filename);
+    QUIT_PLUTO(1);
+  }
+
+  step = g_stepNumber;
+  WriteHDF5Attribute (file, "time", H5T_NATIVE_DOUBLE, 1, &g_time);
+  WriteHDF5Attribute (file, "step", H5T_NATIVE_LONG, 1, &step);
+  WriteHDF5Attribute (file, "dt_particles", H5T_NATIVE_DOUBLE, 1,
+                      &dt_particles);
+  WriteHDF5Attribute (file, "idCounter", H5T_NATIVE_LONG, 1, &p_idCounter);
+
+  gdims[0] = nparticles_glob;
+  gdims[1] = nelem;
+  space    = H5Screate_simple(2, gdims, NULL);
+  dataset  = H5Dcreate(file, "particles", H5T_NATIVE_DOUBLE, space,
+                       H5P_DEFAULT);
+  WriteHDF5Attribute (dataset, "field_names", H5T_C_S1, strlen(names), names);
+  WriteHDF5Attribute (dataset, "field_dim", H5T_NATIVE_INT, nfields, dims);
+
+/* --------------------------------------------------------
+   3. Select the local rows and write
+   -------------------------------------------------------- */
+
+  ldims[0] = p_nparticles;
+  ldims[1] = nelem;
+  start[0] = offset;
+  start[1] = 0;
+  memspace = H5Screate_simple(2, ldims, NULL);
+  if (p_nparticles > 0){
+    H5Sselect_hyperslab(space, H5S_SELECT_SET, start, NULL, ldims, NULL);
+  }else{
+    H5Sselect_none(space);
+    H5Sselect_none(memspace);
+  }
+
+  xfer = H5Pcreate(H5P_DATASET_XFER);
+#ifdef PARALLEL
+  H5Pset_dxpl_mpio(xfer, H5FD_MPIO_COLLECTIVE);
+#endif
+  H5Dwrite(dataset, H5T_NATIVE_DOUBLE, memspace, space, xfer, buf);
+
+  H5Pclose(xfer);
+  H5Sclose(memspace);
+  H5Dclose(dataset);
+  H5Sclose(space);
+  H5Fclose(file);
+  FreeArray1D(buf);
+}
+#endif /* USE_HDF5 */
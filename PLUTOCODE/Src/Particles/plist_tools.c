@@ -6,6 +6,12 @@
   Collect various functions for adding / destroying 
   particles.         
 
+  List nodes are not allocated individually but taken from a pool of
+  contiguous chunks of ::PARTICLES_POOL_CHUNK nodes.
+  Particles_Sort() periodically rebuilds the list into a single
+  contiguous block ordered by cell index, so that traversing the list
+  (e.g. during deposition) accesses memory and grid zones sequentially.
+
   \authors A. Mignone (mignone@to.infn.it)\n
 
   \date    Jul 25, 2019
@@ -13,6 +19,14 @@
 /* ///////////////////////////////////////////////////////////////////// */
 #include "pluto.h"
 
+static particleNode *Particles_NodeAlloc (void);
+static void          Particles_NodeFree (particleNode *);
+
+static particleNode  *pool_free = NULL;   /* Free nodes (linked with ->next) */
+static particleNode **pool_chunk = NULL;  /* Allocated chunks of nodes       */
+static long int       pool_nchunks = 0, pool_maxchunks = 0;
+static long int       pool_nnodes  = 0;   /* Total number of allocated nodes */
+
 /* ********************************************************************* */
 int Particles_Insert(Particle *dummy, Data *d, char mode, Grid *grid)
 /*!
@@ -84,8 +98,7 @@ int Particles_Insert(Particle *dummy, Data *d, char mode, Grid *grid)
       dummy->tinj = g_time;                 /* Set injection time to current time */
     }
     
-    new_node      = malloc(sizeof(particleNode)); /* Allocate memory for a new node */
-    g_usedMemory += sizeof(particleNode);
+    new_node      = Particles_NodeAlloc(); /* Get a new node from the pool */
     new_node->p   = *dummy;         /* Copy input particle */
       
  /* -------------------------------------------------------
@@ -151,11 +164,147 @@ void Particles_Destroy(particleNode *curr, Data *d)
     prev->next = next;
   }
 
-  free(curr);
-  g_usedMemory -= sizeof(particleNode);
+  Particles_NodeFree(curr);
   p_nparticles--;
 }
 
+/* ********************************************************************* */
+void Particles_Sort(Data *d, Grid *grid)
+/*!
+ * Sort particles by the index of the hosting cell and move them into
+ * a single contiguous block of nodes, linked in the same order.
+ * Previously allocated chunks are released.
+ * Pointers to list nodes are no longer valid after this call.
+ *
+ * \param [in,out] d     pointer to PLUTO Data structure
+ * \param [in]     grid  pointer to an array of Grid structures
+ *********************************************************************** */
+{
+  long int n, m, nc, ncells = NX1_TOT*NX2_TOT*NX3_TOT;
+  int  indx[3];
+  static long int nkey_max = 0, *count = NULL;
+  static int *key = NULL;
+  particleNode *curr, *block;
+
+  if (p_nparticles < 2) return;
+
+/* --------------------------------------------------------
+   1. Compute cell keys and count particles per cell.
+      Particles outside the local grid go last.
+   -------------------------------------------------------- */
+
+  if (count == NULL) count = ARRAY_1D(ncells + 2, long int);
+  if (p_nparticles > nkey_max){
+    if (key != NULL) FreeArray1D(key);
+    nkey_max = 2*p_nparticles;
+    key      = ARRAY_1D(nkey_max, int);
+  }
+  for (nc = 0; nc < ncells + 2; nc++) count[nc] = 0;
+
+  n = 0;
+  PARTICLES_LOOP(curr, d->PHead){
+    if (Particles_LocateCell(curr->p.coord, indx, grid) == 0){
+      key[n] = (indx[KDIR]*NX2_TOT + indx[JDIR])*NX1_TOT + indx[IDIR];
+    }else{
+      key[n] = ncells;
+    }
+    count[key[n] + 1]++;
+    n++;
+  }
+  for (nc = 1; nc < ncells + 2; nc++) count[nc] += count[nc-1];
+
+/* --------------------------------------------------------
+   2. Copy particles into a new contiguous block (with
+      room for one extra chunk) and link the nodes
+      sequentially.
+   -------------------------------------------------------- */
+
+  block = (particleNode *) malloc((p_nparticles + PARTICLES_POOL_CHUNK)
+                                  *sizeof(particleNode));
+  if (block == NULL){
+    printLog ("! Particles_Sort(): cannot allocate memory\n");
+    QUIT_PLUTO(1);
+  }
+
+  n = 0;
+  PARTICLES_LOOP(curr, d->PHead){
+    block[count[key[n]]++].p = curr->p;
+    n++;
+  }
+
+  for (m = 0; m < p_nparticles; m++){
+    block[m].prev = (m == 0 ? NULL:block + m - 1);
+    block[m].next = (m == p_nparticles-1 ? NULL:block + m + 1);
+  }
+  d->PHead = block;
+
+/* --------------------------------------------------------
+   3. Release old chunks and rebuild the pool
+   -------------------------------------------------------- */
+
+  for (nc = 0; nc < pool_nchunks; nc++) free(pool_chunk[nc]);
+  g_usedMemory -= pool_nnodes*sizeof(particleNode);
+  pool_nnodes   = p_nparticles + PARTICLES_POOL_CHUNK;
+  g_usedMemory += pool_nnodes*sizeof(particleNode);
+
+  pool_chunk[0] = block;
+  pool_nchunks  = 1;
+  pool_free     = NULL;
+  for (m = p_nparticles + PARTICLES_POOL_CHUNK - 1; m >= p_nparticles; m--){
+    block[m].next = pool_free;
+    pool_free     = block + m;
+  }
+
+  #if PARTICLES_USE_ARRAY == YES
+  Particles_ListToArray(d);
+  #endif
+}
+
+/* ********************************************************************* */
+particleNode *Particles_NodeAlloc(void)
+/*!
+ * Return a node from the pool, allocating a new chunk of
+ * ::PARTICLES_POOL_CHUNK contiguous nodes when the pool is empty.
+ *********************************************************************** */
+{
+  long int m;
+  particleNode *node;
+
+  if (pool_free == NULL){
+    if (pool_nchunks == pool_maxchunks){
+      pool_maxchunks = 2*pool_maxchunks + 8;
+      pool_chunk = realloc(pool_chunk, pool_maxchunks*sizeof(particleNode *));
+    }
+    node = (particleNode *) malloc(PARTICLES_POOL_CHUNK*sizeof(particleNode));
+    if (node == NULL || pool_chunk == NULL){
+      printLog ("! Particles_NodeAlloc(): cannot allocate memory\n");
+      QUIT_PLUTO(1);
+    }
+    pool_chunk[pool_nchunks++] = node;
+    pool_nnodes  += PARTICLES_POOL_CHUNK;
+    g_usedMemory += PARTICLES_POOL_CHUNK*sizeof(particleNode);
+
+    for (m = PARTICLES_POOL_CHUNK - 1; m >= 0; m--){
+      node[m].next = pool_free;
+      pool_free    = node + m;
+    }
+  }
+
+  node      = pool_free;
+  pool_free = node->next;
+  return node;
+}
+
+/* ********************************************************************* */
+void Particles_NodeFree(particleNode *node)
+/*!
+ * Return a node to the pool.
+ *********************************************************************** */
+{
+  node->next = pool_free;
+  pool_free  = node;
+}
+
 /* ********************************************************************* */
 void Particles_Display(Particle *p)
 /*!
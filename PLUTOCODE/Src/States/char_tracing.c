@@ -313,9 +313,7 @@ void CharTracingStep(const Sweep *sweep, int beg, int end, Grid *grid)
 
   if (src == NULL) src = ARRAY_2D(NMAX_POINT, NVAR, double);
 
-#if UNIFORM_CARTESIAN_GRID == NO
   PLM_CoefficientsGet (&plm_coeffs, g_dir);
-#endif
 
 /* --------------------------------------------------------
    1. Compute preliminary quantities such as sound speed,
@@ -342,12 +340,8 @@ void CharTracingStep(const Sweep *sweep, int beg, int end, Grid *grid)
 
   for (i = beg; i <= end; i++){    
 
-    #if UNIFORM_CARTESIAN_GRID == YES
-    dp = dm = 0.5;
-    #else
-    dp = plm_coeffs.dp[i]; 
+    dp = plm_coeffs.dp[i];  /* = 0.5 along uniform directions */
     dm = plm_coeffs.dm[i];
-    #endif
 
     dx   = grid->dx[g_dir][i];
     dtdx = g_dt/dx;
@@ -10,6 +10,16 @@
   
   The function ::PLM_CoefficientsGet() can be used to obtain
   a set of coefficients along a desired direction.
+
+  Coefficients for all directions are stored in a single contiguous
+  table, with every 1D array starting on a ::PLM_TABLE_ALIGN byte
+  boundary.
+  Directions along which the coefficients coincide (to within
+  ::PLM_UNIFORM_TOL) with those of a uniform Cartesian grid are flagged
+  as uniform and their coefficients are set to the exact values
+  (c = 2, w = 1, d = 1/2).
+  The flag is returned in PLM_Coeffs::uniform and allows States() to
+  select the uniform-grid specialization at run time.
   
   \b References
      - "High-order conservative reconstruction schemes for finite
@@ -22,9 +32,19 @@
 /* ///////////////////////////////////////////////////////////////////// */
 #include "pluto.h"
 
+#ifndef PLM_UNIFORM_TOL
+ #define PLM_UNIFORM_TOL   1.e-8  /**< Relative tolerance used to flag a
+                                       direction as uniform. */
+#endif
+
+#define PLM_TABLE_ALIGN    64     /**< Alignment (in bytes) of each
+                                       1D coefficient array. */
+
+static double *s_table;
 static double *cp3D[3], *cm3D[3];
 static double *wp3D[3], *wm3D[3];
 static double *dp3D[3], *dm3D[3];
+static int    s_uniform[3];
 
 /* ********************************************************************* */
 void PLM_CoefficientsSet(Grid *grid)
@@ -36,17 +56,29 @@ void PLM_CoefficientsSet(Grid *grid)
  * \return  This function has no return value
  *********************************************************************** */
 {
-  int    i, d, beg, end;
+  int    i, d, beg, end, uniform;
+  long int nstride;
   double *dx, *xr, *xgc;
+  double **table[6] = {cp3D, cm3D, wp3D, wm3D, dp3D, dm3D};
+
+/* -----------------------------------------------------
+    Allocate the six 1D arrays of every direction
+    in one contiguous block, padding each one to a
+    multiple of PLM_TABLE_ALIGN bytes.
+   ----------------------------------------------------- */
 
-  if (cp3D[0] == NULL) {
-    DIM_LOOP(d){
-      cp3D[d] = ARRAY_1D(NMAX_POINT, double);
-      cm3D[d] = ARRAY_1D(NMAX_POINT, double);
-      dp3D[d] = ARRAY_1D(NMAX_POINT, double);
-      dm3D[d] = ARRAY_1D(NMAX_POINT, double);
-      wp3D[d] = ARRAY_1D(NMAX_POINT, double);
-      wm3D[d] = ARRAY_1D(NMAX_POINT, double);
+  if (s_table == NULL) {
+    int n;
+    nstride = PLM_TABLE_ALIGN/sizeof(double);
+    nstride = ((NMAX_POINT + nstride - 1)/nstride)*nstride;
+    if (posix_memalign((void **)&s_table, PLM_TABLE_ALIGN,
+                       6*DIMENSIONS*nstride*sizeof(double)) != 0){
+      printLog ("! PLM_CoefficientsSet(): cannot allocate memory.\n");
+      QUIT_PLUTO(1);
+    }
+    for (i = 0; i < 6*DIMENSIONS*nstride; i++) s_table[i] = 0.0;
+    DIM_LOOP(d) for (n = 0; n < 6; n++){
+      table[n][d] = s_table + (6*d + n)*nstride;
     }
   }
 
@@ -76,6 +108,24 @@ void PLM_CoefficientsSet(Grid *grid)
       dp3D[d][i] = (xr[i] - xgc[i])/dx[i];     /* Eq. [30], plus sign */
       dm3D[d][i] = (xgc[i] - xr[i-1])/dx[i];   /* Eq. [30], minus sign */
     }
+
+  /* -- Flag uniform directions and store exact coefficients -- */
+
+    uniform = 1;
+    for (i = beg; i <= end && uniform; i++){
+      uniform =    fabs(cp3D[d][i] - 2.0) < 2.0*PLM_UNIFORM_TOL
+                && fabs(cm3D[d][i] - 2.0) < 2.0*PLM_UNIFORM_TOL
+                && fabs(wp3D[d][i] - 1.0) < PLM_UNIFORM_TOL
+                && fabs(wm3D[d][i] - 1.0) < PLM_UNIFORM_TOL
+                && fabs(dp3D[d][i] - 0.5) < 0.5*PLM_UNIFORM_TOL
+                && fabs(dm3D[d][i] - 0.5) < 0.5*PLM_UNIFORM_TOL;
+    }
+    s_uniform[d] = uniform;
+    if (uniform) for (i = beg; i <= end; i++){
+      cp3D[d][i] = cm3D[d][i] = 2.0;
+      wp3D[d][i] = wm3D[d][i] = 1.0;
+      dp3D[d][i] = dm3D[d][i] = 0.5;
+    }
   }
 }
 /* ********************************************************************* */
@@ -91,7 +141,7 @@ void PLM_CoefficientsGet(PLM_Coeffs *plm_coeffs, int dir)
  *
  *********************************************************************** */
 {
-  if (cp3D[0] == NULL) {
+  if (s_table == NULL) {
     printLog ("! PLM_CoefficientsGet(): coefficients not set.\n");
     QUIT_PLUTO(1);
   }
@@ -105,4 +155,5 @@ void PLM_CoefficientsGet(PLM_Coeffs *plm_coeffs, int dir)
   plm_coeffs->dp = dp3D[dir];
   plm_coeffs->dm = dm3D[dir];
 
+  plm_coeffs->uniform = s_uniform[dir];
 }
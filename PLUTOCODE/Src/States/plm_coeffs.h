@@ -8,7 +8,11 @@
   
   The macro ::UNIFORM_CARTESIAN_GRID can be set to YES to 
   enable faster computation when the grid is uniform and Cartesian.
-  In the general case (non-uniform and/or non-Cartesian), set it to NO. 
+  Uniformity is then checked at run time for each direction
+  (PLM_Coeffs::uniform) and the general form of the limiters is used
+  along non-uniform directions.
+  Set it to NO to always use the general (non-uniform and/or 
+  non-Cartesian) expressions.
   
   \authors A. Mignone (mignone@to.infn.it)
   \date    Jan 7, 2019
@@ -42,6 +46,8 @@ typedef struct PLM_COEFFS{
   double *wm;
   double *dp;
   double *dm;
+  int uniform;  /**< 1 if the direction is uniform and Cartesian-like
+                     (cp = cm = 2, wp = wm = 1, dp = dm = 1/2). */
 } PLM_Coeffs;
 
 void PLM_CoefficientsSet(Grid *grid);
@@ -65,7 +71,10 @@ void PLM_CoefficientsGet(PLM_Coeffs*, int);
     Usually \c cp and \c cm are used only for a few limiters and 
     when the grid is either non-uniform or the geometry is not Cartesian.
     For this reason, the OSPRE (OS), van Leer (VL) and monotonized central
-    (MC) are 
+    (MC) are given in two forms: \c SET_XX_LIMITER is valid on any grid
+    while \c SET_XX_LIMITER_UNIFORM is the cheaper expression obtained
+    for cp = cm = 2.
+    The macro ::PLM_LIMIT() picks one of the two at run time.
 */
 
 /*! Set flat (zero slope) reconstruction (also non-uniform). */
@@ -103,33 +112,35 @@ void PLM_CoefficientsGet(PLM_Coeffs*, int);
            Limiters on uniform Cartesian grid
    ------------------------------------------------------------- */
    
-#if UNIFORM_CARTESIAN_GRID == YES 
-
 /*! OSPRE limiter (uniform Cart. grid) */
- #define SET_OS_LIMITER(dv, dvp, dvm, cp, cm)\
+#define SET_OS_LIMITER_UNIFORM(dv, dvp, dvm, cp, cm)\
   dv = ( (dvp)*(dvm) > 0.0? \
        dv = 1.5*(dvp)*(dvm)*((dvm) + (dvp))/((dvp)*(dvp) + (dvm)*(dvm) + (dvp)*(dvm)): 0.0);
 
 /*! Van Leer limiter (uniform Cartesian grid) */
- #define SET_VL_LIMITER(dv, dvp, dvm, cp, cm)\
+#define SET_VL_LIMITER_UNIFORM(dv, dvp, dvm, cp, cm)\
    dv = ( (dvp)*(dvm) > 0.0 ? 2.0*(dvp)*(dvm)/((dvp) + (dvm)) :0.0)
 
 /*! Monotonized central limiter (uniform cart. grid). 
     Here \c cp and \c cm are useless. */
- #define SET_MC_LIMITER(dv, dvp, dvm, cp, cm) \
+#define SET_MC_LIMITER_UNIFORM(dv, dvp, dvm, cp, cm) \
    if ( (dvp)*(dvm) > 0.0) { \
      double _qc  = 0.5*( (dvm) + (dvp) ), _scrh = 2.0*ABS_MIN( (dvp), (dvm) ); \
      dv   = ABS_MIN(_qc, _scrh);  \
    }else dv = 0.0; 
 
+#define SET_FL_LIMITER_UNIFORM  SET_FL_LIMITER
+#define SET_MM_LIMITER_UNIFORM  SET_MM_LIMITER
+#define SET_VA_LIMITER_UNIFORM  SET_VA_LIMITER
+#define SET_UM_LIMITER_UNIFORM  SET_UM_LIMITER
+#define SET_GM_LIMITER_UNIFORM  SET_GM_LIMITER
+
 /* -------------------------------------------------------------
           Limiters on irregular or non-Cartesian grids
    ------------------------------------------------------------- */
    
-#else 
-
 /*! OSPRE limiter (general grid case) */
- #define SET_OS_LIMITER(dv, dvp, dvm, cp, cm)\
+#define SET_OS_LIMITER(dv, dvp, dvm, cp, cm)\
   if (dvp*dvm > 0.0){  \
     double _den = 2.0*(dvp)*(dvp) + 2.0*(dvm)*(dvm) + (cp + cm - 2.0)*(dvp)*(dvm);\
     dv = dvp*dvm*((1.0+cp)*(dvm) + (1.0+cm)*(dvp))/_den; \
@@ -137,19 +148,25 @@ void PLM_CoefficientsGet(PLM_Coeffs*, int);
 
 /* -- van Leer limiter (general grid) -- */
 
- #define SET_VL_LIMITER(dv, dvp, dvm, cp, cm)\
+#define SET_VL_LIMITER(dv, dvp, dvm, cp, cm)\
    dv = (dvp*dvm > 0.0 ? (dvp)*(dvm)*(cp*(dvm) + cm*(dvp)) \
                        /((dvp)*(dvp) + (dvm)*(dvm) + (cp + cm - 2.0)*(dvp)*(dvm)) :0.0)
 
 /* -- monotonized central (general grid) -- */
 
- #define SET_MC_LIMITER(dv, dvp, dvm, cp, cm) \
+#define SET_MC_LIMITER(dv, dvp, dvm, cp, cm) \
    if (dvp*dvm > 0.0) { \
      double _qc  = 0.5*((dvm) + (dvp)), _scrh = ABS_MIN((dvp)*cp, (dvm)*cm); \
      dv   = ABS_MIN(_qc, _scrh);  \
    }else dv = 0.0; 
 
-#endif
+/*! Apply the limiter \c LIM (e.g. ::SET_MC_LIMITER or ::SET_LIMITER)
+    in its uniform-grid form when \c uniform is true and in its
+    general form otherwise. 
+    When \c uniform is a constant the branch is resolved at compile time. */
+#define PLM_LIMIT(LIM, uniform, dv, dvp, dvm, cp, cm) \
+  if (uniform) {LIM##_UNIFORM(dv, dvp, dvm, cp, cm);} \
+  else         {LIM(dv, dvp, dvm, cp, cm);}
 
 /* -------------------------------------------------------------------
     when a single limiter is specified, use SET_LIMITER as
@@ -158,23 +175,31 @@ void PLM_CoefficientsGet(PLM_Coeffs*, int);
 
 #ifdef LIMITER  /* May not be defined when using finite difference schemes */
  #if LIMITER == FLAT_LIM
-  #define SET_LIMITER SET_FL_LIMITER
+  #define SET_LIMITER          SET_FL_LIMITER
+  #define SET_LIMITER_UNIFORM  SET_FL_LIMITER_UNIFORM
  #elif LIMITER == MINMOD_LIM
-  #define SET_LIMITER  SET_MM_LIMITER
+  #define SET_LIMITER          SET_MM_LIMITER
+  #define SET_LIMITER_UNIFORM  SET_MM_LIMITER_UNIFORM
  #elif LIMITER == VANALBADA_LIM
-  #define SET_LIMITER  SET_VA_LIMITER
+  #define SET_LIMITER          SET_VA_LIMITER
+  #define SET_LIMITER_UNIFORM  SET_VA_LIMITER_UNIFORM
  #elif LIMITER == OSPRE_LIM
-  #define SET_LIMITER  SET_OS_LIMITER
+  #define SET_LIMITER          SET_OS_LIMITER
+  #define SET_LIMITER_UNIFORM  SET_OS_LIMITER_UNIFORM
  #elif LIMITER == UMIST_LIM
-  #define SET_LIMITER  SET_UM_LIMITER
+  #define SET_LIMITER          SET_UM_LIMITER
+  #define SET_LIMITER_UNIFORM  SET_UM_LIMITER_UNIFORM
  #elif LIMITER == VANLEER_LIM
-  #define SET_LIMITER  SET_VL_LIMITER
+  #define SET_LIMITER          SET_VL_LIMITER
+  #define SET_LIMITER_UNIFORM  SET_VL_LIMITER_UNIFORM
  #elif LIMITER == MC_LIM
-  #define SET_LIMITER  SET_MC_LIMITER
+  #define SET_LIMITER          SET_MC_LIMITER
+  #define SET_LIMITER_UNIFORM  SET_MC_LIMITER_UNIFORM
  #endif
 #endif
 
 
 #ifndef SET_LIMITER
-  #define SET_LIMITER  SET_VL_LIMITER
+  #define SET_LIMITER          SET_VL_LIMITER
+  #define SET_LIMITER_UNIFORM  SET_VL_LIMITER_UNIFORM
 #endif
@@ -60,6 +60,12 @@
   A stencil of 3 zones is required for all limiters except for
   the FOURTH_ORDER_LIM which requires  5 zones. 
 
+  When ::UNIFORM_CARTESIAN_GRID is enabled, directions that have been
+  flagged as uniform by PLM_CoefficientsSet() are reconstructed by a
+  specialization of the main loop which skips the coefficient loads and
+  uses the cheaper uniform-grid limiters; the choice is made at run
+  time for each sweep.
+
   \author A. Mignone (mignone@to.infn.it)
   \date   July 1, 2019
 
@@ -78,6 +84,8 @@ static void MonotonicityTest(double **, double **, double **, int, int);
 #if LIMITER == FOURTH_ORDER_LIM
 static void FourthOrderLinear(const Sweep *, int, int, Grid *);
 #endif
+static inline void PLM_Limit(const Sweep *, double **, PLM_Coeffs *, int, int,
+                             const int);
 
 /* ********************************************************************* */
 void States (const Sweep *sweep, int beg, int end, Grid *grid)
@@ -103,8 +111,6 @@ void States (const Sweep *sweep, int beg, int end, Grid *grid)
   double **up = stateL->u;
   double **um = stateR->u-1;
 
-  double dv_lim[NVAR], dvp[NVAR], dvm[NVAR];
-  double cp, cm, wp, wm, dp, dm;
   PLM_Coeffs plm_coeffs;
   static double **dv;
 
@@ -126,9 +132,7 @@ void States (const Sweep *sweep, int beg, int end, Grid *grid)
     dv = ARRAY_2D(NMAX_POINT, NVAR, double);
   }
 
-#if UNIFORM_CARTESIAN_GRID == NO
   PLM_CoefficientsGet (&plm_coeffs, g_dir);
-#endif
 
 #if RECONSTRUCT_4VEL == YES
   ConvertTo4vel (v, beg-1, end+1);
@@ -143,32 +147,138 @@ void States (const Sweep *sweep, int beg, int end, Grid *grid)
   }
 
 /* -------------------------------------------
-    2. Main spatial loop
+    2. Main spatial loop: select the uniform
+       grid specialization when possible.
    ------------------------------------------- */
 
+#if UNIFORM_CARTESIAN_GRID == YES
+  if (plm_coeffs.uniform) PLM_Limit (sweep, dv, &plm_coeffs, beg, end, 1);
+  else
+#endif
+  PLM_Limit (sweep, dv, &plm_coeffs, beg, end, 0);
+
+/* ----------------------------------------------
+   3a. Check monotonicity
+   ---------------------------------------------- */ 
+
+#if CHECK_MONOTONICITY == YES
+  MonotonicityTest(v, vp, vm, beg, end);
+#endif
+
+/* ----------------------------------------------
+   3b. Shock flattening 
+   ----------------------------------------------  */
+
+#if SHOCK_FLATTENING == ONED
+  Flatten (sweep, beg, end, grid);
+#endif
+
+/* ----------------------------------------------
+   4.  Assign face-centered magnetic field
+   ----------------------------------------------  */
+
+#ifdef STAGGERED_MHD
+  for (i = beg - 1; i <= end; i++) {
+    vp[i][BXn] = vm[i+1][BXn] = sweep->Bn[i];
+    #if (PHYSICS == ResRMHD) && (DIVE_CONTROL == CONSTRAINED_TRANSPORT)
+    vp[i][EXn] = vm[i+1][EXn] = sweep->En[i];
+    #endif
+  }
+#endif
+
+/* ----------------------------------------------
+   5. Evolve L/R states and center value by dt/2
+   ---------------------------------------------- */
+
+#if TIME_STEPPING == CHARACTERISTIC_TRACING
+  CharTracingStep(sweep, beg, end, grid);
+#elif TIME_STEPPING == HANCOCK && PRIMITIVE_HANCOCK == YES
+  HancockStep(sweep, beg, end, grid);  
+#endif
+
+/* ----------------------------------------------
+   6. Convert back to 3-velocity
+   ---------------------------------------------- */
+
+#if RECONSTRUCT_4VEL
+  ConvertTo3vel (v, beg-1, end+1);
+  ConvertTo3vel (vp, beg, end);
+  ConvertTo3vel (vm, beg, end);
+#endif
+
+/* ----------------------------------------------
+   7. Evolve L/R state and center value by dt/2
+      using conservative Hancock scheme
+      [requires 3-vel in input]
+   ---------------------------------------------- */
+
+#if (TIME_STEPPING == HANCOCK) && (PRIMITIVE_HANCOCK == NO)
+  HancockStep(sweep, beg, end, grid);  
+#endif
+
+/* ----------------------------------------------
+   8. Obtain L/R states in conservative variables
+   ---------------------------------------------- */
+
+  PrimToCons (vp, up, beg, end);
+  PrimToCons (vm, um, beg, end);
+
+}
+
+/* ********************************************************************* */
+void PLM_Limit (const Sweep *sweep, double **dv, PLM_Coeffs *plm_coeffs,
+                int beg, int end, const int uniform)
+/*! 
+ * Compute limited slopes and build the (+) and (-) states for the
+ * primitive-variable reconstruction.
+ * The function is called with a constant \c uniform flag so that the
+ * compiler can produce a uniform-grid specialization (no coefficient
+ * loads, uniform limiter expressions) and a general one.
+ *
+ * \param [in] sweep      pointer to a Sweep structure
+ * \param [in] dv         array of undivided differences
+ * \param [in] plm_coeffs pointer to the PLM_Coeffs structure of the
+ *                        current direction (unused when uniform = 1)
+ * \param [in] beg        starting point where vp and vm must be computed
+ * \param [in] end        final    point where vp and vm must be computed
+ * \param [in] uniform    1 for the uniform-grid specialization, 0 otherwise
+ *
+ ************************************************************************ */
+{
+  int    nv, i;
+  const State *stateC = &(sweep->stateC);
+  const State *stateL = &(sweep->stateL);
+  const State *stateR = &(sweep->stateR);
+  double **v  = stateC->v;
+  double **vp = stateL->v;
+  double **vm = stateR->v-1;
+
+  double dv_lim[NVAR], dvp[NVAR], dvm[NVAR];
+  double cp, cm, wp, wm, dp, dm;
+
   for (i = beg; i <= end; i++){
 
   /* ---------------------------------------------------------
      2a. compute forward (dvp) and backward (dvm) derivatives
      --------------------------------------------------------- */
 
-    #if UNIFORM_CARTESIAN_GRID == YES
-    cp = cm = 2.0;
-    wp = wm = 1.0;
-    dp = dm = 0.5;
-    NVAR_LOOP(nv) {
-      dvp[nv] = dv[i][nv];
-      dvm[nv] = dv[i-1][nv];
-    }
-    #else
-    cp = plm_coeffs.cp[i]; cm = plm_coeffs.cm[i];
-    wp = plm_coeffs.wp[i]; wm = plm_coeffs.wm[i];
-    dp = plm_coeffs.dp[i]; dm = plm_coeffs.dm[i];
-    NVAR_LOOP(nv) {
-      dvp[nv] = dv[i][nv]*wp;
-      dvm[nv] = dv[i-1][nv]*wm;
+    if (uniform){
+      cp = cm = 2.0;
+      wp = wm = 1.0;
+      dp = dm = 0.5;
+      NVAR_LOOP(nv) {
+        dvp[nv] = dv[i][nv];
+        dvm[nv] = dv[i-1][nv];
+      }
+    }else{
+      cp = plm_coeffs->cp[i]; cm = plm_coeffs->cm[i];
+      wp = plm_coeffs->wp[i]; wm = plm_coeffs->wm[i];
+      dp = plm_coeffs->dp[i]; dm = plm_coeffs->dm[i];
+      NVAR_LOOP(nv) {
+        dvp[nv] = dv[i][nv]*wp;
+        dvm[nv] = dv[i-1][nv]*wm;
+      }
     }
-    #endif
 
   /* ---------------------------------------------------------------
      2b. if shock-flattening is enabled, revert to minmod limiter
@@ -197,27 +307,27 @@ void States (const Sweep *sweep, int beg, int end, Grid *grid)
      --------------------------------------------------------- */
 
 #if LIMITER == DEFAULT
-    SET_MC_LIMITER(dv_lim[RHO], dvp[RHO], dvm[RHO], cp, cm);
+    PLM_LIMIT(SET_MC_LIMITER, uniform, dv_lim[RHO], dvp[RHO], dvm[RHO], cp, cm);
     #if PHYSICS != ADVECTION
-    SET_VL_LIMITER(dv_lim[VX1], dvp[VX1], dvm[VX1], cp, cm);
-    SET_VL_LIMITER(dv_lim[VX2], dvp[VX2], dvm[VX2], cp, cm);
-    SET_VL_LIMITER(dv_lim[VX3], dvp[VX3], dvm[VX3], cp, cm);
+    PLM_LIMIT(SET_VL_LIMITER, uniform, dv_lim[VX1], dvp[VX1], dvm[VX1], cp, cm);
+    PLM_LIMIT(SET_VL_LIMITER, uniform, dv_lim[VX2], dvp[VX2], dvm[VX2], cp, cm);
+    PLM_LIMIT(SET_VL_LIMITER, uniform, dv_lim[VX3], dvp[VX3], dvm[VX3], cp, cm);
     #endif
 
     #if (PHYSICS == MHD) || (PHYSICS == RMHD) || (PHYSICS == ResRMHD)
-    SET_VL_LIMITER(dv_lim[BX1], dvp[BX1], dvm[BX1], cp, cm);
-    SET_VL_LIMITER(dv_lim[BX2], dvp[BX2], dvm[BX2], cp, cm);
-    SET_VL_LIMITER(dv_lim[BX3], dvp[BX3], dvm[BX3], cp, cm);
+    PLM_LIMIT(SET_VL_LIMITER, uniform, dv_lim[BX1], dvp[BX1], dvm[BX1], cp, cm);
+    PLM_LIMIT(SET_VL_LIMITER, uniform, dv_lim[BX2], dvp[BX2], dvm[BX2], cp, cm);
+    PLM_LIMIT(SET_VL_LIMITER, uniform, dv_lim[BX3], dvp[BX3], dvm[BX3], cp, cm);
     #if PHYSICS == ResRMHD
-    SET_VL_LIMITER(dv_lim[EX1], dvp[EX1], dvm[EX1], cp, cm);
-    SET_VL_LIMITER(dv_lim[EX2], dvp[EX2], dvm[EX2], cp, cm);
-    SET_VL_LIMITER(dv_lim[EX3], dvp[EX3], dvm[EX3], cp, cm);
+    PLM_LIMIT(SET_VL_LIMITER, uniform, dv_lim[EX1], dvp[EX1], dvm[EX1], cp, cm);
+    PLM_LIMIT(SET_VL_LIMITER, uniform, dv_lim[EX2], dvp[EX2], dvm[EX2], cp, cm);
+    PLM_LIMIT(SET_VL_LIMITER, uniform, dv_lim[EX3], dvp[EX3], dvm[EX3], cp, cm);
     #endif
 
     #ifdef GLM_MHD
-    SET_MC_LIMITER(dv_lim[PSI_GLM], dvp[PSI_GLM], dvm[PSI_GLM], cp, cm);
+    PLM_LIMIT(SET_MC_LIMITER, uniform, dv_lim[PSI_GLM], dvp[PSI_GLM], dvm[PSI_GLM], cp, cm);
     #ifdef PHI_GLM
-    SET_MC_LIMITER(dv_lim[PHI_GLM], dvp[PHI_GLM], dvm[PHI_GLM], cp, cm);
+    PLM_LIMIT(SET_MC_LIMITER, uniform, dv_lim[PHI_GLM], dvp[PHI_GLM], dvm[PHI_GLM], cp, cm);
     #endif
     #endif
     #endif
@@ -227,15 +337,15 @@ void States (const Sweep *sweep, int beg, int end, Grid *grid)
     #endif
       
     #if RADIATION
-    SET_VL_LIMITER(dv_lim[ENR], dvp[ENR], dvm[ENR], cp, cm);
-    SET_VL_LIMITER(dv_lim[FR1], dvp[FR1], dvm[FR1], cp, cm); 
-    SET_VL_LIMITER(dv_lim[FR2], dvp[FR2], dvm[FR2], cp, cm);
-    SET_VL_LIMITER(dv_lim[FR3], dvp[FR3], dvm[FR3], cp, cm);
+    PLM_LIMIT(SET_VL_LIMITER, uniform, dv_lim[ENR], dvp[ENR], dvm[ENR], cp, cm);
+    PLM_LIMIT(SET_VL_LIMITER, uniform, dv_lim[FR1], dvp[FR1], dvm[FR1], cp, cm); 
+    PLM_LIMIT(SET_VL_LIMITER, uniform, dv_lim[FR2], dvp[FR2], dvm[FR2], cp, cm);
+    PLM_LIMIT(SET_VL_LIMITER, uniform, dv_lim[FR3], dvp[FR3], dvm[FR3], cp, cm);
     #endif
  
     #if NFLX != NVAR /* -- scalars: MC lim  -- */
      for (nv = NFLX; nv < NVAR; nv++){
-       SET_MC_LIMITER(dv_lim[nv], dvp[nv], dvm[nv], cp, cm);
+       PLM_LIMIT(SET_MC_LIMITER, uniform, dv_lim[nv], dvp[nv], dvm[nv], cp, cm);
      }
     #endif
 #endif /* LIMITER == DEFAULT */
@@ -246,7 +356,7 @@ void States (const Sweep *sweep, int beg, int end, Grid *grid)
 
     for (nv = 0; nv < NVAR; nv++){
       #if LIMITER != DEFAULT  /* -- same limiter for all variables -- */
-      SET_LIMITER(dv_lim[nv], dvp[nv], dvm[nv], cp, cm);
+      PLM_LIMIT(SET_LIMITER, uniform, dv_lim[nv], dvp[nv], dvm[nv], cp, cm);
       #endif
 
       vp[i][nv] = v[i][nv] + dv_lim[nv]*dp;
@@ -261,73 +371,6 @@ void States (const Sweep *sweep, int beg, int end, Grid *grid)
     VelocityLimiter (v[i], vp[i], vm[i]);
     #endif
   } /* -- end loop on zones -- */
-
-/* ----------------------------------------------
-   3a. Check monotonicity
-   ---------------------------------------------- */ 
-
-#if CHECK_MONOTONICITY == YES
-  MonotonicityTest(v, vp, vm, beg, end);
-#endif
-
-/* ----------------------------------------------
-   3b. Shock flattening 
-   ----------------------------------------------  */
-
-#if SHOCK_FLATTENING == ONED
-  Flatten (sweep, beg, end, grid);
-#endif
-
-/* ----------------------------------------------
-   4.  Assign face-centered magnetic field
-   ----------------------------------------------  */
-
-#ifdef STAGGERED_MHD
-  for (i = beg - 1; i <= end; i++) {
-    vp[i][BXn] = vm[i+1][BXn] = sweep->Bn[i];
-    #if (PHYSICS == ResRMHD) && (DIVE_CONTROL == CONSTRAINED_TRANSPORT)
-    vp[i][EXn] = vm[i+1][EXn] = sweep->En[i];
-    #endif
-  }
-#endif
-
-/* ----------------------------------------------
-   5. Evolve L/R states and center value by dt/2
-   ---------------------------------------------- */
-
-#if TIME_STEPPING == CHARACTERISTIC_TRACING
-  CharTracingStep(sweep, beg, end, grid);
-#elif TIME_STEPPING == HANCOCK && PRIMITIVE_HANCOCK == YES
-  HancockStep(sweep, beg, end, grid);  
-#endif
-
-/* ----------------------------------------------
-   6. Convert back to 3-velocity
-   ---------------------------------------------- */
-
-#if RECONSTRUCT_4VEL
-  ConvertTo3vel (v, beg-1, end+1);
-  ConvertTo3vel (vp, beg, end);
-  ConvertTo3vel (vm, beg, end);
-#endif
-
-/* ----------------------------------------------
-   7. Evolve L/R state and center value by dt/2
-      using conservative Hancock scheme
-      [requires 3-vel in input]
-   ---------------------------------------------- */
-
-#if (TIME_STEPPING == HANCOCK) && (PRIMITIVE_HANCOCK == NO)
-  HancockStep(sweep, beg, end, grid);  
-#endif
-
-/* ----------------------------------------------
-   8. Obtain L/R states in conservative variables
-   ---------------------------------------------- */
-
-  PrimToCons (vp, up, beg, end);
-  PrimToCons (vm, um, beg, end);
-
 }
 
 #if LIMITER == FOURTH_ORDER_LIM
@@ -500,6 +543,7 @@ void States (const Sweep *sweep, int beg, int end,  Grid *grid)
   double **L, **R, *lambda;
   double cp, cm, wp, wm, cpk[NVAR], cmk[NVAR];
   double kstp[NVAR];
+  int    uniform = 0;
   PLM_Coeffs plm_coeffs;
   static double **dv;
 
@@ -515,8 +559,9 @@ void States (const Sweep *sweep, int beg, int end,  Grid *grid)
   FluidInterfaceBoundary(sweep, beg, end, grid);
   #endif
   
-  #if UNIFORM_CARTESIAN_GRID == NO
-   PLM_CoefficientsGet(&plm_coeffs, g_dir);
+  PLM_CoefficientsGet(&plm_coeffs, g_dir);
+  #if UNIFORM_CARTESIAN_GRID == YES
+  uniform = plm_coeffs.uniform;
   #endif
 
 /* ---------------------------------------------
@@ -566,32 +611,32 @@ void States (const Sweep *sweep, int beg, int end,  Grid *grid)
          dw(k) = L(k).dv
      --------------------------------------------------------------- */
 
-    #if UNIFORM_CARTESIAN_GRID == YES
-    cp = cm = 2.0;
-    wp = wm = 1.0;
-    dp = dm = 0.5;
-    NVAR_LOOP(nv) {
-      dvp[nv] = dv[i][nv];
-      dvm[nv] = dv[i-1][nv];
+    if (uniform){
+      cp = cm = 2.0;
+      wp = wm = 1.0;
+      dp = dm = 0.5;
+      NVAR_LOOP(nv) {
+        dvp[nv] = dv[i][nv];
+        dvm[nv] = dv[i-1][nv];
 
-      k = nv;
-      cpk[k] = cmk[k] = kstp[k];
-    }
-    #else
-    cp = plm_coeffs.cp[i]; cm = plm_coeffs.cm[i];
-    wp = plm_coeffs.wp[i]; wm = plm_coeffs.wm[i];
-    dp = plm_coeffs.dp[i]; dm = plm_coeffs.dm[i];
-    NVAR_LOOP(nv) {
-      dvp[nv] = dv[i][nv]*wp;
-      dvm[nv] = dv[i-1][nv]*wm;
-
-    /* -- Map 1 < kstp < 2  ==>  1 < ck < c -- */
-
-      k = nv;
-      cpk[k] = (2.0 - cp) + (cp - 1.0)*kstp[k]; /* used only for general */
-      cmk[k] = (2.0 - cm) + (cm - 1.0)*kstp[k]; /* minmod limiter        */
+        k = nv;
+        cpk[k] = cmk[k] = kstp[k];
+      }
+    }else{
+      cp = plm_coeffs.cp[i]; cm = plm_coeffs.cm[i];
+      wp = plm_coeffs.wp[i]; wm = plm_coeffs.wm[i];
+      dp = plm_coeffs.dp[i]; dm = plm_coeffs.dm[i];
+      NVAR_LOOP(nv) {
+        dvp[nv] = dv[i][nv]*wp;
+        dvm[nv] = dv[i-1][nv]*wm;
+
+      /* -- Map 1 < kstp < 2  ==>  1 < ck < c -- */
+
+        k = nv;
+        cpk[k] = (2.0 - cp) + (cp - 1.0)*kstp[k]; /* used only for general */
+        cmk[k] = (2.0 - cm) + (cm - 1.0)*kstp[k]; /* minmod limiter        */
+      }
     }
-    #endif
 
     PrimToChar(L, dvm, dwm);
     PrimToChar(L, dvp, dwp);
@@ -614,7 +659,7 @@ void States (const Sweep *sweep, int beg, int end,  Grid *grid)
       #if LIMITER == DEFAULT
       SET_GM_LIMITER(dw_lim[k], dwp[k], dwm[k], cpk[k], cmk[k]);
       #else 
-      SET_LIMITER(dw_lim[k], dwp[k], dwm[k], cp, cm);
+      PLM_LIMIT(SET_LIMITER, uniform, dw_lim[k], dwp[k], dwm[k], cp, cm);
       #endif
     }
 
@@ -644,9 +689,9 @@ void States (const Sweep *sweep, int beg, int end,  Grid *grid)
     #if NFLX != NVAR
     for (nv = NFLX; nv < NVAR; nv++ ){
       #if LIMITER == DEFAULT
-      SET_MC_LIMITER(dv_lim[nv], dvp[nv], dvm[nv], cp, cm);
+      PLM_LIMIT(SET_MC_LIMITER, uniform, dv_lim[nv], dvp[nv], dvm[nv], cp, cm);
       #else
-      SET_LIMITER(dv_lim[nv], dvp[nv], dvm[nv], cp, cm);
+      PLM_LIMIT(SET_LIMITER, uniform, dv_lim[nv], dvp[nv], dvm[nv], cp, cm);
       #endif
     }
     #endif
@@ -78,6 +78,9 @@ void InitDomain (Data *d, Grid *grid)
 void Analysis (const Data *d, Grid *grid)
 /*! 
  *  Perform runtime data analysis.
+ *  Sums, averages, extrema and histograms over the domain may be
+ *  registered with DiagAdd() and DiagAddHistogram() and evaluated
+ *  together with DiagCompute() (see diagnostics.c).
  *
  * \param [in] d the PLUTO Data structure
  * \param [in] grid   pointer to array of Grid structures  
@@ -263,6 +263,9 @@ int AdvanceStep (Data *data, timeStep *Dts, Grid *grid)
 
   g_intStage = 1;
   Boundary (data, ALL_DIR, grid);
+#if PARTICLES
+  Particles_BoundaryExchangeEnd(data, grid); /* Complete pending exchange */
+#endif
 
 #if (SHOCK_FLATTENING == MULTID) || (ENTROPY_SWITCH) 
   FlagShock (data, grid);
@@ -557,11 +560,13 @@ int AdvanceStep (Data *data, timeStep *Dts, Grid *grid)
   Vc_pnt = data->Vc;  /* Save pointer */
   data->Vc  = Vc_half;
 
+  PROFILE_BEG(PROF_PARTICLES);
   #if PARTICLES == PARTICLES_CR
   Particles_CR_Update(data, Dts, g_dt, grid);
   #elif PARTICLES == PARTICLES_DUST
   Particles_Dust_Update(data, Dts, g_dt, grid);
   #endif
+  PROFILE_END(PROF_PARTICLES);
 
   data->Vc = Vc_pnt;   /* Restore Pointer */
   #ifdef STAGGERED_MHD
@@ -752,6 +757,7 @@ int AdvanceStep (Data *data, timeStep *Dts, Grid *grid)
                                 * fluid quantities at particle position. */
   Particles_LP_UpdateSpectra (data, g_dt, grid);
   #endif
+  Particles_BoundaryExchangeEnd(data, grid);
   Particles_Inject(data, grid);
 #endif
 
@@ -46,6 +46,9 @@ int AdvanceStep (Data *d, timeStep *Dts, Grid *grid)
   Data_Arr Vpnt;
   static Data_Arr Vhalf;
 #endif
+#if SHOW_TIMING == YES
+  clock_t clock_beg = clock();
+#endif
 
   RBoxDefine (IBEG, IEND, JBEG, JEND, KBEG, KEND, CENTER, &box);
 
@@ -111,6 +114,9 @@ int AdvanceStep (Data *d, timeStep *Dts, Grid *grid)
   ConsToPrim3D (d->Uc, d->Vc, d->flag, &box);
   #endif
   Boundary (d, ALL_DIR, grid);
+  #if PARTICLES
+  Particles_BoundaryExchangeEnd(d, grid); /* Complete pending exchange */
+  #endif
   #if (SHOCK_FLATTENING == MULTID) || (ENTROPY_SWITCH) 
   FlagShock (d, grid);
   #endif
@@ -177,11 +183,13 @@ int AdvanceStep (Data *d, timeStep *Dts, Grid *grid)
   NVAR_LOOP(nv) TOT_LOOP(k,j,i) Vhalf[nv][k][j][i] += 0.5*d->Vc[nv][k][j][i];
   Vpnt  = d->Vc;  /* Save pointer */
   d->Vc = Vhalf;
+  PROFILE_BEG(PROF_PARTICLES);
   #if PARTICLES == PARTICLES_CR
   Particles_CR_Update(d, Dts, g_dt, grid);
   #elif PARTICLES == PARTICLES_DUST
   Particles_Dust_Update(d, Dts, g_dt, grid);
   #endif
+  PROFILE_END(PROF_PARTICLES);
   d->Vc = Vpnt;   /* Restore Pointer */
 #endif  /* PARTICLES_XX_FEEDBACK */
   
@@ -195,6 +203,9 @@ int AdvanceStep (Data *d, timeStep *Dts, Grid *grid)
 
   g_intStage = 2;
   Boundary (d, ALL_DIR, grid);
+  #if PARTICLES
+  Particles_BoundaryExchangeEnd(d, grid); /* Complete pending exchange */
+  #endif
 
 /* -- 2b. Advance paticles & solution array -- */
   
@@ -299,11 +310,13 @@ int AdvanceStep (Data *d, timeStep *Dts, Grid *grid)
   NVAR_LOOP(nv) DOM_LOOP(k,j,i) Vhalf[nv][k][j][i] += 0.5*d->Vc[nv][k][j][i];
   Vpnt  = d->Vc;  /* Save pointer */
   d->Vc = Vhalf;
+  PROFILE_BEG(PROF_PARTICLES);
   #if PARTICLES == PARTICLES_CR
   Particles_CR_Update(d, Dts, g_dt, grid);
   #elif PARTICLES == PARTICLES_DUST
   Particles_Dust_Update(d, Dts, g_dt, grid);
   #endif
+  PROFILE_END(PROF_PARTICLES);
   d->Vc = Vpnt;   /* Restore Pointer */
 #endif  /* PARTICLES */
 
@@ -317,9 +330,14 @@ int AdvanceStep (Data *d, timeStep *Dts, Grid *grid)
                                 * fluid quantities at particle position. */
   Particles_LP_UpdateSpectra (d, g_dt, grid);
   #endif
+  Particles_BoundaryExchangeEnd(d, grid);
   Particles_Inject(d,grid);
 #endif
 
+#if SHOW_TIMING == YES
+  Dts->clock_hyp = (double)(clock() - clock_beg)/CLOCKS_PER_SEC;
+#endif
+
   return 0; /* -- step has been achieved, return success -- */
 }
 
@@ -87,22 +87,26 @@ void UpdateStage(Data *d, Data_Arr Uc, Data_Arr Us, double **aflux,
   #endif
 
 /* --------------------------------------------------------
-   1. Compute Fcr force only at predictor step
-      (g_intStage == 1).
+   1. Update the turbulent forcing every StirFreq steps at
+      the predictor stage (g_intStage == 1). The field is
+      also recomputed when the OU state has been reset
+      (start and restart).
    -------------------------------------------------------- */
 
 #if FORCED_TURB == YES
   ForcedTurb *Ft;
   Ft = d->Ft;
 
-/* Force only at every St_Decay Time interval */
-
-  if(g_stepNumber%Ft->StirFreq == 0 ? 1:0){
+  if (g_intStage == 1 && g_stepNumber%Ft->StirFreq == 0){
     ForcedTurb_OUNoiseUpdate(Ft->OUPhases, 6*(Ft->NModes), Ft->OUVar,
                              Ft->StirFreq*dt, Ft->StirDecay);
     ForcedTurb_CalcPhases(Ft);
     ForcedTurb_ComputeAcceleration(Ft, grid);
+    #if FT_ENERGY_CONTROL == YES
+    ForcedTurb_EnergyControl(Ft, d, Ft->StirFreq*dt, grid);
+    #endif
   }
+  if (!Ft->AccValid) ForcedTurb_ComputeAcceleration(Ft, grid);
 #endif
 
 /* --------------------------------------------------------
@@ -126,6 +130,7 @@ void UpdateStage(Data *d, Data_Arr Uc, Data_Arr Us, double **aflux,
     #if !INCLUDE_JDIR
     if (g_dir == JDIR) continue;
     #endif
+    PROFILE_BEG(PROF_UPDATE_X1 + g_dir);
 
   /* -- 2b. Set integration box for current update -- */
 
@@ -152,6 +157,14 @@ void UpdateStage(Data *d, Data_Arr Uc, Data_Arr Us, double **aflux,
     nend = *sweepBox.nend;
     BOX_TRANSVERSE_LOOP(&sweepBox, k,j,i){
 
+    /* -- Skip rows of inactive tiles, trim the others -- */
+
+      #if ACTIVE_TILES == YES
+      nbeg = *sweepBox.nbeg;
+      nend = *sweepBox.nend;
+      if (!ActiveTilesRow (g_dir, k, j, i, &nbeg, &nend)) continue;
+      #endif
+
     /* ----------------------------------------------------
        2a. Copy data to 1D arrays
        ---------------------------------------------------- */
@@ -257,7 +270,9 @@ void UpdateStage(Data *d, Data_Arr Uc, Data_Arr Us, double **aflux,
        ---------------------------------------------------- */
       
       CheckNaN (stateC->v, 0, ntot-1, "stateC->v");
+      PROFILE_BEG(PROF_STATES);
       States  (&sweep, nbeg - 1, nend + 1, grid);
+      PROFILE_END(PROF_STATES);
 
       #if (RING_AVERAGE > 1) && (GEOMETRY == POLAR)
       if (g_dir == JDIR) RingAverageReconstruct(&sweep, nbeg-1, nend+1, grid);
@@ -273,10 +288,12 @@ CheckNaN (stateR->v, nbeg, nend, "StateR->v");
        2c. Solve Riemann problem
        ---------------------------------------------------- */
 
+      PROFILE_BEG(PROF_RIEMANN);
       d->fluidRiemannSolver (&sweep, nbeg-1, nend, Dts->cmax, grid);
       #if NSCL > 0
       AdvectFlux (&sweep, nbeg-1, nend, grid);
       #endif
+      PROFILE_END(PROF_RIEMANN);
 
       #if RADIATION
       d->radiationRiemannSolver (&sweep, nbeg-1, nend, Dts->cmax, grid); 
@@ -296,12 +313,12 @@ CheckNaN (stateR->v, nbeg, nend, "StateR->v");
        2d. Compute right hand side side
        ---------------------------------------------------- */
 
+      PROFILE_BEG(PROF_RHS);
       RightHandSide (&sweep, Dts, nbeg, nend, dt, grid);
+      PROFILE_END(PROF_RHS);
 
       #if FORCED_TURB == YES
-      if (g_stepNumber%Ft->StirFreq == 0 ? 1:0){
-        ForcedTurb_CorrectRHS(d, &sweep, nbeg, nend, dt,  grid);
-      }  
+      ForcedTurb_CorrectRHS(d, &sweep, nbeg, nend, dt, grid);
       #endif
 
     /* ----------------------------------------------------
@@ -367,6 +384,7 @@ CheckNaN (stateR->v, nbeg, nend, "StateR->v");
       }
       #endif
     }
+    PROFILE_END(PROF_UPDATE_X1 + g_dir);
   }
 
 /* --------------------------------------------------------
@@ -434,7 +452,11 @@ CheckNaN (stateR->v, nbeg, nend, "StateR->v");
 
 #if DIMENSIONS > 1
   if (g_intStage == 1){
+    #if ACTIVE_TILES == YES
+    Dts->invDt_hyp = MAX(Dts->invDt_hyp, ActiveTilesInvDt(C_dt));
+    #else
     DOM_LOOP(k,j,i) Dts->invDt_hyp = MAX(Dts->invDt_hyp, C_dt[k][j][i]);
+    #endif
     Dts->invDt_hyp /= (double)(INCLUDE_IDIR + INCLUDE_JDIR + INCLUDE_KDIR);
   }
 #endif
@@ -0,0 +1,479 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Skip quiescent regions of the domain with block activity masks.
+
+  When \c ACTIVE_TILES is set to \c YES in definitions.h, the local
+  domain of each processor is divided into tiles of
+  \c ACTIVE_TILE_SIZE zones per direction.
+  Before each step, ActiveTilesUpdate() compares the primitive variables
+  of every tile with a reference copy taken the last time the tile was
+  found to change.
+  A tile is \e idle when none of its zones has changed by more than
+  \c ACTIVE_TILE_TOL (relative) for \c ACTIVE_TILE_NSTEP steps, and it
+  is \e inactive when it and all of its neighbours (including those
+  belonging to adjacent processors) are idle.
+  Inactive tiles are skipped by UpdateStage(), by the non-Grackle
+  CoolingSource() and, when a whole side of the domain is inactive,
+  by Boundary().
+  A tile is reactivated at the first step following a change in one of
+  its neighbours.
+
+  This is a generalization of SetJetDomain() to arbitrary quiescent
+  regions and, like that, it is an approximation: processes slower
+  than \c ACTIVE_TILE_TOL per \c ACTIVE_TILE_NSTEP steps are frozen
+  inside inactive tiles and the flux through the border of an
+  inactive tile is not applied to the tile itself, so that
+  conservation holds only to \c ACTIVE_TILE_TOL.
+  Tiles containing zones flagged with ::FLAG_INTERNAL_BOUNDARY or
+  touching a \c USERDEF or \c POLARAXIS boundary are always active.
+  The reference copy doubles the memory needed by \c d->Vc.
+
+  \note Sweeps are restricted to the span between the first and the
+        last active tile of each row, so inactive tiles lying between
+        two active ones are still updated (but not cooled).
+
+  \date   Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+
+#ifndef ACTIVE_TILE_SIZE
+  #define ACTIVE_TILE_SIZE   8     /**< Number of zones per tile and direction */
+#endif
+
+#ifndef ACTIVE_TILE_NSTEP
+  #define ACTIVE_TILE_NSTEP  5     /**< Number of steps without changes before
+                                        a tile becomes idle */
+#endif
+
+#ifndef ACTIVE_TILE_TOL
+  #define ACTIVE_TILE_TOL    1.e-8 /**< Relative change regarded as significant */
+#endif
+
+#if ACTIVE_TILES == YES
+  #if DIMENSIONS == 1
+    #error ACTIVE_TILES requires DIMENSIONS > 1
+  #endif
+  #if (defined STAGGERED_MHD) || (defined CHOMBO) || (defined FARGO) \
+      || (defined SHEARINGBOX)
+    #error ACTIVE_TILES not compatible with CT, AMR, FARGO or shearing box
+  #endif
+#endif
+
+#define TILE_LOOP(tk,tj,ti)  for (tk = 0; tk < s_nt[KDIR]; tk++) \
+                             for (tj = 0; tj < s_nt[JDIR]; tj++) \
+                             for (ti = 0; ti < s_nt[IDIR]; ti++)
+
+static int s_nt[3];      /* Number of tiles in each direction   */
+static int s_ts[3];      /* Tile size in each direction          */
+static int s_beg[3];     /* First interior zone in each direction */
+static int s_end[3];     /* Last interior zone in each direction  */
+static int ***s_idle;    /* Steps since the last change of a tile */
+static unsigned char ***s_active = NULL;
+static double ***s_invDt;   /* Last inverse time step of each tile  */
+static double ***s_flag;    /* Idle flag of each zone (with ghosts) */
+static double ****s_Vref;   /* Reference copy of d->Vc              */
+
+static void TileBox (int, int, int, int *, int *);
+static int  TileChanged (const Data *, int *, int *);
+static void FillGhostFlags (Grid *);
+static int  SideActive (int);
+
+/* ********************************************************************* */
+void ActiveTilesUpdate (const Data *d, int log_freq, Grid *grid)
+/*!
+ * Update the idle counter of each tile by comparing the current
+ * solution with the reference copy, and set the active tiles for the
+ * next step.
+ * Collective on MPI_COMM_WORLD.
+ *
+ * \param [in]     d         pointer to Data structure
+ * \param [in]     log_freq  the output log frequency
+ * \param [in]     grid      pointer to Grid structure
+ *
+ *********************************************************************** */
+{
+  int nv, i, j, k, ti, tj, tk;
+  int b[3], e[3], dir;
+  long int nact;
+
+/* --------------------------------------------------------
+   0. Allocate memory and mark all tiles as active at the
+      first call.
+   -------------------------------------------------------- */
+
+  if (s_active == NULL){
+    s_beg[IDIR] = IBEG; s_end[IDIR] = IEND;
+    s_beg[JDIR] = JBEG; s_end[JDIR] = JEND;
+    s_beg[KDIR] = KBEG; s_end[KDIR] = KEND;
+    for (dir = 0; dir < 3; dir++){
+      s_ts[dir] = (dir < DIMENSIONS ? ACTIVE_TILE_SIZE:1);
+      s_nt[dir] = (s_end[dir] - s_beg[dir] + s_ts[dir])/s_ts[dir];
+    }
+    if (ACTIVE_TILE_SIZE < GetNghost()){
+      print ("! ActiveTilesUpdate(): ACTIVE_TILE_SIZE must be >= %d\n",
+              GetNghost());
+      QUIT_PLUTO(1);
+    }
+
+    s_idle   = ARRAY_3D(s_nt[KDIR], s_nt[JDIR], s_nt[IDIR], int);
+    s_active = ARRAY_3D(s_nt[KDIR], s_nt[JDIR], s_nt[IDIR], unsigned char);
+    s_invDt  = ARRAY_3D(s_nt[KDIR], s_nt[JDIR], s_nt[IDIR], double);
+    s_flag   = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, double);
+    s_Vref   = ARRAY_4D(NVAR, NX3_TOT, NX2_TOT, NX1_TOT, double);
+
+    TILE_LOOP(tk,tj,ti){
+      s_idle[tk][tj][ti]   = 0;
+      s_active[tk][tj][ti] = 1;
+      s_invDt[tk][tj][ti]  = 0.0;
+    }
+    NVAR_LOOP(nv) DOM_LOOP(k,j,i) s_Vref[nv][k][j][i] = d->Vc[nv][k][j][i];
+    print ("> ActiveTilesUpdate(): %d x %d x %d tiles per processor\n",
+            s_nt[IDIR], s_nt[JDIR], s_nt[KDIR]);
+    return;
+  }
+
+/* --------------------------------------------------------
+   1. Update idle counters. The reference copy of a tile
+      is refreshed every time a change is detected.
+   -------------------------------------------------------- */
+
+  TILE_LOOP(tk,tj,ti){
+    TileBox (tk, tj, ti, b, e);
+    if (TileChanged (d, b, e)){
+      s_idle[tk][tj][ti] = 0;
+      NVAR_LOOP(nv){
+        for (k = b[KDIR]; k <= e[KDIR]; k++){
+        for (j = b[JDIR]; j <= e[JDIR]; j++){
+        for (i = b[IDIR]; i <= e[IDIR]; i++){
+          s_Vref[nv][k][j][i] = d->Vc[nv][k][j][i];
+        }}}
+      }
+    }else if (s_idle[tk][tj][ti] < ACTIVE_TILE_NSTEP){
+      s_idle[tk][tj][ti]++;
+    }
+  }
+
+/* --------------------------------------------------------
+   2. Copy the tile flag (1 = not idle) to all of its zones
+      and exchange ghost zones so that tiles on
+      neighbouring processors can be seen.
+   -------------------------------------------------------- */
+
+  TILE_LOOP(tk,tj,ti){
+    double flag = (double)(s_idle[tk][tj][ti] < ACTIVE_TILE_NSTEP);
+
+    TileBox (tk, tj, ti, b, e);
+    for (k = b[KDIR]; k <= e[KDIR]; k++){
+    for (j = b[JDIR]; j <= e[JDIR]; j++){
+    for (i = b[IDIR]; i <= e[IDIR]; i++){
+      s_flag[k][j][i] = flag;
+    }}}
+  }
+  FillGhostFlags (grid);
+
+/* --------------------------------------------------------
+   3. A tile is active if any zone of the tile enlarged by
+      one zone in each direction is not idle.
+   -------------------------------------------------------- */
+
+  nact = 0;
+  TILE_LOOP(tk,tj,ti){
+    int active = 0;
+
+    TileBox (tk, tj, ti, b, e);
+    DIM_EXPAND(b[IDIR]--; e[IDIR]++;  ,
+               b[JDIR]--; e[JDIR]++;  ,
+               b[KDIR]--; e[KDIR]++;)
+    for (k = b[KDIR]; k <= e[KDIR] && !active; k++){
+    for (j = b[JDIR]; j <= e[JDIR] && !active; j++){
+    for (i = b[IDIR]; i <= e[IDIR]; i++){
+      if (s_flag[k][j][i] > 0.5) {
+        active = 1;
+        break;
+      }
+    }}}
+    s_active[tk][tj][ti] = active;
+    nact += active;
+  }
+
+  if (g_stepNumber%log_freq == 0){
+    long int ntiles = (long int)s_nt[IDIR]*s_nt[JDIR]*s_nt[KDIR];
+    #ifdef PARALLEL
+    long int nloc[2] = {nact, ntiles}, nglob[2];
+    MPI_Allreduce (nloc, nglob, 2, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+    nact   = nglob[0];
+    ntiles = nglob[1];
+    #endif
+    print ("> Active tiles: %ld/%ld (%4.1f%%)\n", nact, ntiles,
+            100.0*nact/(double)ntiles);
+  }
+}
+
+/* ********************************************************************* */
+int ActiveTilesRow (int dir, int k, int j, int i, int *nbeg, int *nend)
+/*!
+ * Restrict the integration range of a 1D sweep to the span of
+ * active tiles.
+ *
+ * \param [in]     dir   the sweep direction
+ * \param [in]     k,j,i indices of a zone of the row (the index along
+ *                       \c dir is ignored)
+ * \param [in,out] nbeg  on input, the first zone of the sweep; on
+ *                       output the first zone of the first active tile
+ * \param [in,out] nend  on input, the last zone of the sweep; on
+ *                       output the last zone of the last active tile
+ *
+ * \return 1 if the row contains at least one active tile, 0 otherwise.
+ *********************************************************************** */
+{
+  int t[3], n, n0, n1;
+
+  if (s_active == NULL) return 1;
+
+  t[IDIR] = (i - s_beg[IDIR])/s_ts[IDIR];
+  t[JDIR] = (j - s_beg[JDIR])/s_ts[JDIR];
+  t[KDIR] = (k - s_beg[KDIR])/s_ts[KDIR];
+
+  n0 = -1;
+  n1 = -2;
+  for (n = 0; n < s_nt[dir]; n++){
+    t[dir] = n;
+    if (s_active[t[KDIR]][t[JDIR]][t[IDIR]]){
+      if (n0 < 0) n0 = n;
+      n1 = n;
+    }
+  }
+  if (n0 < 0) return 0;
+
+  *nbeg = MAX(*nbeg, s_beg[dir] + n0*s_ts[dir]);
+  *nend = MIN(*nend, s_beg[dir] + (n1 + 1)*s_ts[dir] - 1);
+  return (*nbeg <= *nend);
+}
+
+/* ********************************************************************* */
+int ActiveTilesCell (int k, int j, int i)
+/*!
+ * Return 1 if the interior zone (i,j,k) belongs to an active tile,
+ * 0 otherwise.
+ *
+ *********************************************************************** */
+{
+  if (s_active == NULL) return 1;
+  return s_active[(k - s_beg[KDIR])/s_ts[KDIR]]
+                 [(j - s_beg[JDIR])/s_ts[JDIR]]
+                 [(i - s_beg[IDIR])/s_ts[IDIR]];
+}
+
+/* ********************************************************************* */
+int ActiveTilesBoundary (int side, int type)
+/*!
+ * Return 0 when the physical boundary condition \c type on the given
+ * \c side of the domain does not need to be recomputed, i.e., when
+ * the ghost zones are a function of inactive zones only.
+ *
+ *********************************************************************** */
+{
+  if (s_active == NULL) return 1;
+
+  if (   type == OUTFLOW      || type == REFLECTIVE
+      || type == AXISYMMETRIC || type == EQTSYMMETRIC){
+    return SideActive(side);
+  }
+
+  if (type == PERIODIC){  /* Ghost zones are copied from the opposite side */
+    return SideActive(side + ((side - X1_BEG)%2 == 0 ? 1:-1));
+  }
+  return 1;
+}
+
+/* ********************************************************************* */
+double ActiveTilesInvDt (double ***C_dt)
+/*!
+ * Return the maximum inverse time step of the local domain.
+ * The value of active tiles is computed from \c C_dt, while inactive
+ * tiles retain the one of the last step in which they were active.
+ *
+ *********************************************************************** */
+{
+  int i, j, k, ti, tj, tk;
+  int b[3], e[3];
+  double invDt = 0.0;
+
+  if (s_active == NULL){
+    DOM_LOOP(k,j,i) invDt = MAX(invDt, C_dt[k][j][i]);
+    return invDt;
+  }
+
+  TILE_LOOP(tk,tj,ti){
+    if (s_active[tk][tj][ti]){
+      double tile_invDt = 0.0;
+
+      TileBox (tk, tj, ti, b, e);
+      for (k = b[KDIR]; k <= e[KDIR]; k++){
+      for (j = b[JDIR]; j <= e[JDIR]; j++){
+      for (i = b[IDIR]; i <= e[IDIR]; i++){
+        tile_invDt = MAX(tile_invDt, C_dt[k][j][i]);
+      }}}
+      s_invDt[tk][tj][ti] = tile_invDt;
+    }
+    invDt = MAX(invDt, s_invDt[tk][tj][ti]);
+  }
+  return invDt;
+}
+
+/* ********************************************************************* */
+void TileBox (int tk, int tj, int ti, int *b, int *e)
+/*!
+ * Compute the first (b) and last (e) interior zones of a tile.
+ *
+ *********************************************************************** */
+{
+  int dir, t[3] = {ti, tj, tk};
+
+  for (dir = 0; dir < 3; dir++){
+    b[dir] = s_beg[dir] + t[dir]*s_ts[dir];
+    e[dir] = MIN(b[dir] + s_ts[dir] - 1, s_end[dir]);
+  }
+}
+
+/* ********************************************************************* */
+int TileChanged (const Data *d, int *b, int *e)
+/*!
+ * Return 1 if any zone of the tile differs from the reference copy by
+ * more than ACTIVE_TILE_TOL or belongs to an internal boundary.
+ * Velocity and magnetic field are compared in magnitude and normalized
+ * to the local fast speed scale, the other variables are compared
+ * individually.
+ *
+ *********************************************************************** */
+{
+  int nv, i, j, k;
+  double tol2 = ACTIVE_TILE_TOL*ACTIVE_TILE_TOL;
+  double dv2, v2, cs2, dq;
+  double ****V = d->Vc, ****R = s_Vref;
+  #if (PHYSICS == MHD) || (PHYSICS == RMHD)
+  double dB2, B2;
+  #endif
+
+  for (k = b[KDIR]; k <= e[KDIR]; k++){
+  for (j = b[JDIR]; j <= e[JDIR]; j++){
+  for (i = b[IDIR]; i <= e[IDIR]; i++){
+
+    #if INTERNAL_BOUNDARY == YES
+    if (d->flag[k][j][i] & FLAG_INTERNAL_BOUNDARY) return 1;
+    #endif
+
+    #if HAVE_ENERGY
+    cs2 = fabs(R[PRS][k][j][i]/R[RHO][k][j][i]);
+    #elif EOS == ISOTHERMAL
+    cs2 = g_isoSoundSpeed*g_isoSoundSpeed;
+    #else
+    cs2 = 0.0;
+    #endif
+
+    dv2 = v2 = 0.0;
+    DIM_EXPAND(dq   = V[VX1][k][j][i] - R[VX1][k][j][i];
+               dv2 += dq*dq; v2 += R[VX1][k][j][i]*R[VX1][k][j][i];  ,
+               dq   = V[VX2][k][j][i] - R[VX2][k][j][i];
+               dv2 += dq*dq; v2 += R[VX2][k][j][i]*R[VX2][k][j][i];  ,
+               dq   = V[VX3][k][j][i] - R[VX3][k][j][i];
+               dv2 += dq*dq; v2 += R[VX3][k][j][i]*R[VX3][k][j][i];)
+    if (dv2 > tol2*(v2 + cs2)) return 1;
+
+    #if (PHYSICS == MHD) || (PHYSICS == RMHD)
+    dB2 = B2 = 0.0;
+    DIM_EXPAND(dq   = V[BX1][k][j][i] - R[BX1][k][j][i];
+               dB2 += dq*dq; B2 += R[BX1][k][j][i]*R[BX1][k][j][i];  ,
+               dq   = V[BX2][k][j][i] - R[BX2][k][j][i];
+               dB2 += dq*dq; B2 += R[BX2][k][j][i]*R[BX2][k][j][i];  ,
+               dq   = V[BX3][k][j][i] - R[BX3][k][j][i];
+               dB2 += dq*dq; B2 += R[BX3][k][j][i]*R[BX3][k][j][i];)
+    if (dB2 > tol2*(B2 + R[RHO][k][j][i]*cs2)) return 1;
+    #endif
+
+    NVAR_LOOP(nv){
+      DIM_EXPAND(if (nv == VX1) continue;  ,
+                 if (nv == VX2) continue;  ,
+                 if (nv == VX3) continue;)
+      #if (PHYSICS == MHD) || (PHYSICS == RMHD)
+      DIM_EXPAND(if (nv == BX1) continue;  ,
+                 if (nv == BX2) continue;  ,
+                 if (nv == BX3) continue;)
+      #endif
+      dq = V[nv][k][j][i] - R[nv][k][j][i];
+      if (fabs(dq) > ACTIVE_TILE_TOL*fabs(R[nv][k][j][i])) return 1;
+    }
+  }}}
+  return 0;
+}
+
+/* ********************************************************************* */
+void FillGhostFlags (Grid *grid)
+/*!
+ * Fill the ghost zones of the idle flag array.
+ * Internal boundaries are exchanged between processors as in
+ * Boundary(); physical boundaries are set to 1 (always active) for
+ * USERDEF and POLARAXIS and to 0 otherwise, since ghost zones are then
+ * a function of the adjacent interior zones.
+ *
+ *********************************************************************** */
+{
+  int  i, j, k, is, type;
+  int  side[6] = {X1_BEG, X1_END, X2_BEG, X2_END, X3_BEG, X3_END};
+  int  par_dim[3] = {0, 0, 0};
+  int  ib, ie, jb, je, kb, ke;
+  RBox box;
+
+  DIM_EXPAND(par_dim[0] = grid->nproc[IDIR] > 1;  ,
+             par_dim[1] = grid->nproc[JDIR] > 1;  ,
+             par_dim[2] = grid->nproc[KDIR] > 1;)
+
+#ifdef PARALLEL
+  AL_Exchange_dim ((char *)s_flag[0][0], par_dim, SZ);
+#endif
+
+  for (is = 0; is < 2*DIMENSIONS; is++){
+    type = (is%2 == 0 ? grid->lbound[is/2]:grid->rbound[is/2]);
+    if (type == 0) continue;
+
+    ib = 0; ie = NX1_TOT-1;
+    jb = 0; je = NX2_TOT-1;
+    kb = 0; ke = NX3_TOT-1;
+    if      (side[is] == X1_BEG) {ib = 0;      ie = IBEG-1;}
+    else if (side[is] == X1_END) {ib = IEND+1; ie = NX1_TOT-1;}
+    else if (side[is] == X2_BEG) {jb = 0;      je = JBEG-1;}
+    else if (side[is] == X2_END) {jb = JEND+1; je = NX2_TOT-1;}
+    else if (side[is] == X3_BEG) {kb = 0;      ke = KBEG-1;}
+    else if (side[is] == X3_END) {kb = KEND+1; ke = NX3_TOT-1;}
+    RBoxDefine (ib, ie, jb, je, kb, ke, CENTER, &box);
+
+    if (type == PERIODIC){
+      if (!par_dim[is/2]) PeriodicBoundary (s_flag, &box, side[is]);
+    }else{
+      double flag = (double)(type == USERDEF || type == POLARAXIS);
+      BOX_LOOP(&box,k,j,i) s_flag[k][j][i] = flag;
+    }
+  }
+}
+
+/* ********************************************************************* */
+int SideActive (int side)
+/*!
+ * Return 1 if any tile adjacent to the given side of the local domain
+ * is active.
+ *
+ *********************************************************************** */
+{
+  int ti, tj, tk, dir, t;
+
+  dir = (side - X1_BEG)/2;
+  t   = ((side - X1_BEG)%2 == 0 ? 0:s_nt[dir]-1);
+  TILE_LOOP(tk,tj,ti){
+    if ( (dir == IDIR && ti != t) || (dir == JDIR && tj != t)
+      || (dir == KDIR && tk != t)) continue;
+    if (s_active[tk][tj][ti]) return 1;
+  }
+  return 0;
+}
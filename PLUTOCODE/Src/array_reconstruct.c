@@ -77,7 +77,7 @@ void ArrayReconstruct(double ***Q, char *flag, int i, int j, int k, int dir,
       else if (rec == VANLEER_LIM) dq = VANLEER_LIMITER(dqp, dqm);
       else if (rec == MC_LIM)      dq = MC_LIMITER(dqp, dqm);
       else{
-        SET_LIMITER (dq, dqp, dqm, 2.0, 2.0);
+        SET_LIMITER_UNIFORM (dq, dqp, dqm, 2.0, 2.0);
       }
       qL[n]   = qfwd[n] + 0.5*dq;
       qR[n-1] = qfwd[n] - 0.5*dq;
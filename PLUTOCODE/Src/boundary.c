@@ -85,6 +85,8 @@ void Boundary (const Data *d, int idim, Grid *grid)
 
   RBox center_box, x1face_box, x2face_box, x3face_box;
 
+  PROFILE_BEG(PROF_BOUNDARY);
+
 /* --------------------------------------------------------
    0. Check the number of processors in each direction
    -------------------------------------------------------- */
@@ -160,6 +162,9 @@ void Boundary (const Data *d, int idim, Grid *grid)
 
     if (type[is] == 0) continue;  /* No physical boundary or non-active  *
                                    * dimension: skip                     */
+    #if ACTIVE_TILES == YES
+    if (!ActiveTilesBoundary (side[is], type[is])) continue; /* Quiescent side */
+    #endif
   /* ------------------------------------------------------
      5. Define boundary boxes, sweeping direction. 
      ------------------------------------------------------ */
@@ -464,6 +469,7 @@ void Boundary (const Data *d, int idim, Grid *grid)
   CT_ComputeCharge (d, &center_box, grid);
 #endif
 
+  PROFILE_END(PROF_BOUNDARY);
 }
 
 /* ********************************************************************* */
@@ -0,0 +1,658 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Registered in-situ diagnostics.
+
+  Diagnostics are declared once (typically at the first call of
+  Analysis()) with DiagAdd() or DiagAddHistogram() and then evaluated
+  together by DiagCompute().
+  The available reductions are
+  - ::DIAG_SUM:  \f$ \sum w q \f$;
+  - ::DIAG_MEAN: \f$ \sum w q / \sum w \f$;
+  - ::DIAG_MIN, ::DIAG_MAX: extrema of \f$ q \f$ (the weight is ignored);
+  - ::DIAG_HIST: 1D or 2D histogram of \f$ w \f$, with linear or
+    logarithmic bins (e.g. a mass-weighted temperature-density phase
+    diagram).
+
+  The weight \f$ w \f$ is 1 (::DIAG_WEIGHT_NONE), \f$ dV \f$
+  (::DIAG_WEIGHT_VOLUME) or \f$ \rho dV \f$ (::DIAG_WEIGHT_MASS).
+  A quantity \f$ q \f$ is a primitive variable (0 ... NVAR-1), a Grackle
+  field (::DIAG_VGRAC(TEMP), ::DIAG_VGRAC(MU), ::DIAG_VGRAC(TCOOL)), the
+  constant ::DIAG_UNIT or a user-defined field registered with
+  DiagFieldFunction().
+
+  DiagCompute() sweeps the domain once, one row at a time: user fields
+  and weights are computed for the whole row and every diagnostic is
+  then accumulated with a simple loop over the row.
+  Partial results are packed in a single buffer and combined with one
+  MPI_Allreduce().
+  Results are returned by DiagGet() / DiagGetHistogram() and, on
+  processor 0, appended to an internal buffer of \c DIAG_BUFFER_ROWS
+  records which is written to "diagnostics.bin" in the output directory
+  when full and by DiagFlush().
+
+  "diagnostics.bin" begins with an ASCII header made of lines starting
+  with '#' and ending with the line "# end"; each line "# col" gives the
+  first column, the number of columns and the name of one quantity.
+  The header is followed by records of \c ncol native-endian doubles:
+  time, step number and then the diagnostics in order of registration
+  (histograms take nx*ny columns, x running fastest).
+  The file is created when the run starts from step 0 and appended to
+  on restart, after DiagRestart() has discarded the records written
+  past the restart step.
+
+  \date   Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+#include <unistd.h>
+
+#ifndef DIAG_MAX_NUMBER
+  #define DIAG_MAX_NUMBER   32  /**< Max number of diagnostics */
+#endif
+
+#ifndef DIAG_MAX_FUNC
+  #define DIAG_MAX_FUNC     8   /**< Max number of user-defined fields */
+#endif
+
+#ifndef DIAG_BUFFER_ROWS
+  #define DIAG_BUFFER_ROWS  64  /**< Records kept in memory before writing */
+#endif
+
+#define DIAG_NAME_LEN  32
+
+typedef struct Diag_{
+  char   name[DIAG_NAME_LEN];
+  int    type;
+  int    weight;
+  int    field[2];   /* Quantities (x, y for histograms)          */
+  int    nbin[2];    /* Number of bins (histograms)               */
+  int    logscale[2];
+  double qmin[2];    /* Lower bin edge (log10 with logscale)      */
+  double dinv[2];    /* Inverse bin width                         */
+  int    off;        /* Offset in the packed reduction buffer     */
+  int    col;        /* First column in the output records        */
+} Diag;
+
+static Diag s_diag[DIAG_MAX_NUMBER];
+static int  s_ndiag = 0;
+static int  s_nsum  = 0;  /* Size of the summed part of the buffer     */
+static int  s_nmax  = 0;  /* Size of the maximized part of the buffer  */
+static int  s_ntot  = 0;
+static int  s_ncol  = 2;
+static int  s_locked = 0;
+static int  s_append = 0;
+
+static DiagFieldFunc s_func[DIAG_MAX_FUNC];
+static int  s_nfunc = 0;
+
+static double *s_buf;     /* Local partial results                  */
+static double *s_res;     /* Reduced results                        */
+static double **s_row;    /* Output records (processor 0 only)      */
+static int     s_nrow = 0;
+
+static double *s_one, *s_wvol, *s_wmass;
+static double **s_qfunc;
+
+static int DiagRegister (const char *, int, int);
+static int FieldCheck (int);
+static double *FieldRow (const Data *, int, int, int);
+static void DiagAllocate (void);
+
+#ifdef PARALLEL
+static MPI_Datatype s_mpi_type;
+static MPI_Op       s_mpi_op;
+
+/* ********************************************************************* */
+static void DiagReduceOp (void *in, void *inout, int *len,
+                          MPI_Datatype *type)
+/*
+ * Sum the first s_nsum elements and take the maximum of the others.
+ * The whole buffer is a single element of s_mpi_type so that it is
+ * never split.
+ *********************************************************************** */
+{
+  int n, m;
+  double *a = (double *)in;
+  double *b = (double *)inout;
+
+  for (n = 0; n < *len; n++){
+    for (m = 0; m < s_nsum; m++)      b[m] += a[m];
+    for (m = s_nsum; m < s_ntot; m++) b[m]  = MAX(a[m], b[m]);
+    a += s_ntot;
+    b += s_ntot;
+  }
+}
+#endif
+
+/* ********************************************************************* */
+int DiagFieldFunction (DiagFieldFunc func)
+/*!
+ * Register a user-defined quantity.
+ * The function is called once per row as func(d, k, j, q, grid) and
+ * must fill q[i] for IBEG <= i <= IEND.
+ *
+ * \param [in] func  pointer to the function computing the quantity
+ *
+ * \return the field index to be used in DiagAdd() or
+ *         DiagAddHistogram().
+ *********************************************************************** */
+{
+  if (s_nfunc == DIAG_MAX_FUNC){
+    print ("! DiagFieldFunction(): too many fields, increase DIAG_MAX_FUNC\n");
+    QUIT_PLUTO(1);
+  }
+  s_func[s_nfunc] = func;
+  return DIAG_FUNC_BEG + s_nfunc++;
+}
+
+/* ********************************************************************* */
+int DiagAdd (const char *name, int type, int field, int weight)
+/*!
+ * Register a scalar diagnostic.
+ *
+ * \param [in] name    label written in the output header
+ * \param [in] type    ::DIAG_SUM, ::DIAG_MEAN, ::DIAG_MIN or ::DIAG_MAX
+ * \param [in] field   the quantity to be reduced
+ * \param [in] weight  ::DIAG_WEIGHT_NONE, ::DIAG_WEIGHT_VOLUME or
+ *                     ::DIAG_WEIGHT_MASS
+ *
+ * \return an integer identifying the diagnostic in DiagGet().
+ *********************************************************************** */
+{
+  int  id;
+  Diag *dg;
+
+  if (type != DIAG_SUM && type != DIAG_MEAN &&
+      type != DIAG_MIN && type != DIAG_MAX){
+    print ("! DiagAdd(): invalid type %d for '%s'\n", type, name);
+    QUIT_PLUTO(1);
+  }
+  id = DiagRegister (name, type, weight);
+  dg = s_diag + id;
+  dg->field[0] = FieldCheck (field);
+  s_ncol++;
+  return id;
+}
+
+/* ********************************************************************* */
+int DiagAddHistogram (const char *name,
+                      int fx, double xmin, double xmax, int nx, int logx,
+                      int fy, double ymin, double ymax, int ny, int logy,
+                      int weight)
+/*!
+ * Register a 1D (ny <= 1) or 2D histogram of the weight.
+ * Zones falling outside [xmin, xmax] x [ymin, ymax] are not counted.
+ *
+ * \param [in] name   label written in the output header
+ * \param [in] fx     quantity along x
+ * \param [in] xmin   lower x limit
+ * \param [in] xmax   upper x limit
+ * \param [in] nx     number of bins along x
+ * \param [in] logx   logarithmic bins along x when different from 0
+ * \param [in] fy     quantity along y (ignored when ny <= 1)
+ * \param [in] ymin   lower y limit
+ * \param [in] ymax   upper y limit
+ * \param [in] ny     number of bins along y
+ * \param [in] logy   logarithmic bins along y when different from 0
+ * \param [in] weight the weight added to each bin
+ *
+ * \return an integer identifying the diagnostic in DiagGetHistogram().
+ *********************************************************************** */
+{
+  int  id, n;
+  int  nbin[2]  = {nx, MAX(ny, 1)};
+  int  field[2] = {fx, (ny > 1 ? fy:DIAG_UNIT)};
+  int  logs[2]  = {logx, (ny > 1 ? logy:0)};
+  double qmin[2] = {xmin, (ny > 1 ? ymin:0.0)};
+  double qmax[2] = {xmax, (ny > 1 ? ymax:2.0)};
+  Diag *dg;
+
+  id = DiagRegister (name, DIAG_HIST, weight);
+  dg = s_diag + id;
+  for (n = 0; n < 2; n++){
+    if (nbin[n] < 1 || qmax[n] <= qmin[n] || (logs[n] && qmin[n] <= 0.0)){
+      print ("! DiagAddHistogram(): invalid range for '%s'\n", name);
+      QUIT_PLUTO(1);
+    }
+    if (logs[n]){
+      qmin[n] = log10(qmin[n]);
+      qmax[n] = log10(qmax[n]);
+    }
+    dg->field[n]    = FieldCheck (field[n]);
+    dg->nbin[n]     = nbin[n];
+    dg->logscale[n] = (logs[n] != 0);
+    dg->qmin[n]     = qmin[n];
+    dg->dinv[n]     = nbin[n]/(qmax[n] - qmin[n]);
+  }
+  s_ncol += nbin[0]*nbin[1];
+  return id;
+}
+
+/* ********************************************************************* */
+void DiagCompute (const Data *d, Grid *grid)
+/*!
+ * Evaluate all the registered diagnostics in a single pass over the
+ * domain followed by a single reduction, and append a record to the
+ * output buffer.
+ * Collective on MPI_COMM_WORLD.
+ *
+ * \param [in] d     pointer to Data structure
+ * \param [in] grid  pointer to Grid structure
+ *********************************************************************** */
+{
+  int    i, j, k, n, m;
+  double acc, accw;
+  double *f, *g, *w, *buf;
+  Diag   *dg;
+
+  if (s_ndiag == 0) return;
+  if (!s_locked) DiagAllocate();
+
+/* --------------------------------------------------------
+   1. Reset partial results: mins are stored as maxima
+      of -q.
+   -------------------------------------------------------- */
+
+  for (m = 0; m < s_nsum; m++) s_buf[m] = 0.0;
+  for (m = s_nsum; m < s_ntot; m++) s_buf[m] = -1.e300;
+
+/* --------------------------------------------------------
+   2. Single sweep over the domain
+   -------------------------------------------------------- */
+
+  KDOM_LOOP(k) JDOM_LOOP(j){
+
+    for (n = 0; n < s_nfunc; n++) s_func[n] (d, k, j, s_qfunc[n], grid);
+    IDOM_LOOP(i){
+      s_wvol[i]  = grid->dV[k][j][i];
+      s_wmass[i] = d->Vc[RHO][k][j][i]*s_wvol[i];
+    }
+
+    for (n = 0; n < s_ndiag; n++){
+      dg  = s_diag + n;
+      buf = s_buf + dg->off;
+      f   = FieldRow (d, dg->field[0], k, j);
+      w   = (dg->weight == DIAG_WEIGHT_MASS   ? s_wmass:
+            (dg->weight == DIAG_WEIGHT_VOLUME ? s_wvol:s_one));
+
+      switch (dg->type){
+        case DIAG_SUM:
+          acc = 0.0;
+          IDOM_LOOP(i) acc += w[i]*f[i];
+          buf[0] += acc;
+          break;
+
+        case DIAG_MEAN:
+          acc = accw = 0.0;
+          IDOM_LOOP(i){
+            acc  += w[i]*f[i];
+            accw += w[i];
+          }
+          buf[0] += acc;
+          buf[1] += accw;
+          break;
+
+        case DIAG_MAX:
+          acc = buf[0];
+          IDOM_LOOP(i) acc = MAX(acc, f[i]);
+          buf[0] = acc;
+          break;
+
+        case DIAG_MIN:
+          acc = buf[0];
+          IDOM_LOOP(i) acc = MAX(acc, -f[i]);
+          buf[0] = acc;
+          break;
+
+        case DIAG_HIST:
+          g = FieldRow (d, dg->field[1], k, j);
+          DiagHistogramRow (f, g, w, dg->qmin, dg->dinv, dg->nbin,
+                            dg->logscale, buf);
+          break;
+      }
+    }
+  }
+
+/* --------------------------------------------------------
+   3. Combine partial results
+   -------------------------------------------------------- */
+
+  #ifdef PARALLEL
+  MPI_Allreduce (s_buf, s_res, 1, s_mpi_type, s_mpi_op, MPI_COMM_WORLD);
+  #else
+  for (m = 0; m < s_ntot; m++) s_res[m] = s_buf[m];
+  #endif
+
+/* --------------------------------------------------------
+   4. Append a record to the output buffer
+   -------------------------------------------------------- */
+
+  if (prank != 0) return;
+
+  buf    = s_row[s_nrow];
+  buf[0] = g_time;
+  buf[1] = (double)g_stepNumber;
+  for (n = 0; n < s_ndiag; n++){
+    dg = s_diag + n;
+    if (dg->type == DIAG_HIST){
+      m = dg->nbin[0]*dg->nbin[1];
+      for (i = 0; i < m; i++) buf[dg->col + i] = s_res[dg->off + i];
+    }else{
+      buf[dg->col] = DiagGet(n);
+    }
+  }
+  s_nrow++;
+  if (s_nrow == DIAG_BUFFER_ROWS) DiagFlush();
+}
+
+/* ********************************************************************* */
+void DiagHistogramRow (const double *qx, const double *qy, const double *w,
+                       const double *qmin, const double *dinv,
+                       const int *nbin, const int *logscale, double *bins)
+/*!
+ * Add the weights of the zones IBEG <= i <= IEND of a row to a 1D or
+ * 2D histogram; bin (ix, iy) is found at ix + iy*nbin[0].
+ * Also used by WriteHistograms().
+ *
+ * \param [in] qx        quantity along x
+ * \param [in] qy        quantity along y
+ * \param [in] w         the weight of each zone
+ * \param [in] qmin      lower bin edges (log10 with logscale)
+ * \param [in] dinv      inverse bin widths
+ * \param [in] nbin      number of bins along x and y
+ * \param [in] logscale  logarithmic bins when different from 0
+ * \param [in,out] bins  the histogram
+ *********************************************************************** */
+{
+  int    i, ix, iy;
+  double x, y;
+
+  IDOM_LOOP(i){
+    x = qx[i];
+    y = qy[i];
+    if (logscale[0]) x = (x > 0.0 ? log10(x):-1.e300);
+    if (logscale[1]) y = (y > 0.0 ? log10(y):-1.e300);
+    x = (x - qmin[0])*dinv[0];
+    y = (y - qmin[1])*dinv[1];
+    if (x < 0.0 || y < 0.0 || x >= nbin[0] || y >= nbin[1]) continue;
+    ix = (int)x;
+    iy = (int)y;
+    bins[iy*nbin[0] + ix] += w[i];
+  }
+}
+
+/* ********************************************************************* */
+double DiagGet (int id)
+/*!
+ * Return the value of a scalar diagnostic computed by the last call
+ * to DiagCompute(), or the total weight of a histogram.
+ *********************************************************************** */
+{
+  int  m;
+  double q = 0.0;
+  Diag *dg = s_diag + id;
+
+  switch (dg->type){
+    case DIAG_SUM:  q = s_res[dg->off];                     break;
+    case DIAG_MEAN: q = s_res[dg->off]/s_res[dg->off + 1];  break;
+    case DIAG_MAX:  q = s_res[dg->off];                     break;
+    case DIAG_MIN:  q = -s_res[dg->off];                    break;
+    case DIAG_HIST:
+      for (m = 0; m < dg->nbin[0]*dg->nbin[1]; m++) q += s_res[dg->off + m];
+      break;
+  }
+  return q;
+}
+
+/* ********************************************************************* */
+double *DiagGetHistogram (int id)
+/*!
+ * Return a pointer to the bins of a histogram computed by the last
+ * call to DiagCompute(); bin (ix, iy) is found at ix + iy*nx.
+ *********************************************************************** */
+{
+  return s_res + s_diag[id].off;
+}
+
+/* ********************************************************************* */
+void DiagFlush (void)
+/*!
+ * Write the buffered records to "diagnostics.bin" (processor 0 only).
+ *********************************************************************** */
+{
+  int  n;
+  char fname[512];
+  static int first_call = 1;
+  FILE *fp;
+  Diag *dg;
+  static const char *tname[] = {"", "sum", "mean", "min", "max", "hist"};
+  static const char *wname[] = {"none", "volume", "mass"};
+
+  if (prank != 0 || s_nrow == 0) return;
+
+  sprintf (fname, "%s/diagnostics.bin", RuntimeGet()->output_dir);
+
+/* --------------------------------------------------------
+   1. At the first call, write the header unless appending
+      to an existing file.
+   -------------------------------------------------------- */
+
+  if (first_call){
+    fp = (s_append ? fopen(fname, "rb"):NULL);
+    if (fp == NULL){
+      fp = fopen(fname, "wb");
+      if (fp == NULL){
+        printLog ("! DiagFlush(): cannot open %s\n", fname);
+        QUIT_PLUTO(1);
+      }
+      fprintf (fp, "# PLUTO diagnostics\n");
+      fprintf (fp, "# ncol        %d\n", s_ncol);
+      fprintf (fp, "# endianness  %s\n", IsLittleEndian() ? "little":"big");
+      fprintf (fp, "# col  0  1  time\n");
+      fprintf (fp, "# col  1  1  step\n");
+      for (n = 0; n < s_ndiag; n++){
+        dg = s_diag + n;
+        fprintf (fp, "# col  %d  %d  %s  %s  %s", dg->col,
+                 dg->type == DIAG_HIST ? dg->nbin[0]*dg->nbin[1]:1,
+                 dg->name, tname[dg->type], wname[dg->weight]);
+        if (dg->type == DIAG_HIST){
+          fprintf (fp, "  %d %d  %s%12.6e %12.6e  %d %d  %s%12.6e %12.6e",
+                   dg->field[0], dg->nbin[0], dg->logscale[0] ? "log ":"",
+                   dg->qmin[0], dg->qmin[0] + dg->nbin[0]/dg->dinv[0],
+                   dg->field[1], dg->nbin[1], dg->logscale[1] ? "log ":"",
+                   dg->qmin[1], dg->qmin[1] + dg->nbin[1]/dg->dinv[1]);
+        }else{
+          fprintf (fp, "  %d", dg->field[0]);
+        }
+        fprintf (fp, "\n");
+      }
+      fprintf (fp, "# end\n");
+    }
+    fclose(fp);
+    first_call = 0;
+  }
+
+/* --------------------------------------------------------
+   2. Append records
+   -------------------------------------------------------- */
+
+  fp = fopen(fname, "ab");
+  fwrite (s_row[0], sizeof(double), (size_t)s_nrow*s_ncol, fp);
+  fclose(fp);
+  s_nrow = 0;
+}
+
+/* ********************************************************************* */
+void DiagRestart (void)
+/*!
+ * Remove from "diagnostics.bin" the records following the current
+ * step, so that the file does not contain duplicate or stale records
+ * when the run is restarted from an earlier dump.
+ * Must be called after the restart file has been read.
+ *********************************************************************** */
+{
+  int    ncol = 0;
+  char   fname[512], line[512], order[32] = "";
+  long   off, size = 0;
+  double *rec;
+  FILE  *fp;
+
+  if (prank != 0) return;
+
+  sprintf (fname, "%s/diagnostics.bin", RuntimeGet()->output_dir);
+  fp = fopen(fname, "rb");
+  if (fp == NULL) return;
+
+/* --------------------------------------------------------
+   1. Parse the header
+   -------------------------------------------------------- */
+
+  while (fgets(line, sizeof(line), fp) != NULL){
+    if (!strcmp(line, "# end\n")) break;
+    sscanf (line, "# ncol %d", &ncol);
+    sscanf (line, "# endianness %31s", order);
+  }
+  if (ncol < 2 || strcmp(order, IsLittleEndian() ? "little":"big")){
+    printLog ("! DiagRestart(): cannot read %s, records are not removed\n",
+              fname);
+    fclose(fp);
+    return;
+  }
+
+/* --------------------------------------------------------
+   2. Find the first record past the current step and
+      truncate the file there.
+   -------------------------------------------------------- */
+
+  rec = ARRAY_1D(ncol, double);
+  off = ftell(fp);
+  while (fread(rec, sizeof(double), ncol, fp) == (size_t)ncol){
+    if (rec[1] > (double)g_stepNumber) break;
+    off += ncol*sizeof(double);
+  }
+  fseek (fp, 0, SEEK_END);
+  size = ftell(fp);
+  fclose(fp);
+  FreeArray1D ((void *)rec);
+
+  if (off < size){
+    printLog ("> DiagRestart(): removing %ld records from %s\n",
+              (size - off)/(ncol*(long)sizeof(double)), fname);
+    if (truncate(fname, off) != 0){
+      printLog ("! DiagRestart(): cannot truncate %s\n", fname);
+    }
+  }
+}
+
+/* ********************************************************************* */
+int DiagRegister (const char *name, int type, int weight)
+/*
+ * Add a new entry to the list of diagnostics.
+ *********************************************************************** */
+{
+  Diag *dg;
+
+  if (s_locked){
+    print ("! DiagRegister(): '%s' must be registered before the first "
+           "call to DiagCompute()\n", name);
+    QUIT_PLUTO(1);
+  }
+  if (s_ndiag == DIAG_MAX_NUMBER){
+    print ("! DiagRegister(): too many diagnostics, increase DIAG_MAX_NUMBER\n");
+    QUIT_PLUTO(1);
+  }
+  if (weight != DIAG_WEIGHT_NONE && weight != DIAG_WEIGHT_VOLUME &&
+      weight != DIAG_WEIGHT_MASS){
+    print ("! DiagRegister(): invalid weight %d for '%s'\n", weight, name);
+    QUIT_PLUTO(1);
+  }
+  dg = s_diag + s_ndiag;
+  memset (dg, 0, sizeof(Diag));
+  strncpy (dg->name, name, DIAG_NAME_LEN-1);
+  dg->type   = type;
+  dg->weight = weight;
+  dg->nbin[0] = dg->nbin[1] = 1;
+  dg->col    = s_ncol;
+  return s_ndiag++;
+}
+
+/* ********************************************************************* */
+int FieldCheck (int field)
+/*
+ * Abort if field does not refer to an available quantity.
+ *********************************************************************** */
+{
+  if (field == DIAG_UNIT) return field;
+  if (field >= 0 && field < NVAR) return field;
+  #if COOLING == GRACKLE
+  if (field >= DIAG_VGRAC(TEMP) && field <= DIAG_VGRAC(TCOOL)) return field;
+  #endif
+  if (field >= DIAG_FUNC_BEG && field < DIAG_FUNC_BEG + s_nfunc) return field;
+
+  print ("! FieldCheck(): invalid diagnostics field %d\n", field);
+  QUIT_PLUTO(1);
+  return field;
+}
+
+/* ********************************************************************* */
+double *FieldRow (const Data *d, int field, int k, int j)
+/*
+ * Return a pointer to row (k,j) of the given quantity.
+ *********************************************************************** */
+{
+  if (field == DIAG_UNIT) return s_one;
+  if (field < NVAR) return d->Vc[field][k][j];
+  #if COOLING == GRACKLE
+  if (field < DIAG_FUNC_BEG) return d->Vgrac[field - DIAG_VGRAC(0)][k][j];
+  #endif
+  return s_qfunc[field - DIAG_FUNC_BEG];
+}
+
+/* ********************************************************************* */
+void DiagAllocate (void)
+/*
+ * Assign buffer offsets (sums first, then maxima), allocate memory
+ * and freeze the list of diagnostics.
+ *********************************************************************** */
+{
+  int  i, n, m;
+  Diag *dg;
+
+  s_nsum = s_nmax = 0;
+  for (n = 0; n < s_ndiag; n++){
+    dg = s_diag + n;
+    if      (dg->type == DIAG_SUM)  {dg->off = s_nsum; s_nsum += 1;}
+    else if (dg->type == DIAG_MEAN) {dg->off = s_nsum; s_nsum += 2;}
+    else if (dg->type == DIAG_HIST) {
+      dg->off = s_nsum;
+      s_nsum += dg->nbin[0]*dg->nbin[1];
+    }
+  }
+  for (n = 0; n < s_ndiag; n++){
+    dg = s_diag + n;
+    if (dg->type == DIAG_MIN || dg->type == DIAG_MAX) {
+      dg->off = s_nsum + s_nmax++;
+    }
+  }
+  s_ntot = s_nsum + s_nmax;
+
+  s_buf   = ARRAY_1D(s_ntot, double);
+  s_res   = ARRAY_1D(s_ntot, double);
+  s_one   = ARRAY_1D(NX1_TOT, double);
+  s_wvol  = ARRAY_1D(NX1_TOT, double);
+  s_wmass = ARRAY_1D(NX1_TOT, double);
+  if (s_nfunc > 0) s_qfunc = ARRAY_2D(s_nfunc, NX1_TOT, double);
+  for (i = 0; i < NX1_TOT; i++) s_one[i] = 1.0;
+  for (m = 0; m < s_ntot; m++) s_res[m] = 0.0;
+  if (prank == 0) s_row = ARRAY_2D(DIAG_BUFFER_ROWS, s_ncol, double);
+
+  #ifdef PARALLEL
+  MPI_Type_contiguous (s_ntot, MPI_DOUBLE, &s_mpi_type);
+  MPI_Type_commit (&s_mpi_type);
+  MPI_Op_create (DiagReduceOp, 1, &s_mpi_op);
+  #endif
+
+  s_append = (g_stepNumber > 0);
+  s_locked = 1;
+}
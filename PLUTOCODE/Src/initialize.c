@@ -425,7 +425,8 @@ void Initialize(Data *data, Runtime *runtime, Grid *grid, cmdLine *cmd_line)
   data->Vc = ARRAY_4D(NVAR, NX3_TOT, NX2_TOT, NX1_TOT, double);
   data->Uc = ARRAY_4D(NX3_TOT, NX2_TOT, NX1_TOT, NVAR, double);
   #if COOLING == GRACKLE
-  data->Vgrac = ARRAY_4D(2, NX3_TOT, NX2_TOT, NX1_TOT, double);
+  data->Vgrac = ARRAY_4D(3, NX3_TOT, NX2_TOT, NX1_TOT, double);
+  TOT_LOOP(k,j,i) data->Vgrac[TCOOL][k][j][i] = 0.0;
   #endif
 
 #ifdef STAGGERED_MHD
@@ -502,7 +503,9 @@ void Initialize(Data *data, Runtime *runtime, Grid *grid, cmdLine *cmd_line)
   #endif
 
 /* ----------------------------------------------
-   8. Initialize tables needed for EOS 
+   8. Initialize tables needed for EOS and
+      cooling (shared among the processors
+      of the same node, see shared_table.c)
    ---------------------------------------------- */
   
 #if EOS == PVTE_LAW && NIONS == 0
@@ -513,6 +516,9 @@ void Initialize(Data *data, Runtime *runtime, Grid *grid, cmdLine *cmd_line)
   #endif
   MakePV_TemperatureTable();
 #endif
+#if (COOLING == TABULATED) || (COOLING == TOWNSEND)
+  CoolingTableRead();
+#endif
 
 /* ----------------------------------------------
    9. Assign initial cond. for fluid & particles.
@@ -520,6 +526,10 @@ void Initialize(Data *data, Runtime *runtime, Grid *grid, cmdLine *cmd_line)
       in case output requires writing the residual.
    ---------------------------------------------- */
 
+  InputDataSetGrid (grid);
+#if COOLING == GRACKLE
+  grackle_set_restart (cmd_line->restart == YES || cmd_line->h5restart == YES);
+#endif
   Startup (data, grid);
 
 #if (PARTICLES != NO)
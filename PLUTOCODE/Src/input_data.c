@@ -32,6 +32,15 @@
   The value of ::ID_NZ_MAX can be changed from your personal \c definitions.h.
   This task is performed in the InputDataReadSlice() function.
 
+  When ::ID_READ_BOX is set to \c YES (default is \c NO) and the input
+  grid has the same geometry as the computational grid, each processor
+  reads, at opening, only the portion of the input data overlapping its
+  local domain (ghost zones included) using collective MPI-IO
+  (InputDataReadBox()).
+  InputDataOpen() then becomes collective and must be called by all
+  processors at the same time (e.g. from Init() or InitDomain(), not
+  from UserDefBoundary()).
+
   \authors A. Mignone (mignone@to.infn.it)\n
   \date    Nov 10, 2020
 */
@@ -44,6 +53,12 @@
                              input buffer. */
 #endif
 
+#ifndef ID_READ_BOX
+ #define ID_READ_BOX  NO   /**< Read only the portion of the input data
+                                overlapping the local domain (collective
+                                InputDataOpen()). */
+#endif
+
 typedef struct inputData_{
   char fname[64];
   size_t dsize;
@@ -58,11 +73,38 @@ typedef struct inputData_{
   double *x2;
   double *x3;
   double ***Vin;    /**< Input buffer array (containing at most ::ID_NZ_MAX
-                         planes at a time */
+                         planes at a time or the local box) */
   long int offset;
+  int box;          /**< YES if Vin contains the local box only */
+  int lbox[3];      /**< Lower index of the local box in the input grid */
+  int nbox[3];      /**< Size of the local box */
 } inputData;
 
 static inputData id_stack[ID_NVAR_MAX];
+static int    id_domain_set = 0;
+static double id_xbeg[3], id_xend[3];  /* Local domain extent (with ghosts) */
+
+static int  InputDataLocate (double *, int, double);
+static void InputDataReadBox (int);
+
+/* ********************************************************************* */
+void InputDataSetGrid (Grid *grid)
+/*!
+ * Store the extent of the local domain (ghost zones included) so that
+ * InputDataOpen() can read only the overlapping portion of input data.
+ * Called before initial conditions are assigned.
+ *
+ * \param [in] grid  pointer to an array of Grid structures
+ *********************************************************************** */
+{
+  int dir;
+
+  for (dir = 0; dir < 3; dir++){
+    id_xbeg[dir] = grid->xl[dir][0];
+    id_xend[dir] = grid->xr[dir][grid->np_tot[dir]-1];
+  }
+  id_domain_set = 1;
+}
 
 /* ********************************************************************* */
 int InputDataOpen(char *data_fname, char *grid_fname, char *endianity,
@@ -262,7 +304,25 @@ int InputDataOpen(char *data_fname, char *grid_fname, char *endianity,
   }
   fclose(fp);
 
-  id->Vin = ARRAY_3D(ID_NZ_MAX, id->nx2, id->nx1, double);
+  id->box = (ID_READ_BOX == YES) && id_domain_set && (id->geom == GEOMETRY);
+  if (id->box){
+    int     dir;
+    int     nin[3] = {id->nx1, id->nx2, id->nx3};
+    double *xin[3] = {id->x1, id->x2, id->x3};
+
+    for (dir = 0; dir < 3; dir++){
+      id->lbox[dir] = 0;
+      id->nbox[dir] = nin[dir];
+      if (dir < DIMENSIONS && nin[dir] > 1){
+        id->lbox[dir] = InputDataLocate(xin[dir], nin[dir], id_xbeg[dir]);
+        id->nbox[dir] = InputDataLocate(xin[dir], nin[dir], id_xend[dir])
+                        - id->lbox[dir] + 2;
+      }
+    }
+    id->Vin = ARRAY_3D(id->nbox[KDIR], id->nbox[JDIR], id->nbox[IDIR], double);
+  }else{
+    id->Vin = ARRAY_3D(ID_NZ_MAX, id->nx2, id->nx1, double);
+  }
 
 /* ---------------------------------------------------------- */
 /*! 5. Set endianity (\c id->swap_endian)                     */
@@ -314,6 +374,18 @@ int InputDataOpen(char *data_fname, char *grid_fname, char *endianity,
   id->klast  = -1;
 
   printLog ("  offset = %ld\n",id->offset);
+
+/* ---------------------------------------------------------- */
+/*! 8. Read the local box, if required                       */
+/* ---------------------------------------------------------- */
+
+  if (id->box){
+    printLog ("  Local box:             [%d, %d] x [%d, %d] x [%d, %d]\n",
+               id->lbox[IDIR], id->lbox[IDIR] + id->nbox[IDIR] - 1,
+               id->lbox[JDIR], id->lbox[JDIR] + id->nbox[JDIR] - 1,
+               id->lbox[KDIR], id->lbox[KDIR] + id->nbox[KDIR] - 1);
+    InputDataReadBox (indx);
+  }
   printLog ("\n");
 
   return indx;  /* The index of the id_stack[] array */
@@ -373,15 +445,9 @@ double InputDataInterpolate (int indx, double x1, double x2, double x3)
  *********************************************************************** */
 {
   int il = 0, jl = 0, kl = 0;
-  int ih, jh, kh;
-  int im, jm, km;
-  int i, j, k, nv;
-  float  uflt;
-  double udbl;
   double xx, yy, zz, v;
   double **Vlo, **Vhi;
   inputData *id = id_stack + indx;
-  static FILE *fp;
 
 /* --------------------------------------------------------------------- */
 /*! - Convert PLUTO coordinates to input grid geometry if necessary.     */
@@ -538,33 +604,9 @@ print ("o Input data extension:  [%f, %f], [%f, %f], [%f, %f]\n",
       [il, il+1], [jl, jl+1], [kl, kl+1].                                */
 /* --------------------------------------------------------------------- */
 
-  il = 0;
-  ih = id->nx1 - 1;
-  while (il != (ih-1)){
-    im = (il+ih)/2;
-    if   (x1 <= id->x1[im]) ih = im;   
-    else                    il = im;
-  }
-  
-  if (id->nx2 > 1){
-    jl = 0;
-    jh = id->nx2 - 1;
-    while (jl != (jh-1)){
-      jm = (jl+jh)/2;
-      if (x2 <= id->x2[jm]) jh = jm;   
-      else                  jl = jm;
-    }
-  }
-
-  if (id->nx3 > 1){
-    kl = 0;
-    kh = id->nx3 - 1;
-    while (kl != (kh - 1)){
-      km = (kl+kh)/2;
-      if (x3 <= id->x3[km]) kh = km;   
-      else                  kl = km;
-    }
-  }
+  il = InputDataLocate (id->x1, id->nx1, x1);
+  jl = InputDataLocate (id->x2, id->nx2, x2);
+  kl = InputDataLocate (id->x3, id->nx3, x3);
 
 /* --------------------------------------------------------------------- */
 /*! - Define normalized coordinates between [0,1]:
@@ -602,16 +644,30 @@ ncall++;
 }
 */
 
-  if ( (kl >= id->klast + ID_NZ_MAX - 1) || (kl < id->klast) || (id->klast == -1) ){
-    InputDataReadSlice(indx, kl);
+  if (id->box){
+    il -= id->lbox[IDIR];
+    jl -= id->lbox[JDIR];
+    kl -= id->lbox[KDIR];
+    if (   il < 0 || il + (id->nx1 > 1) >= id->nbox[IDIR]
+        || jl < 0 || jl + (id->nx2 > 1) >= id->nbox[JDIR]
+        || kl < 0 || kl + (id->nx3 > 1) >= id->nbox[KDIR]){
+      printLog ("! InputDataInterpolate(): point (%f, %f, %f) outside local box\n",
+                 x1, x2, x3);
+      QUIT_PLUTO(1);
+    }
+  }else{
+    if ( (kl >= id->klast + ID_NZ_MAX - 1) || (kl < id->klast) || (id->klast == -1) ){
+      InputDataReadSlice(indx, kl);
+    }
+    kl -= id->klast;
   }
 
 /* --------------------------------------------------------------------- */
 /*! - Perform bi- or tri-linear interpolation.                           */
 /* --------------------------------------------------------------------- */
 
-  Vlo = id->Vin[kl - id->klast];
-  Vhi = id->Vin[kl - id->klast+1];
+  Vlo = id->Vin[kl];
+  Vhi = (id->nx3 > 1 ? id->Vin[kl+1]:Vlo);
 
   v =   Vlo[jl][il]*(1.0 - xx)*(1.0 - yy)*(1.0 - zz)  /* [0] is kl */
       + Vlo[jl][il+1]*xx*(1.0 - yy)*(1.0 - zz);
@@ -642,10 +698,10 @@ void InputDataReadSlice(int indx, int kslice)
  *
  *********************************************************************** */
 {
-  int i,j,k, kmax;
-  long int offset;
-  double udbl;
-  float  uflt;
+  long int i, offset, nelem;
+  int kmax;
+  double *Vd;
+  float  *Vf;
   inputData *id = id_stack + indx;
   FILE *fp;
 
@@ -666,31 +722,27 @@ void InputDataReadSlice(int indx, int kslice)
    2. Read binary data at specified position.
    ----------------------------------------------------- */
    
-  kmax = MIN(id->nx3-kslice,ID_NZ_MAX);
+  kmax  = MIN(id->nx3-kslice,ID_NZ_MAX);  /* Read at most kmax planes */
+  nelem = (long)kmax*id->nx2*id->nx1;
+  Vd    = id->Vin[0][0];
   if (id->dsize == sizeof(double)){
-    for (k = 0; k < kmax   ; k++){   /* Read at most kmax planes */  
-    for (j = 0; j < id->nx2; j++){
-    for (i = 0; i < id->nx1; i++){      
-      if (fread (&udbl, id->dsize, 1, fp) != 1){  
-        printLog ("! InputDataReadSlice(): error reading data (indx = %d)\n",indx);
-        break;
-      }
-      if (id->swap_endian) SWAP_VAR(udbl);
-      id->Vin[k][j][i] = udbl;
-    }}}
+    if (fread (Vd, id->dsize, nelem, fp) != nelem){  
+      printLog ("! InputDataReadSlice(): error reading data (indx = %d)\n",indx);
+    }
+    if (id->swap_endian) for (i = 0; i < nelem; i++) SWAP_VAR(Vd[i]);
 
-   }else{
+  }else{
 
-    for (k = 0; k < kmax   ; k++){   /* Read at most kmax planes */  
-    for (j = 0; j < id->nx2; j++){
-    for (i = 0; i < id->nx1; i++){
-      if (fread (&uflt, id->dsize, 1, fp) != 1){
-        printLog ("! InputDataReadSlice(): error reading data (indx = %d)\n",indx);
-        break;
-      }
-      if (id->swap_endian) SWAP_VAR(uflt);
-      id->Vin[k][j][i] = (double)uflt;
-    }}}
+  /* -- Read into the upper half of the buffer and convert in place -- */
+
+    Vf = (float *)(Vd + nelem) - nelem;
+    if (fread (Vf, id->dsize, nelem, fp) != nelem){
+      printLog ("! InputDataReadSlice(): error reading data (indx = %d)\n",indx);
+    }
+    for (i = 0; i < nelem; i++){
+      if (id->swap_endian) SWAP_VAR(Vf[i]);
+      Vd[i] = (double)Vf[i];
+    }
   }
 
 /* -- Update last successfully read slice -- */
@@ -707,4 +759,106 @@ for (i = 0; i < id->nx1; i++){
 */
 }
 
+/* ********************************************************************* */
+void InputDataReadBox(int indx)
+/*! 
+ * Read the portion of input data overlapping the local domain 
+ * (as set by InputDataOpen()) into the buffer \c id->Vin.
+ * In parallel, all processors read their box at the same time using
+ * a subarray file view and collective MPI-IO.
+ * Otherwise, data is read one row (along x1) at a time.
+ *
+ * \param [in] indx    the structure index (file handle)
+ *
+ *********************************************************************** */
+{
+  long int i, nelem;
+  double *Vd;
+  float  *Vf;
+  inputData *id = id_stack + indx;
+
+  nelem = (long)id->nbox[IDIR]*id->nbox[JDIR]*id->nbox[KDIR];
+  Vd    = id->Vin[0][0];
+  Vf    = (float *)(Vd + nelem) - nelem; /* Upper half of the buffer */
+
+#ifdef PARALLEL
+  int gsize[3], lsize[3], start[3];
+  MPI_File     fh;
+  MPI_Datatype etype, box_type;
+
+  gsize[0] = id->nx3;        gsize[1] = id->nx2;        gsize[2] = id->nx1;
+  lsize[0] = id->nbox[KDIR]; lsize[1] = id->nbox[JDIR]; lsize[2] = id->nbox[IDIR];
+  start[0] = id->lbox[KDIR]; start[1] = id->lbox[JDIR]; start[2] = id->lbox[IDIR];
+
+  etype = (id->dsize == sizeof(double) ? MPI_DOUBLE:MPI_FLOAT);
+  MPI_Type_create_subarray (3, gsize, lsize, start, MPI_ORDER_C, 
+                            etype, &box_type);
+  MPI_Type_commit (&box_type);
+
+  if (MPI_File_open (MPI_COMM_WORLD, id->fname, MPI_MODE_RDONLY,
+                     MPI_INFO_NULL, &fh) != MPI_SUCCESS){
+    printLog ("! InputDataReadBox(): cannot open %s\n",id->fname);
+    QUIT_PLUTO(1);
+  }
+  MPI_File_set_view (fh, id->offset, etype, box_type, "native", MPI_INFO_NULL);
+  MPI_File_read_all (fh, (id->dsize == sizeof(double) ? (void *)Vd:(void *)Vf),
+                     nelem, etype, MPI_STATUS_IGNORE);
+  MPI_File_close (&fh);
+  MPI_Type_free (&box_type);
+#else
+  int j, k;
+  long int offset;
+  char *buf = (id->dsize == sizeof(double) ? (char *)Vd:(char *)Vf);
+  FILE *fp;
+
+  fp = fopen(id->fname,"rb");
+  if (fp == NULL){
+    printLog ("! InputDataReadBox(): cannot open %s\n",id->fname);
+    QUIT_PLUTO(1);
+  }
+  for (k = 0; k < id->nbox[KDIR]; k++){
+  for (j = 0; j < id->nbox[JDIR]; j++){
+    offset =   (long)(k + id->lbox[KDIR])*id->nx2*id->nx1
+             + (long)(j + id->lbox[JDIR])*id->nx1 + id->lbox[IDIR];
+    fseek(fp, id->offset + offset*id->dsize, SEEK_SET);
+    if (fread (buf, id->dsize, id->nbox[IDIR], fp) != id->nbox[IDIR]){
+      printLog ("! InputDataReadBox(): error reading data (indx = %d)\n",indx);
+      QUIT_PLUTO(1);
+    }
+    buf += id->nbox[IDIR]*id->dsize;
+  }}
+  fclose(fp);
+#endif
+
+/* -- Swap bytes and convert to double -- */
+
+  if (id->dsize == sizeof(double)){
+    if (id->swap_endian) for (i = 0; i < nelem; i++) SWAP_VAR(Vd[i]);
+  }else{
+    for (i = 0; i < nelem; i++){
+      if (id->swap_endian) SWAP_VAR(Vf[i]);
+      Vd[i] = (double)Vf[i];
+    }
+  }
+}
+
+/* ********************************************************************* */
+int InputDataLocate (double *x, int n, double xp)
+/*!
+ * Use table lookup by binary search to find the index i such that
+ * x[i] <= xp <= x[i+1]. Points outside the range are assigned to
+ * the first or last interval.
+ *
+ * \return the index i (0 if n < 2).
+ *********************************************************************** */
+{
+  int il = 0, ih = n - 1, im;
 
+  if (n < 2) return 0;
+  while (il != (ih-1)){
+    im = (il+ih)/2;
+    if   (xp <= x[im]) ih = im;   
+    else               il = im;
+  }
+  return il;
+}
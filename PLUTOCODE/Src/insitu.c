@@ -0,0 +1,179 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief In-situ adaptor: pass simulation data to a run-time plugin.
+
+  An in-situ plugin (e.g. a rendering or data reduction adaptor) is a
+  shared library implementing the interface described in insitu.h.
+  It is enabled in the [Static Grid Output] section of pluto.ini by
+
+  \verbatim
+  insitu    0.01  -1   ./insitu_file.so   [arguments ...]
+  \endverbatim
+
+  where the first two fields are the time and step intervals between
+  calls (as for \c analysis), followed by the path of the library
+  and by optional arguments passed verbatim to the plugin.
+  PLUTO must be compiled with \c USE_INSITU = TRUE (adds -DUSE_INSITU
+  and -ldl); Insitu/insitu_file.c is a simple plugin writing field
+  statistics to a text file that can be used for testing.
+
+  The InsituData structure is filled once at InsituInit() with
+  pointers to the primitive variables d->Vc, to the Grackle fields
+  d->Vgrac and to the grid coordinates (no data is copied); time and
+  step are updated before each call.
+
+  \date   Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+#include "insitu.h"
+#ifdef USE_INSITU
+#include <dlfcn.h>
+
+static InsituField s_field[NVAR + 3];
+#endif
+
+static InsituData  s_data;
+static InsituExecuteFunc  s_execute;
+static InsituFinalizeFunc s_finalize;
+
+/* ********************************************************************* */
+void InsituInit (Data *d, Runtime *runtime, Grid *grid)
+/*!
+ * Load the plugin given in pluto.ini (if any), fill the InsituData
+ * structure and call the plugin initialization function.
+ * Collective on MPI_COMM_WORLD.
+ *
+ * \param [in] d        pointer to Data structure
+ * \param [in] runtime  pointer to Runtime structure
+ * \param [in] grid     pointer to Grid structure
+ *********************************************************************** */
+{
+  if (runtime->insitu_lib[0] == '\0') return;
+
+#ifdef USE_INSITU
+  int  nv, dir, err = 0;
+  void *lib;
+  InsituInitFunc init;
+
+/* --------------------------------------------------------
+   1. Load the library
+   -------------------------------------------------------- */
+
+  lib = dlopen (runtime->insitu_lib, RTLD_NOW | RTLD_LOCAL);
+  if (lib == NULL){
+    print ("! InsituInit(): %s\n", dlerror());
+    QUIT_PLUTO(1);
+  }
+  init        = (InsituInitFunc)     dlsym (lib, "InsituPluginInit");
+  s_execute   = (InsituExecuteFunc)  dlsym (lib, "InsituPluginExecute");
+  s_finalize  = (InsituFinalizeFunc) dlsym (lib, "InsituPluginFinalize");
+  if (s_execute == NULL){
+    print ("! InsituInit(): InsituPluginExecute() not found in %s\n",
+           runtime->insitu_lib);
+    QUIT_PLUTO(1);
+  }
+
+/* --------------------------------------------------------
+   2. Set views of data and grid
+   -------------------------------------------------------- */
+
+  s_data.version    = INSITU_VERSION;
+  s_data.rank       = prank;
+  s_data.nproc      = 1;
+  s_data.comm       = 0;
+  #ifdef PARALLEL
+  MPI_Comm_size (MPI_COMM_WORLD, &s_data.nproc);
+  s_data.comm       = (int)MPI_Comm_c2f (MPI_COMM_WORLD);
+  #endif
+  s_data.dimensions = DIMENSIONS;
+  s_data.geometry   = GEOMETRY;
+  s_data.unit_density  = UNIT_DENSITY;
+  s_data.unit_length   = UNIT_LENGTH;
+  s_data.unit_velocity = UNIT_VELOCITY;
+
+  for (dir = 0; dir < 3; dir++){
+    s_data.ntot[dir]    = grid->np_tot[dir];
+    s_data.beg[dir]     = grid->lbeg[dir];
+    s_data.end[dir]     = grid->lend[dir];
+    s_data.offset[dir]  = grid->beg[dir] - grid->gbeg[dir];
+    s_data.np_glob[dir] = grid->np_int_glob[dir];
+    s_data.x[dir]       = grid->x[dir];
+    s_data.xl[dir]      = grid->xl[dir];
+    s_data.xr[dir]      = grid->xr[dir];
+    s_data.dx[dir]      = grid->dx[dir];
+  }
+
+  for (nv = 0; nv < NVAR; nv++){
+    s_field[nv].name = runtime->output[0].var_name[nv];
+    s_field[nv].data = d->Vc[nv][0][0];
+  }
+  #if COOLING == GRACKLE
+  s_field[nv].name   = "Tgrac";
+  s_field[nv++].data = d->Vgrac[TEMP][0][0];
+  s_field[nv].name   = "mugrac";
+  s_field[nv++].data = d->Vgrac[MU][0][0];
+  s_field[nv].name   = "tcool";
+  s_field[nv++].data = d->Vgrac[TCOOL][0][0];
+  #endif
+  s_data.nfields = nv;
+  s_data.fields  = s_field;
+  s_data.step    = g_stepNumber;
+  s_data.time    = g_time;
+  s_data.dt      = g_dt;
+
+/* --------------------------------------------------------
+   3. Initialize the plugin
+   -------------------------------------------------------- */
+
+  if (init != NULL) err = init (&s_data, runtime->insitu_args);
+  #ifdef PARALLEL
+  MPI_Allreduce (MPI_IN_PLACE, &err, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  #endif
+  if (err != 0){
+    print ("! InsituInit(): plugin initialization failed (%d)\n", err);
+    QUIT_PLUTO(1);
+  }
+  print ("> In-situ plugin %s loaded\n", runtime->insitu_lib);
+#else
+  print ("! InsituInit(): in-situ plugins require USE_INSITU = TRUE\n");
+  QUIT_PLUTO(1);
+#endif
+}
+
+/* ********************************************************************* */
+void InsituExecute (void)
+/*!
+ * Update time and step information and call the plugin.
+ * Collective on MPI_COMM_WORLD.
+ *********************************************************************** */
+{
+  int err;
+
+  if (s_execute == NULL) return;
+
+  s_data.step = g_stepNumber;
+  s_data.time = g_time;
+  s_data.dt   = g_dt;
+
+  err = s_execute (&s_data);
+  #ifdef PARALLEL
+  MPI_Allreduce (MPI_IN_PLACE, &err, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  #endif
+  if (err != 0){
+    print ("! InsituExecute(): plugin returned %d\n", err);
+    QUIT_PLUTO(1);
+  }
+}
+
+/* ********************************************************************* */
+void InsituFinalize (void)
+/*!
+ * Call the plugin finalization function, if any.
+ *********************************************************************** */
+{
+  if (s_execute == NULL) return;
+  if (s_finalize != NULL) s_finalize();
+  s_execute = NULL;
+}
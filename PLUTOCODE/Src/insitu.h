@@ -0,0 +1,84 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Interface between PLUTO and in-situ adaptor plugins.
+
+  This header is shared by PLUTO (insitu.c) and by the plugins, which
+  are shared libraries loaded at run time with dlopen() and do not
+  need any other PLUTO header.
+  A plugin exports the following functions (only the second one is
+  mandatory):
+
+  \code
+  int  InsituPluginInit     (const InsituData *, const char *args);
+  int  InsituPluginExecute  (const InsituData *);
+  void InsituPluginFinalize (void);
+  \endcode
+
+  Init is called once, before the first Execute, with the optional
+  arguments given in pluto.ini; Execute is called at the cadence
+  given in pluto.ini and Finalize at the end of the run.
+  A non-zero return value is reported as an error and stops the
+  computation.
+  All functions are called by all processors.
+
+  The InsituData structure gives zero-copy views of PLUTO arrays:
+  each field points to the first element of a contiguous
+  [ntot[2]][ntot[1]][ntot[0]] array of doubles (ghost zones included,
+  x1 running fastest), i.e. zone (i,j,k) of field n is
+  \code
+  fields[n].data[(k*ntot[1] + j)*ntot[0] + i]
+  \endcode
+  and the interior zones are beg[d] <= i <= end[d].
+  Data and coordinates belong to PLUTO and must not be modified or
+  freed; pointers remain valid for the whole run, but the data is
+  only consistent during an Execute call.
+  Ghost zones are not guaranteed to be up to date.
+
+  \date   Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#ifndef INSITU_H
+#define INSITU_H
+
+#define INSITU_VERSION  1   /* Incremented when InsituData changes */
+
+typedef struct InsituField_{
+  const char   *name;    /**< Field name (e.g. "rho", "Tgrac") */
+  const double *data;    /**< First element of the 3D array     */
+} InsituField;
+
+typedef struct InsituData_{
+  int    version;        /**< INSITU_VERSION used by PLUTO */
+  int    rank;           /**< Processor rank */
+  int    nproc;          /**< Number of processors */
+  int    comm;           /**< Fortran handle of the PLUTO communicator
+                              (use MPI_Comm_f2c()), 0 in serial mode */
+  int    dimensions;     /**< Number of dimensions (1, 2 or 3) */
+  int    geometry;       /**< PLUTO geometry label (CARTESIAN = 1, ...) */
+  long   step;           /**< Integration step number */
+  double time;           /**< Simulation time (code units) */
+  double dt;             /**< Current time step */
+  double unit_density;   /**< Code units in c.g.s. */
+  double unit_length;
+  double unit_velocity;
+  int    ntot[3];        /**< Local array sizes, ghost zones included */
+  int    beg[3];         /**< First local interior zone */
+  int    end[3];         /**< Last local interior zone */
+  int    offset[3];      /**< Global index of zone beg[d], starting at 0
+                              in the first interior zone of the domain */
+  int    np_glob[3];     /**< Global number of interior zones */
+  const double *x[3];    /**< Zone centers (local, ghost zones included) */
+  const double *xl[3];   /**< Left zone interfaces */
+  const double *xr[3];   /**< Right zone interfaces */
+  const double *dx[3];   /**< Zone widths */
+  int    nfields;        /**< Number of fields */
+  const InsituField *fields;  /**< Primitive variables followed by
+                                   Grackle fields, if any */
+} InsituData;
+
+typedef int  (*InsituInitFunc)     (const InsituData *, const char *);
+typedef int  (*InsituExecuteFunc)  (const InsituData *);
+typedef void (*InsituFinalizeFunc) (void);
+
+#endif /* INSITU_H */
@@ -32,6 +32,37 @@
   #define DEBUG_FUNC_NAME "Not Set"
 #endif
 
+/*! \name Profiler regions and macros.
+    Open and close a timed region (see profiler.c).
+    The macros expand to nothing unless PROFILER is set to YES.
+*/
+/**@{ */
+#define PROF_INTEGRATE      0
+#define PROF_BOUNDARY       1
+#define PROF_UPDATE_X1      2   /* PROF_UPDATE_X1 + g_dir */
+#define PROF_UPDATE_X2      3
+#define PROF_UPDATE_X3      4
+#define PROF_STATES         5
+#define PROF_RIEMANN        6
+#define PROF_RHS            7
+#define PROF_SPLIT_SOURCE   8
+#define PROF_COOLING        9
+#define PROF_GRACKLE       10
+#define PROF_PARABOLIC     11
+#define PROF_PARTICLES     12
+#define PROF_OUTPUT        13
+#define PROF_ALLREDUCE     14
+#define PROF_NREGIONS      15
+
+#if PROFILER == YES
+  #define PROFILE_BEG(r)  ProfilerStart(r)
+  #define PROFILE_END(r)  ProfilerStop(r)
+#else
+  #define PROFILE_BEG(r)
+  #define PROFILE_END(r)
+#endif
+/**@} */
+
 #define POW2(x)   ((x)*(x))
 #define POW3(x)   ((x)*(x)*(x))
 #define POW4(x)   ((x)*(x)*(x)*(x))
@@ -35,15 +35,13 @@
 #ifndef SHOW_TIME_STEPS
   #define SHOW_TIME_STEPS  YES  /* Show time steps due to different processes */
 #endif
-#ifndef SHOW_TIMING
-  #define SHOW_TIMING      NO  /* Compute CPU timing between steps */
-#endif
 
 static double   NextTimeStep (timeStep *, Runtime *, Grid *);
 static char *TotalExecutionTime (double);
 static int Integrate (Data *, timeStep *, Grid *);
 static void CheckForOutput (Data *, Runtime *, time_t, Grid *);
 static void CheckForAnalysis (Data *, Runtime *, Grid *);
+static void CheckForInsitu (Runtime *);
 
 /* ********************************************************************* */
 int main (int argc, char *argv[])
@@ -150,12 +148,18 @@ int main (int argc, char *argv[])
     #ifdef FARGO
     FARGO_Restart (&data, grd);
     #endif
+    DiagRestart ();
   }else if (cmd_line.h5restart == YES){
     RestartFromFile (&runtime, cmd_line.nrestart, DBL_H5_OUTPUT, grd);
+    DiagRestart ();
   }else if (cmd_line.write){
     CheckForOutput   (&data, &runtime, tbeg, grd);
     CheckForAnalysis (&data, &runtime, grd);
   }
+  InsituInit (&data, &runtime, grd);
+  if (cmd_line.write && cmd_line.restart != YES && cmd_line.h5restart != YES){
+    CheckForInsitu (&runtime);
+  }
 
   if (cmd_line.maxsteps == 0) last_step = 1;
 
@@ -164,7 +168,7 @@ int main (int argc, char *argv[])
    1.  M A I N      L O O P      S T A R T S      H E R E
    ===================================================================== */
 
-  LogFileFlush();
+  LogFileSync();
   while (!last_step){
 
     #if SHOW_TIMING
@@ -200,6 +204,7 @@ int main (int argc, char *argv[])
     if (!first_step && cmd_line.write) {
       if (!last_step) CheckForOutput  (&data, &runtime, tbeg, grd);
       CheckForAnalysis(&data, &runtime, grd);
+      if (!last_step) CheckForInsitu  (&runtime);
     }
 
   /* ----------------------------------------------------
@@ -207,8 +212,13 @@ int main (int argc, char *argv[])
          g_dt = dt(n). After this step U^n -> U^{n+1}
      ---------------------------------------------------- */
 
+    #if ACTIVE_TILES == YES
+    ActiveTilesUpdate (&data, runtime.log_freq, grd);
+    #endif
     if (cmd_line.jet != -1) SetJetDomain (&data, cmd_line.jet, runtime.log_freq, grd); 
+    PROFILE_BEG(PROF_INTEGRATE);
     err = Integrate (&data, &Dts, grd);
+    PROFILE_END(PROF_INTEGRATE);
     if (cmd_line.jet != -1) UnsetJetDomain (&data, cmd_line.jet, grd);
     #if INTERNAL_BOUNDARY == YES
     UserDefBoundary (&data, NULL, 0, grd);
@@ -232,6 +242,7 @@ int main (int argc, char *argv[])
      ------------------------------------------------------ */
   
     #ifdef PARALLEL
+    PROFILE_BEG(PROF_ALLREDUCE);
     MPI_Allreduce (&g_maxMach, &scrh, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
     g_maxMach = scrh;
 
@@ -242,11 +253,15 @@ int main (int argc, char *argv[])
     MPI_Allreduce (&g_maxIMEXIter, &nv, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
     g_maxIMEXIter = nv;
     #endif
+    PROFILE_END(PROF_ALLREDUCE);
     #endif
 
     if (g_stepNumber%runtime.log_freq == 0) {
       OutputLogPost(&data, &Dts, &runtime, grd);
-      LogFileFlush();
+      #if PROFILER == YES
+      ProfilerReport (&runtime);
+      #endif
+      LogFileSync();
     }
 
   /* ----------------------------------------------------
@@ -294,7 +309,10 @@ int main (int argc, char *argv[])
   if ((cmd_line.write) && !(cmd_line.maxsteps == 0)){
     CheckForOutput (&data, &runtime, tbeg, grd);
     CheckForAnalysis (&data, &runtime, grd);
+    CheckForInsitu (&runtime);
   }
+  DiagFlush();
+  InsituFinalize();
 
   #ifdef PARALLEL
   MPI_Barrier (MPI_COMM_WORLD);
@@ -317,6 +335,9 @@ int main (int argc, char *argv[])
   else printLog ("> Average time/step       %10.2e  (sec)  \n",difftime(tend,tbeg));
 
   printLog ("> Local time                %s",asctime(localtime(&tend)));
+  #if PROFILER == YES
+  ProfilerSummary (&runtime);
+  #endif
   printLog ("> Done\n");
 
   #if COOLING==GRACKLE
@@ -324,6 +345,7 @@ int main (int argc, char *argv[])
   finalize_grackle();
   #endif
   FreeArray4D ((void *) data.Vc);
+  SharedTableFree();
   #ifdef PARALLEL
   LogFileClose();
   MPI_Barrier (MPI_COMM_WORLD);
@@ -393,6 +415,8 @@ int Integrate (Data *d, timeStep *Dts, Grid *grid)
     Particles_LP_Update (d, Dts, g_dt, grid);
     #endif
     #endif
+    Boundary (d, ALL_DIR, grid);
+    Particles_BoundaryExchangeEnd(d, grid); /* Complete pending exchange */
     return 0;
   }
 #endif
@@ -478,6 +502,7 @@ double NextTimeStep (timeStep *Dts, Runtime *runtime, Grid *grid)
    -------------------------------------------------------- */
 
 #ifdef PARALLEL
+  PROFILE_BEG(PROF_ALLREDUCE);
   xloc = Dts->invDt_hyp;
   MPI_Allreduce (&xloc, &xglob, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
   Dts->invDt_hyp = xglob;
@@ -500,6 +525,7 @@ double NextTimeStep (timeStep *Dts, Runtime *runtime, Grid *grid)
   MPI_Allreduce (&xloc, &xglob, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
   Dts->omega_particles = xglob;
   #endif
+  PROFILE_END(PROF_ALLREDUCE);
 #endif
 
 /* --------------------------------------------------------
@@ -576,7 +602,7 @@ double NextTimeStep (timeStep *Dts, Runtime *runtime, Grid *grid)
    -------------------------------------------------------- */
 
 #if COOLING != NO
-#ifndef NO_COOL_LIMIT
+#if !(defined NO_COOL_LIMIT) && (COOLING_SUBCYCLE == NO)
   dtnext = MIN(dtnext, Dts->dt_cool);
 #endif
 #endif
@@ -715,7 +741,11 @@ void CheckForOutput (Data *d, Runtime *runtime, time_t t0, Grid *grid)
         Particles_WriteData(d, output, grid);
       } else
       #endif
-      WriteData(d, output, grid);  
+      {
+        PROFILE_BEG(PROF_OUTPUT);
+        WriteData(d, output, grid);  
+        PROFILE_END(PROF_OUTPUT);
+      }
 
     /* ----------------------------------------------------------
         save the file number of the dbl and dbl.h5 output format
@@ -764,3 +794,26 @@ void CheckForAnalysis (Data *d, Runtime *runtime, Grid *grid)
   if (check_dt || check_dn) Analysis (d, grid);
 }
 
+/* ******************************************************************** */
+void CheckForInsitu (Runtime *runtime)
+/*!
+ * Check if the in-situ plugin needs to be called (same criteria
+ * as CheckForAnalysis()).
+ *
+ ********************************************************************** */
+{
+  int check_dt, check_dn;
+  double t, tnext;
+
+  if (runtime->insitu_lib[0] == '\0') return;
+
+  t     = g_time;
+  tnext = t + g_dt;
+  check_dt = (int) (tnext/runtime->insitu_dt) - (int)(t/runtime->insitu_dt);
+  check_dt = check_dt || g_stepNumber == 0 || fabs(t - runtime->tstop) < 1.e-9;
+  check_dt = check_dt && (runtime->insitu_dt > 0.0);
+
+  check_dn = (runtime->insitu_dn > 0) && (g_stepNumber%runtime->insitu_dn) == 0;
+
+  if (check_dt || check_dn) InsituExecute ();
+}
@@ -0,0 +1,175 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Binary index of output files.
+
+  Each time WriteData() dumps a file it appends, next to the text
+  line in <ext>.out, a fixed-size OutputIndex record to the binary
+  file <ext>.idx (e.g. dbl.idx, dbl.h5.idx) in the output directory.
+  The file starts with a header record followed by one record per
+  file number, so that file #n is found at offset
+  (n+1)*sizeof(OutputIndex) without reading the preceding ones.
+
+  The record stores time, step, storage mode, endianity and domain
+  decomposition of the dump, the offset of the corresponding line in
+  <ext>.out (used by WriteData() to append the next line) and, for
+  dbl and dbl.h5 outputs, the record number in restart.out (set by
+  RestartDump()).
+  On restart the index is memory-mapped and read directly; the text
+  files remain a human-readable mirror and are used as a fallback
+  when the index is not available (e.g. runs started by older
+  versions) or was written on an architecture with different
+  endianity.
+
+  Only processor 0 accesses the index.
+
+  \date   Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define IDX_VERSION  1
+
+typedef struct IndexHeader_{
+  char magic[8];      /* "PLUTOIDX" */
+  int  version;
+  int  byte_order;    /* 1 when read with the same endianity */
+  int  record_size;
+} IndexHeader;
+
+/* ********************************************************************* */
+void OutputIndexAppend (Output *output, int mode, long long txt_end,
+                        Grid *grid)
+/*!
+ * Write the record of file number output->nfile.
+ * The index is created when output->nfile = 0 and it is not
+ * updated if it does not exist for later files.
+ *
+ * \param [in] output   pointer to the Output structure
+ * \param [in] mode     one of IDX_SINGLE_FILE, IDX_MULTIPLE_FILES,
+ *                      IDX_SUBFILES
+ * \param [in] txt_end  offset of the end of the line just written
+ *                      to <ext>.out
+ * \param [in] grid     pointer to an array of Grid structures
+ *********************************************************************** */
+{
+  int  nv, dir;
+  char fname[512];
+  char hbuf[sizeof(OutputIndex)];
+  IndexHeader *hdr = (IndexHeader *)hbuf;
+  OutputIndex  rec;
+  FILE *fp;
+
+  sprintf (fname, "%s/%s.idx", output->dir, output->ext);
+  if (output->nfile == 0){
+    fp = fopen (fname, "wb");
+    if (fp == NULL) return;
+    memset (hbuf, 0, sizeof(hbuf));
+    memcpy (hdr->magic, "PLUTOIDX", 8);
+    hdr->version     = IDX_VERSION;
+    hdr->byte_order  = 1;
+    hdr->record_size = sizeof(OutputIndex);
+    fwrite (hbuf, sizeof(hbuf), 1, fp);
+  }else{
+    fp = fopen (fname, "r+b");
+    if (fp == NULL) return;
+    fseek (fp, (long)(output->nfile + 1)*sizeof(OutputIndex), SEEK_SET);
+  }
+
+  memset (&rec, 0, sizeof(OutputIndex));
+  rec.nfile         = output->nfile;
+  rec.mode          = mode;
+  rec.little_endian = IsLittleEndian();
+  rec.nstep         = g_stepNumber;
+  rec.t             = g_time;
+  rec.dt            = g_dt;
+  rec.txt_end       = txt_end;
+  rec.restart       = -1;
+  for (dir = 0; dir < 3; dir++) rec.nproc[dir] = grid->nproc[dir];
+  for (nv = 0; nv < output->nvar; nv++){
+    if (output->dump_var[nv] && !strcmp(output->var_name[nv], "Tgrac")){
+      rec.grackle = 1;
+    }
+  }
+
+  fwrite (&rec, sizeof(OutputIndex), 1, fp);
+  fclose (fp);
+}
+
+/* ********************************************************************* */
+int OutputIndexGet (Output *output, int n, OutputIndex *rec)
+/*!
+ * Read the record of file number n from the memory-mapped index.
+ *
+ * \param [in]  output  pointer to the Output structure
+ * \param [in]  n       the file number; negative values count
+ *                      backwards from the last record (-1 = last).
+ * \param [out] rec     the record
+ *
+ * \return 1 on success, 0 if the index or the record is not
+ *         available (the caller should then use <ext>.out).
+ *********************************************************************** */
+{
+  int    fd, nrec, found = 0;
+  char   fname[512];
+  size_t size = sizeof(OutputIndex);
+  char  *map;
+  struct stat st;
+  IndexHeader *hdr;
+
+  sprintf (fname, "%s/%s.idx", output->dir, output->ext);
+  fd = open (fname, O_RDONLY);
+  if (fd < 0) return 0;
+
+  if (fstat (fd, &st) == 0 && st.st_size >= (off_t)(2*size)){
+    map = (char *) mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map != MAP_FAILED){
+      hdr  = (IndexHeader *)map;
+      nrec = st.st_size/size - 1;
+      if (n < 0) n += nrec;
+      if (   !memcmp(hdr->magic, "PLUTOIDX", 8)
+          && hdr->version == IDX_VERSION && hdr->byte_order == 1
+          && hdr->record_size == (int)size && n >= 0 && n < nrec){
+        memcpy (rec, map + (n + 1)*size, size);
+        found = (rec->nfile == n);
+      }
+      munmap (map, st.st_size);
+    }
+  }
+  close (fd);
+  return found;
+}
+
+/* ********************************************************************* */
+void OutputIndexSetRestart (Output *output, int nrec)
+/*!
+ * Store the restart.out record number in the record of the last
+ * file, provided it was written during the current step.
+ *
+ * \param [in] output  pointer to the dbl or dbl.h5 Output structure
+ * \param [in] nrec    record number in restart.out
+ *********************************************************************** */
+{
+  char  fname[512];
+  long  offset = (long)(output->nfile + 1)*sizeof(OutputIndex);
+  OutputIndex rec;
+  FILE *fp;
+
+  if (output->nfile < 0) return;
+  sprintf (fname, "%s/%s.idx", output->dir, output->ext);
+  fp = fopen (fname, "r+b");
+  if (fp == NULL) return;
+
+  fseek (fp, offset, SEEK_SET);
+  if (   fread (&rec, sizeof(OutputIndex), 1, fp) == 1
+      && rec.nfile == output->nfile && rec.nstep == g_stepNumber){
+    rec.restart = nrec;
+    fseek (fp, offset, SEEK_SET);
+    fwrite (&rec, sizeof(OutputIndex), 1, fp);
+  }
+  fclose (fp);
+}
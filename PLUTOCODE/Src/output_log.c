@@ -6,10 +6,13 @@
   The integration log file is divided into a "pre-step"
   and a "post-step" output.
 
+  In parallel, log files can be buffered in memory and/or collected
+  into a single file (see LOG_BUFFER_SIZE and LOG_WRITERS below).
+
   \authors A. Mignone(mignone@to.infn.it)\n
            B. Vaidya
 
-  \date    Jul 28, 2020
+  \date    Oct 18, 2026
 */
 /* ///////////////////////////////////////////////////////////////////// */
 #include "pluto.h"
@@ -149,20 +152,78 @@ void Particles_Log (Data *data, timeStep *Dts, Grid *grid)
     The next set of functions provides basic functionalities to
      
      - set the log file
-     - formatted output to the log file through the printLog() and printLog()
+     - formatted output to the log file through the print() and printLog()
        functions
+
+    In parallel, the log can be buffered in memory by setting 
+    LOG_BUFFER_SIZE > 0 in definitions.h: the text of each processor
+    is then kept in one of two blocks (of LOG_BUFFER_SIZE bytes) and,
+    when the block is full, it is handed to MPI-IO with a nonblocking
+    write while the other block is filled.
+
+    With LOG_WRITERS > 0, the logs of all processors are collected
+    into the single file "pluto.log" and each line is prefixed with
+    the processor rank.
+    Blocks are written at the collective points given by LogFileSync()
+    (every log_freq steps) as soon as one processor has filled half of
+    its block, using a split collective, ordered write with
+    LOG_WRITERS aggregators (MPI_File_write_ordered_begin/end), so
+    that the write completes in the background.
+    Processor 0 appends the offset and length of each block to
+    "pluto.log.idx" (lines "step rank offset length"), so that the
+    log of a single processor can be extracted without scanning the
+    whole file.
    ///////////////////////////////////////////////////////////////////// */
 
+#if (defined PARALLEL) && (LOG_BUFFER_SIZE > 0 || LOG_WRITERS > 0)
+ #define LOG_BUFFERED  YES
+ #define LOG_BLOCK     (LOG_BUFFER_SIZE > 0 ? LOG_BUFFER_SIZE:65536)
+#else
+ #define LOG_BUFFERED  NO
+#endif
+
+#if LOG_BUFFERED == YES
+static char        *s_block[2];    /* The two log blocks                      */
+static size_t       s_size[2];     /* Allocated size of each block            */
+static size_t       s_len;         /* Bytes used in the current block         */
+static int          s_cur;         /* Index of the current block              */
+static int          s_pending;     /* 1 while the other block is being written */
+static int          s_newline = 1; /* 1 when the next byte starts a new line  */
+static char         s_mode[4];
+static MPI_File     s_fh = MPI_FILE_NULL;
+static MPI_Request  s_req = MPI_REQUEST_NULL;
+
+static void LogBlockAppend (const char *, size_t);
+static void LogBlockWait (void);
+static void LogBlockWrite (void);
+static void LogFileOpenMPI (void);
+static void LogPrint (const char *, va_list);
+#endif
 
 /* ********************************************************************* */
 void LogFileClose(void)
 /*!
- * Close a previously opened log file
+ * Close a previously opened log file.
+ * With buffered logs, write the remaining text first (collective).
  *                           
  *********************************************************************** */
 {
 #ifdef PARALLEL
+  #if LOG_BUFFERED == YES
+  #if LOG_WRITERS > 0
+  long int len = s_len, maxlen;
+
+  LogBlockWait();
+  MPI_Allreduce (&len, &maxlen, 1, MPI_LONG, MPI_MAX, MPI_COMM_WORLD);
+  if (maxlen > 0) LogBlockWrite();
+  #else
+  if (s_len > 0) LogBlockWrite();
+  #endif
+  LogBlockWait();
+  if (s_fh != MPI_FILE_NULL) MPI_File_close (&s_fh);
+  #else
   if (g_flog != NULL) fclose(g_flog);
+  #endif
 #endif
 }
 
@@ -170,11 +231,59 @@ void LogFileClose(void)
 void LogFileFlush(void)
 /*!
  * Flushes the output buffer of a log file stream.
+ * With buffered logs, the current block is written synchronously by
+ * this processor only, so that the function can be called before
+ * aborting.
  *
  *********************************************************************** */
 {
 #ifdef PARALLEL
+  #if LOG_BUFFERED == YES
+  #if LOG_WRITERS > 0
+  if (s_len > 0){   /* -- independent write, not indexed -- */
+    MPI_File_write_shared (s_fh, s_block[s_cur], (int)s_len, MPI_CHAR,
+                           MPI_STATUS_IGNORE);
+    s_len = 0;
+  }
+  #else
+  if (s_len > 0) LogBlockWrite();
+  LogBlockWait();
+  #endif
+  #else
   if (g_flog != NULL) fflush (g_flog);
+  #endif
+#endif
+}
+
+/* ********************************************************************* */
+void LogFileSync(void)
+/*!
+ * Collective point for the log files, called by all processors every
+ * log_freq steps.
+ * Flush the log stream or, with buffered logs, make progress on the
+ * pending write and (LOG_WRITERS > 0) start the collective write of
+ * the current blocks if one of them is half full.
+ *
+ *********************************************************************** */
+{
+#ifdef PARALLEL
+  #if LOG_BUFFERED == YES
+  #if LOG_WRITERS > 0
+  long int len = s_len, maxlen;
+
+  MPI_Allreduce (&len, &maxlen, 1, MPI_LONG, MPI_MAX, MPI_COMM_WORLD);
+  if (maxlen >= LOG_BLOCK/2) LogBlockWrite();
+  #else
+  int done;
+
+  if (s_pending){
+    MPI_Test (&s_req, &done, MPI_STATUS_IGNORE);
+    if (done) s_pending = 0;
+  }
+  #endif
+  #else
+  LogFileFlush();
+  #endif
 #endif
 }
 
@@ -183,16 +292,29 @@ void LogFileOpen(char *log_dir, char *mode)
 /*!
  * Open log file name in parallel mode.
  * Each processor has its own log file "pluto.prank.log", unless the
- * MULTIPLE_LOG_FILES flag has been set to FALSE.
+ * MULTIPLE_LOG_FILES flag has been set to FALSE or LOG_WRITERS > 0
+ * (single file "pluto.log").
  *
- * \param [in] output_dir  the name of the output directory
- * \param [in] cmd         pointer to cmd line option structure.
+ * \param [in] log_dir  the name of the log directory
+ * \param [in] mode     "w" or "a" (for restarts)
  *                           
  *********************************************************************** */
 {
 #ifdef PARALLEL
 
+  #if LOG_WRITERS > 0
+  sprintf (log_file_name, "%s/pluto.log",log_dir);
+  #else
   sprintf (log_file_name, "%s/pluto.%d.log",log_dir,prank);
+  #endif
+
+  #if LOG_BUFFERED == YES
+  strcpy (s_mode, mode);
+  #if LOG_WRITERS == 0 && MULTIPLE_LOG_FILES == NO
+  if (prank != 0) return;   /* -- opened at the first write -- */
+  #endif
+  LogFileOpenMPI();
+  #else
 
   #if MULTIPLE_LOG_FILES == NO
   if (prank != 0) return;
@@ -208,6 +330,7 @@ void LogFileOpen(char *log_dir, char *mode)
     sprintf (log_file_name, "./pluto.%d.log",prank);
     g_flog = fopen(log_file_name, mode);
   }
+  #endif
 #endif
 }
 
@@ -231,7 +354,11 @@ void print (const char *fmt, ...)
   va_start(args, fmt);
 
 #ifdef PARALLEL
+  #if LOG_BUFFERED == YES
+  LogPrint (fmt, args);
+  #else
   vfprintf(g_flog, fmt, args);
+  #endif
 #else
   vprintf(fmt, args);
 #endif
@@ -254,6 +381,10 @@ void printLog (const char *fmt, ...)
 
 #ifdef PARALLEL
 
+  #if LOG_BUFFERED == YES
+  LogPrint (fmt, args);
+  #else
+
   /* --------------------------------------------
       File may not be opened if
       MULTIPLE_LOG_FILES is set to NO.
@@ -263,6 +394,7 @@ void printLog (const char *fmt, ...)
   if (g_flog == NULL)  g_flog = fopen(log_file_name, "a");
   #endif
   vfprintf(g_flog, fmt, args);
+  #endif
 #else
   vprintf(fmt, args);
 #endif
@@ -271,6 +403,185 @@ void printLog (const char *fmt, ...)
 }
 #endif
 
+#if LOG_BUFFERED == YES
+/* ********************************************************************* */
+void LogPrint (const char *fmt, va_list args)
+/*
+ * Format a message into the current log block, prefixing each line
+ * with the processor rank when LOG_WRITERS > 0.
+ * Messages longer than 4 kB are truncated.
+ *********************************************************************** */
+{
+  static char msg[4096];
+  int  n;
+
+  n = vsnprintf (msg, sizeof(msg), fmt, args);
+  if (n < 0) return;
+  n = MIN(n, (int)sizeof(msg) - 1);
+
+  #if LOG_WRITERS > 0
+  {
+    char   prefix[16], *s = msg, *e;
+    int    np = sprintf (prefix, "[%d] ", prank);
+    size_t len;
+
+    while (*s != '\0'){
+      if (s_newline) LogBlockAppend (prefix, np);
+      e   = strchr(s, '\n');
+      len = (e != NULL ? (size_t)(e - s) + 1:strlen(s));
+      LogBlockAppend (s, len);
+      s_newline = (e != NULL);
+      s += len;
+    }
+  }
+  #else
+  LogBlockAppend (msg, n);
+  #endif
+}
+
+/* ********************************************************************* */
+void LogBlockAppend (const char *s, size_t n)
+/*
+ * Copy n bytes to the current block.
+ * A full block is written (one file per processor) or enlarged until
+ * the next collective point (LOG_WRITERS > 0).
+ *********************************************************************** */
+{
+  if (s_block[s_cur] == NULL){
+    s_size[s_cur]  = LOG_BLOCK;
+    s_block[s_cur] = (char *)malloc(s_size[s_cur]);
+  }
+
+  if (s_len + n > s_size[s_cur]){
+    #if LOG_WRITERS == 0
+    if (s_len > 0) LogBlockWrite();  /* -- now s_len = 0 -- */
+    if (s_block[s_cur] == NULL){
+      s_size[s_cur]  = LOG_BLOCK;
+      s_block[s_cur] = (char *)malloc(s_size[s_cur]);
+    }
+    #endif
+    if (s_len + n > s_size[s_cur]){
+      s_size[s_cur]  = MAX(2*s_size[s_cur], s_len + n);
+      s_block[s_cur] = (char *)realloc(s_block[s_cur], s_size[s_cur]);
+    }
+  }
+  memcpy (s_block[s_cur] + s_len, s, n);
+  s_len += n;
+}
+
+/* ********************************************************************* */
+void LogBlockWait (void)
+/*
+ * Complete the write of the other block, if any
+ * (collective when LOG_WRITERS > 0).
+ *********************************************************************** */
+{
+  if (!s_pending) return;
+  #if LOG_WRITERS > 0
+  MPI_File_write_ordered_end (s_fh, s_block[1 - s_cur], MPI_STATUS_IGNORE);
+  #else
+  MPI_Wait (&s_req, MPI_STATUS_IGNORE);
+  #endif
+  s_pending = 0;
+}
+
+/* ********************************************************************* */
+void LogBlockWrite (void)
+/*
+ * Start the write of the current block and switch to the other one
+ * (collective when LOG_WRITERS > 0).
+ *********************************************************************** */
+{
+  LogBlockWait();
+
+  #if LOG_WRITERS > 0
+  {
+    long long pos, blk[2], *all = NULL;
+    MPI_Offset shared;
+    int  p, nproc;
+    FILE *fidx;
+    char fname[600];
+
+  /* -- offset of each block = shared pointer + preceding lengths -- */
+
+    MPI_File_get_position_shared (s_fh, &shared);
+    blk[1] = s_len;
+    MPI_Exscan (blk + 1, &pos, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+    blk[0] = (long long)shared + (prank == 0 ? 0:pos);
+
+    MPI_Comm_size (MPI_COMM_WORLD, &nproc);
+    if (prank == 0) all = (long long *)malloc(2*nproc*sizeof(long long));
+    MPI_Gather (blk, 2, MPI_LONG_LONG, all, 2, MPI_LONG_LONG, 0,
+                MPI_COMM_WORLD);
+    if (prank == 0){
+      sprintf (fname, "%s.idx", log_file_name);
+      fidx = fopen(fname, "a");
+      for (p = 0; p < nproc; p++){
+        if (all[2*p+1] == 0) continue;
+        fprintf (fidx, "%ld %d %lld %lld\n", g_stepNumber, p, all[2*p],
+                 all[2*p+1]);
+      }
+      fclose (fidx);
+      free (all);
+    }
+    MPI_File_write_ordered_begin (s_fh, s_block[s_cur], (int)s_len,
+                                  MPI_CHAR);
+  }
+  #else
+  if (s_fh == MPI_FILE_NULL) LogFileOpenMPI();
+  MPI_File_iwrite (s_fh, s_block[s_cur], (int)s_len, MPI_CHAR, &s_req);
+  #endif
+
+  s_pending = 1;
+  s_cur     = 1 - s_cur;
+  s_len     = 0;
+}
+
+/* ********************************************************************* */
+void LogFileOpenMPI (void)
+/*
+ * Open the log file with MPI-IO: one file per processor or, when
+ * LOG_WRITERS > 0, a single file shared by all processors (collective).
+ *********************************************************************** */
+{
+  int      amode, err;
+  char     str[600];
+  MPI_Comm comm = MPI_COMM_SELF;
+  MPI_Info info = MPI_INFO_NULL;
+
+  amode = MPI_MODE_CREATE | MPI_MODE_WRONLY;
+  if (s_mode[0] == 'a') amode |= MPI_MODE_APPEND;
+
+  #if LOG_WRITERS > 0
+  comm = MPI_COMM_WORLD;
+  if (s_mode[0] == 'w' && prank == 0){
+    sprintf (str, "%s.idx", log_file_name);
+    remove (log_file_name);
+    remove (str);
+  }
+  MPI_Barrier (comm);
+  MPI_Info_create (&info);
+  sprintf (str, "%d", LOG_WRITERS);
+  MPI_Info_set (info, "cb_nodes", str);
+  MPI_Info_set (info, "romio_cb_write", "enable");
+  #endif
+
+  err = MPI_File_open (comm, log_file_name, amode, info, &s_fh);
+  if (err != MPI_SUCCESS){
+    printf ("! LogFileOpen(): %s cannot be written.\n",log_file_name);
+    printf ("  Using current directory instead.\n");
+    #if LOG_WRITERS > 0
+    sprintf (log_file_name, "./pluto.log");
+    #else
+    sprintf (log_file_name, "./pluto.%d.log",prank);
+    #endif
+    MPI_File_open (comm, log_file_name, amode, info, &s_fh);
+  }
+  if (s_mode[0] == 'w') MPI_File_set_size (s_fh, 0);
+  if (info != MPI_INFO_NULL) MPI_Info_free (&info);
+}
+#endif
+
 /* ********************************************************************* */
 char *IndentString()
 /*
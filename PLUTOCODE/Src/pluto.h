@@ -90,12 +90,41 @@
 #define PARTICLES_TAB_OUTPUT  12
 #define PARTICLES_HDF5_OUTPUT  13
 
+#define HIST_OUTPUT     14
+#define PROJ_OUTPUT     15
+#define SUBVOL_OUTPUT   16
+
 #define VTK_VECTOR  5  /* -- any number but NOT 1  -- */
 
+/* ----  Storage mode recorded in the output index (output_index.c) ---- */
+
+#define IDX_SINGLE_FILE     0
+#define IDX_MULTIPLE_FILES  1
+#define IDX_SUBFILES        2
+
+/* ----  Diagnostics labels (see diagnostics.c) ---- */
+
+#define DIAG_SUM    1
+#define DIAG_MEAN   2
+#define DIAG_MIN    3
+#define DIAG_MAX    4
+#define DIAG_HIST   5
+
+#define DIAG_WEIGHT_NONE    0
+#define DIAG_WEIGHT_VOLUME  1
+#define DIAG_WEIGHT_MASS    2
+
+#define DIAG_UNIT       (-1)          /* Constant field equal to 1  */
+#define DIAG_VGRAC(n)   (1000 + (n))  /* Grackle field d->Vgrac[n]  */
+#define DIAG_FUNC_BEG   2000          /* First user-defined field   */
+
 #define MAX_OUTPUT_TYPES 16    /* The max number of allowed data formats
                                   including fluid and particles */     
 #define MAX_OUTPUT_VARS  64    /* The maximum nuber of variables that can be
                                   dumped to disk for a single format. */
+#define MAX_HIST_OUTPUTS  8    /* The max number of histograms in hist output */
+#define MAX_PROJ_OUTPUTS  8    /* The max number of maps in proj output */
+#define MAX_SUBVOL_OUTPUTS 4   /* The max number of sub-volume outputs (sub1, sub2, ...) */
 
 
 #define CONS_ARRAY   0
@@ -363,6 +392,10 @@
  #endif
 #endif
 
+#ifndef ACTIVE_TILES
+ #define ACTIVE_TILES  NO  /**< Skip quiescent tiles (see active_tiles.c) */
+#endif
+
 #ifndef DUST_FLUID
  #define DUST_FLUID   NO
 #endif
@@ -400,6 +433,26 @@
  #define MULTIPLE_LOG_FILES   NO
 #endif
 
+#ifndef LOG_BUFFER_SIZE
+ #define LOG_BUFFER_SIZE      0   /**< When > 0, keep the log of each processor
+                                       in memory blocks of this size (bytes)
+                                       written asynchronously when full
+                                       (see output_log.c) */
+#endif
+
+#ifndef LOG_WRITERS
+ #define LOG_WRITERS          0   /**< When > 0, collect the logs of all
+                                       processors into pluto.log (indexed by
+                                       pluto.log.idx) using this number of
+                                       writer processors */
+#endif
+
+#ifndef PROFILER
+ #define PROFILER             NO  /**< When set to YES, collect wall-clock
+                                       timings of code regions (see 
+                                       profiler.c) */
+#endif
+
 #ifndef RECONSTRUCT_4VEL
  #define RECONSTRUCT_4VEL     NO  /**< When set to YES, reconstruct 4-velocity
                                        rather than 3-velocity (only for RHD and
@@ -430,6 +483,10 @@
   #define SHOCK_FLATTENING     NO
 #endif
 
+#ifndef SHOW_TIMING
+ #define SHOW_TIMING           NO  /**< Compute CPU timing between steps */
+#endif
+
 #ifndef TIME_STEP_CONTROL
  #define TIME_STEP_CONTROL     NO  
 #endif
@@ -481,8 +538,9 @@
 #endif
 
 #if COOLING==GRACKLE
- #define TEMP (0)
- #define MU   (1)
+ #define TEMP  (0)
+ #define MU    (1)
+ #define TCOOL (2)   /* Signed cooling time (code units), 0 if unknown */
 #endif
 
 /*! Define the conversion constant between dimensionless 
@@ -727,7 +785,9 @@ typedef double ****Data_Arr;
  #include "Fargo/fargo.h"           /* FARGO header file */
 #endif
 
-#define FORCED_TURB  NO
+#ifndef FORCED_TURB
+  #define FORCED_TURB  NO
+#endif
 #if FORCED_TURB == YES
   #include "Forced_Turb/forced_turb.h" /* Forced Turb Header file */
 #endif
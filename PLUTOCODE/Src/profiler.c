@@ -0,0 +1,261 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Hierarchical wall-clock profiler.
+
+  Collect wall-clock time spent in selected code regions (boundary
+  conditions, reconstruction, Riemann solver, cooling, output, global
+  reductions, etc.).
+  A region is opened and closed with the PROFILE_BEG() / PROFILE_END()
+  macros, which expand to nothing unless \c PROFILER is set to \c YES
+  in definitions.h.
+  Regions can be nested: time is accumulated separately for each
+  (parent, region) pair so that the same region (e.g. States) is
+  reported under each of the regions it has been called from.
+
+  Every \c log_freq steps ProfilerReport() prints the minimum, average
+  and maximum time across processors spent in each region since the
+  previous report, together with the load imbalance
+  (max/avg - 1).
+  At the end of the computation ProfilerSummary() writes the
+  cumulative figures to \c profile.out in the output directory.
+
+  A monotonic clock is used and no communication takes place outside
+  ProfilerReport() and ProfilerSummary().
+
+  \date   Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+
+#define PROF_MAX_DEPTH  32
+
+static const char *prof_name[PROF_NREGIONS] = {
+  "Integrate", "Boundary", "UpdateStage (x1)", "UpdateStage (x2)",
+  "UpdateStage (x3)", "States", "Riemann", "RightHandSide",
+  "SplitSource", "CoolingSource", "call_grackle", "Parabolic (STS/RKL)",
+  "Particles", "WriteData", "MPI_Allreduce"};
+
+/* -- Row 0 collects top-level regions, row r+1 the children of r -- */
+
+static double prof_time[PROF_NREGIONS+1][PROF_NREGIONS];  /* Since last report */
+static double prof_ncalls[PROF_NREGIONS+1][PROF_NREGIONS];
+static double prof_ttot[PROF_NREGIONS+1][PROF_NREGIONS];  /* Cumulative */
+static double prof_ntot[PROF_NREGIONS+1][PROF_NREGIONS];
+
+static double prof_tbeg[PROF_NREGIONS];
+static int    prof_active[PROF_NREGIONS];
+static int    prof_stack[PROF_MAX_DEPTH];
+static int    prof_depth = 0;
+static long   prof_nreports = 0;
+
+static double ProfilerClock(void);
+static void   ProfilerReduce(double [PROF_NREGIONS+1][PROF_NREGIONS],
+                             double [3][PROF_NREGIONS+1][PROF_NREGIONS]);
+static void   ProfilerPrintTree(FILE *, double [3][PROF_NREGIONS+1][PROF_NREGIONS],
+                                double [PROF_NREGIONS+1][PROF_NREGIONS],
+                                int, int, double);
+
+/* ********************************************************************* */
+double ProfilerClock(void)
+/*!
+ * Return the current value of a monotonic wall clock, in seconds.
+ *********************************************************************** */
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + 1.e-9*(double)ts.tv_nsec;
+}
+
+/* ********************************************************************* */
+void ProfilerStart(int r)
+/*!
+ * Open the region \c r.
+ * Nested calls to an already open region are ignored.
+ *
+ * \param [in] r   the region index (PROF_*)
+ *********************************************************************** */
+{
+  if (prof_active[r]++) return;
+
+  if (prof_depth == PROF_MAX_DEPTH){
+    printLog ("! ProfilerStart(): max depth exceeded\n");
+    QUIT_PLUTO(1);
+  }
+  prof_stack[prof_depth++] = r;
+  prof_tbeg[r] = ProfilerClock();
+}
+
+/* ********************************************************************* */
+void ProfilerStop(int r)
+/*!
+ * Close the region \c r and add the elapsed time to the
+ * (parent, region) counter.
+ *
+ * \param [in] r   the region index (PROF_*)
+ *********************************************************************** */
+{
+  int parent;
+  double dt;
+
+  if (--prof_active[r]) return;
+
+  dt = ProfilerClock() - prof_tbeg[r];
+
+  prof_depth--;
+  if (prof_stack[prof_depth] != r){
+    printLog ("! ProfilerStop(): region '%s' closed while '%s' is open\n",
+              prof_name[r], prof_name[prof_stack[prof_depth]]);
+    QUIT_PLUTO(1);
+  }
+  parent = (prof_depth > 0 ? prof_stack[prof_depth-1] + 1:0);
+
+  prof_time[parent][r]   += dt;
+  prof_ncalls[parent][r] += 1.0;
+}
+
+/* ********************************************************************* */
+void ProfilerReduce(double t[PROF_NREGIONS+1][PROF_NREGIONS],
+                    double tred[3][PROF_NREGIONS+1][PROF_NREGIONS])
+/*!
+ * Compute min, average and max of the local timings \c t across
+ * processors and store them in \c tred[0], \c tred[1], \c tred[2].
+ *********************************************************************** */
+{
+  int p, r;
+  int nrow = (PROF_NREGIONS+1)*PROF_NREGIONS;
+
+#ifdef PARALLEL
+  int nprocs;
+  MPI_Comm_size (MPI_COMM_WORLD, &nprocs);
+  MPI_Allreduce (t[0], tred[0][0], nrow, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+  MPI_Allreduce (t[0], tred[1][0], nrow, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  MPI_Allreduce (t[0], tred[2][0], nrow, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+  for (p = 0; p <= PROF_NREGIONS; p++){
+  for (r = 0; r <  PROF_NREGIONS; r++){
+    tred[1][p][r] /= (double)nprocs;
+  }}
+#else
+  for (p = 0; p <= PROF_NREGIONS; p++){
+  for (r = 0; r <  PROF_NREGIONS; r++){
+    tred[0][p][r] = tred[1][p][r] = tred[2][p][r] = t[p][r];
+  }}
+#endif
+}
+
+/* ********************************************************************* */
+void ProfilerReport(Runtime *runtime)
+/*!
+ * Print min/avg/max time (across processors) spent in each region
+ * since the last report, and add it to the cumulative counters.
+ * This function is collective.
+ *
+ * \param [in] runtime   pointer to the Runtime structure
+ *********************************************************************** */
+{
+  int    p, r;
+  static double tint[3][PROF_NREGIONS+1][PROF_NREGIONS];
+  double tstep;
+  char  *str = IndentString();
+
+  ProfilerReduce(prof_time, tint);
+
+/* --------------------------------------------------------
+   1. Accumulate and reset interval counters
+   -------------------------------------------------------- */
+
+  for (p = 0; p <= PROF_NREGIONS; p++){
+  for (r = 0; r <  PROF_NREGIONS; r++){
+    prof_ttot[p][r]   += prof_time[p][r];
+    prof_ntot[p][r]   += prof_ncalls[p][r];
+    prof_time[p][r]    = 0.0;
+    prof_ncalls[p][r]  = 0.0;
+  }}
+  prof_nreports++;
+
+/* --------------------------------------------------------
+   2. Print region tree
+   -------------------------------------------------------- */
+
+  tstep = 0.0;
+  for (r = 0; r < PROF_NREGIONS; r++) tstep += tint[1][0][r];
+  if (tstep <= 0.0) return;
+
+  printLog ("%s [profiler] %-28s %10s %10s %10s %7s\n", str, "region",
+            "min (s)", "avg (s)", "max (s)", "imb(%)");
+  ProfilerPrintTree(NULL, tint, NULL, 0, 0, tstep);
+}
+
+/* ********************************************************************* */
+void ProfilerSummary(Runtime *runtime)
+/*!
+ * Write cumulative timings (min/avg/max across processors) to
+ * \c profile.out in the output directory.
+ * This function is collective.
+ *
+ * \param [in] runtime   pointer to the Runtime structure
+ *********************************************************************** */
+{
+  int   r;
+  char  fname[512];
+  static double ttot[3][PROF_NREGIONS+1][PROF_NREGIONS];
+  double tsum;
+  FILE *fp;
+
+  ProfilerReport(runtime);   /* Flush the last interval */
+  ProfilerReduce(prof_ttot, ttot);
+
+  if (prank != 0) return;
+
+  tsum = 0.0;
+  for (r = 0; r < PROF_NREGIONS; r++) tsum += ttot[1][0][r];
+
+  sprintf (fname, "%s/profile.out", runtime->output_dir);
+  fp = fopen(fname, "w");
+  if (fp == NULL){
+    printLog ("! ProfilerSummary(): cannot open %s\n", fname);
+    return;
+  }
+  fprintf (fp, "# PLUTO profiler summary\n");
+  fprintf (fp, "# steps = %ld, reports = %ld\n", g_stepNumber, prof_nreports);
+  fprintf (fp, "# %-30s %12s %12s %12s %7s %7s %12s\n", "region",
+           "min (s)", "avg (s)", "max (s)", "imb(%)", "frac(%)", "calls(p0)");
+  ProfilerPrintTree(fp, ttot, prof_ntot, 0, 0, tsum);
+  fclose(fp);
+}
+
+/* ********************************************************************* */
+void ProfilerPrintTree(FILE *fp, double t[3][PROF_NREGIONS+1][PROF_NREGIONS],
+                       double n[PROF_NREGIONS+1][PROF_NREGIONS],
+                       int row, int level, double ttot)
+/*!
+ * Recursively print regions that have been called from the region
+ * corresponding to \c row (0 = top level).
+ * When \c fp is NULL, print to the log file.
+ *********************************************************************** */
+{
+  int  r;
+  char label[64];
+  double tavg, imb;
+
+  if (level >= PROF_MAX_DEPTH) return;
+
+  for (r = 0; r < PROF_NREGIONS; r++){
+    tavg = t[1][row][r];
+    if (tavg <= 0.0 && (n == NULL || n[row][r] == 0.0)) continue;
+
+    sprintf (label, "%*s%s", 2*level, "", prof_name[r]);
+    imb = (tavg > 0.0 ? 100.0*(t[2][row][r]/tavg - 1.0):0.0);
+
+    if (fp == NULL){
+      printLog ("%s [profiler] %-28s %10.3e %10.3e %10.3e %7.1f\n",
+                IndentString(), label, t[0][row][r], tavg, t[2][row][r], imb);
+    }else{
+      fprintf (fp, "  %-30s %12.5e %12.5e %12.5e %7.1f %7.2f %12.0f\n",
+               label, t[0][row][r], tavg, t[2][row][r], imb,
+               100.0*tavg/ttot, n[row][r]);
+    }
+    if (r + 1 != row) ProfilerPrintTree(fp, t, n, r + 1, level + 1, ttot);
+  }
+}
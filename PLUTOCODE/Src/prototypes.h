@@ -2,6 +2,11 @@
    PLUTO function prototypes
    ********************************************************************* */
 
+int    ActiveTilesBoundary (int, int);
+int    ActiveTilesCell (int, int, int);
+double ActiveTilesInvDt (double ***);
+int    ActiveTilesRow (int, int, int, int, int *, int *);
+void   ActiveTilesUpdate (const Data *, int, Grid *);
 int    AdvanceStep(Data *, timeStep *, Grid *);
 void   AdvectFlux (const Sweep *, int, int, Grid *);
 void   AMR_StoreFlux (double **, double **, int, int, int, int, int, Grid *);
@@ -36,6 +41,19 @@ void   ConsToPrim3D(Data_Arr, Data_Arr, unsigned char ***, RBox *);
 void   CreateImage (char *);
 void   ComputeEntropy (const Data *, Grid *);
 
+int    DiagAdd (const char *, int, int, int);
+int    DiagAddHistogram (const char *, int, double, double, int, int,
+                         int, double, double, int, int, int);
+void   DiagCompute (const Data *, Grid *);
+int    DiagFieldFunction (DiagFieldFunc);
+void   DiagFlush (void);
+double DiagGet (int);
+double *DiagGetHistogram (int);
+void   DiagHistogramRow (const double *, const double *, const double *,
+                         const double *, const double *, const int *,
+                         const int *, double *);
+void   DiagRestart (void);
+
 void   EntropySwitch(const Data *, Grid *);
 #ifdef CHOMBO
 void error (const char *fmt, ...);  /* Used to quit pluto only (flush buffer) */
@@ -76,6 +94,8 @@ double  *GetInverse_dl (const Grid *);
 int      GetNghost (void);
 void     GetNeighbourRanks (Grid *, int **);
 void     GetOutputFrequency(Output *, const char *);
+int      GetOutputQuantityIndex (Output *, const char *);
+double  *GetOutputQuantityRow (const Data *, Output *, int, int, int, double *);
 int      GetOutputVarNames(int, char *var_names[NVAR]);
 double  ***GetUserVar (char *);
 void   GnuplotSetting(Runtime *, Grid *);
@@ -89,6 +109,7 @@ int    LocateIndex(double *, int, int, double);
 void   LogFileClose(void);
 void   LogFileFlush(void);
 void   LogFileOpen (char *, char *);
+void   LogFileSync(void);
 
 char  *IndentString();
 void   Init (double *, double, double, double);
@@ -100,6 +121,10 @@ void   InputDataGridSize (int, int *);
 double InputDataInterpolate (int, double, double, double);
 int    InputDataOpen(char *, char *, char *, long int, int);
 void   InputDataReadSlice(int, int);
+void   InputDataSetGrid (Grid *);
+void   InsituExecute (void);
+void   InsituFinalize (void);
+void   InsituInit (Data *, Runtime *, Grid *);
 int    IsLittleEndian (void);
 
 double MP5_States(double *, int, int);
@@ -121,6 +146,9 @@ double MeanMolecularWeight(double *);
 double Median (double a, double b, double c);
 
 void   OutflowBoundary(double ***, RBox *, int);
+void   OutputIndexAppend (Output *, int, long long, Grid *);
+int    OutputIndexGet    (Output *, int, OutputIndex *);
+void   OutputIndexSetRestart (Output *, int);
 void   OutputLogPre  (Data *, timeStep *, Runtime *, Grid *);
 void   OutputLogPost (Data *, timeStep *, Runtime *, Grid *);
 
@@ -134,12 +162,17 @@ int    ParamFileRead    (char *);
 char  *ParamFileGet     (const char *, int );
 int    ParamExist       (const char *);
 int    ParamFileHasBoth (const char *, const char *);
+int    ParamFileNWords  (const char *);
 void   PeriodicBoundary (double ***, RBox *, int);
 void   PolarAxisBoundary(const Data *, RBox *, int);
 
 void   PrimToChar (double **, double *, double *); 
 void   PrimToCons3D(Data_Arr, Data_Arr, RBox *);
 void   PrintColumnLegend(char *legend[], int, FILE *);
+void   ProfilerReport(Runtime *);
+void   ProfilerStart(int);
+void   ProfilerStop(int);
+void   ProfilerSummary(Runtime *);
 
 void   RBoxCopy (RBox *, Data_Arr, Data_Arr, int, char);
 void   RBoxDefine(int, int, int, int, int, int, int, RBox *);
@@ -147,6 +180,7 @@ void   RBoxEnlarge(RBox *, int, int, int);
 void   RBoxSetDirections(RBox *, int);
 void   RBoxShow(RBox *);
 void   ReadHDF5 (Output *output, Grid *grid);
+void   ReadSubfiles (Output *, int, Grid *);
 void   ReflectiveBoundary(double ***, int, int, RBox *, int);
 void   ResetState (const Data *, Sweep *, Grid *);
 void   RestartFromFile (Runtime *, int, int, Grid *);
@@ -183,6 +217,10 @@ void   SetOutput (Data *d, Runtime *input);
 void   SetVectorIndices (int);
 int    SetOutputVar (char *, int, int);
 Riemann_Solver *SetSolver (const char *);
+double *SharedTableAlloc (long int, long int *);
+int    SharedTableBuilder (void);
+void   SharedTableFree (void);
+void   SharedTableSync (void);
 void   Show (double **, int);
 void   ShowConfig(int, char *a[], char *);
 void   ShowMatrix(double **, int, double);
@@ -210,9 +248,12 @@ void  Where (int, Grid *);
 void  WriteAsciiFile (char *, double *, int);
 void  WriteData (const Data *, Output *, Grid *);
 void  WriteHDF5        (Output *output, Grid *grid);
-void  WriteVTK_Header (FILE *, Grid *);
-void  WriteVTK_Vector (FILE *, Data_Arr, double, char *, Grid *);
-void  WriteVTK_Scalar (FILE *, double ***, double, char *, Grid *);
+void  WriteHistograms  (const Data *, Output *, char *, Grid *);
+void  WriteProjections (const Data *, Output *, char *, Grid *);
+void  WriteSubfiles (Output *, Grid *);
+void  WriteSubVolume (Output *, double *, char *, Grid *);
+void  WriteVTK_Header (Grid *);
+void  WriteVTK_Stream (Output *, int, double *, char *, Grid *);
 void  WriteVTKProcFile (double ***, int, int, int, char *);
 void  WriteTabArray (Output *, char *, Grid *);
 void  WritePPM (double ***, char *, char *, Grid *);
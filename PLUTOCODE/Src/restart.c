@@ -6,6 +6,9 @@
   This file collects the necessary functions for restarting PLUTO 
   from a double precision binary or HDF5 file in the static grid
   version of the code.
+  The file to restart from is located through the binary output
+  index (output_index.c) when available, or by parsing dbl.out /
+  dbl.h5.out and scanning restart.out otherwise.
 
   \author A. Mignone (mignone@to.infn.it)
   \date   Apr 15, 2021
@@ -13,6 +16,13 @@
 /* ///////////////////////////////////////////////////////////////////// */
 #include "pluto.h"
 
+static void RestartReadDBL (Output *, int, int, Grid *);
+static int counter = -1;   /* Current record in restart.out */
+#if COOLING == GRACKLE
+static void GrackleParamsDump  (Runtime *, int);
+static void GrackleParamsCheck (Runtime *, int, int);
+#endif
+
 /* *********************************************************************  */
 void RestartFromFile (Runtime *ini, int nrestart, int type, Grid *grid)
 /*!
@@ -26,13 +36,17 @@ void RestartFromFile (Runtime *ini, int nrestart, int type, Grid *grid)
  *
  ***********************************************************************  */
 {
-  int     nv, single_file, origin, nlines=0;
-  int     swap_endian=0;
+  int     nv, origin, nlines=0;
+  int     swap_endian=0, subfiles=0;
+  int     ngrac = -1, has_grac = 1;
   int     dummy;
-  char    fname[512], fout[512], str[512];
+  char    fout[512], str[512], mode[512];
+  #if COOLING == GRACKLE
+  char    vars[512];   /* -- variable names, kept apart from str -- */
+  #endif
   double  dbl;
-  void   *Vpt;
   Output *output;
+  OutputIndex rec;
   FILE   *fbin;
 
 /* --------------------------------------------------------
@@ -47,12 +61,25 @@ void RestartFromFile (Runtime *ini, int nrestart, int type, Grid *grid)
 
 /* --------------------------------------------------------
    2. Compare the endianity of the restart file (by reading
-      the corresponding entry in dbl.out or dbl.h5.out) 
+      the corresponding entry in dbl.idx / dbl.h5.idx or,
+      if not available, in dbl.out / dbl.h5.out) 
       with that of the current architecture.
       Turn swap_endian to 1 if they're different.
+      A negative nrestart counts backwards from the last
+      file and is converted to the actual file number.
    -------------------------------------------------------- */
 
-  if (prank == 0){
+  if (prank == 0 && OutputIndexGet (output, nrestart, &rec)){
+    nrestart    = rec.nfile;
+    subfiles    = (rec.mode == IDX_SUBFILES);
+    swap_endian = (rec.little_endian != IsLittleEndian());
+    counter     = rec.restart;    /* -1 if unknown */
+    #if COOLING == GRACKLE
+    has_grac    = rec.grackle;
+    sprintf (fout,"%s/%s.idx",output->dir, output->ext);
+    #endif
+    if (swap_endian) print ("> RestartFromFile(): endianity is reversed\n");
+  }else if (prank == 0){
     if (type == DBL_OUTPUT) {
       sprintf (fout,"%s/dbl.out",ini->output_dir);
       fbin = fopen (fout, "r");
@@ -73,8 +100,18 @@ void RestartFromFile (Runtime *ini, int nrestart, int type, Grid *grid)
       QUIT_PLUTO(1);
     }
     origin = (nrestart >= 0 ? nrestart:(nlines+nrestart));
+    if (origin < 0){
+      print ("! RestartFromFile(): output #%d does not exist in file %s\n",
+             nrestart, fout);
+      QUIT_PLUTO(1);
+    }
+    nrestart = origin;
     for (nv = origin; nv--;   ) while ( fgetc(fbin) != '\n'){}
-    dummy = fscanf(fbin, "%d  %lf  %lf  %d  %s  %s\n",&nv, &dbl, &dbl, &nv, str, str);
+    dummy = fscanf(fbin, "%d  %lf  %lf  %d  %s  %s\n",&nv, &dbl, &dbl, &nv, mode, str);
+    subfiles = (strcmp(mode,"subfiles") == 0);
+    #if COOLING == GRACKLE
+    if (fgets(vars, 512, fbin) != NULL) has_grac = (strstr(vars, " Tgrac ") != NULL);
+    #endif
     if ( (!strcmp(str,"big")    &&  IsLittleEndian()) ||
          (!strcmp(str,"little") && !IsLittleEndian())) {
       swap_endian = 1;
@@ -82,8 +119,18 @@ void RestartFromFile (Runtime *ini, int nrestart, int type, Grid *grid)
     }
     fclose(fbin);
   }
+  #if COOLING == GRACKLE
+  if (prank == 0 && !has_grac){
+    print ("! RestartFromFile(): Tgrac/mugrac not found in %s,\n", fout);
+    print ("!                    Grackle temperature and mu will be reset\n");
+    print ("!                    at the first integration step\n");
+  }
+  #endif
   #ifdef PARALLEL
+  MPI_Bcast (&nrestart, 1, MPI_INT, 0, MPI_COMM_WORLD);
   MPI_Bcast (&swap_endian, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  MPI_Bcast (&subfiles, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  MPI_Bcast (&has_grac, 1, MPI_INT, 0, MPI_COMM_WORLD);
   #endif
 
 /* --------------------------------------------------------
@@ -91,18 +138,68 @@ void RestartFromFile (Runtime *ini, int nrestart, int type, Grid *grid)
    -------------------------------------------------------- */
 
   RestartGet (ini, nrestart, type, swap_endian);
+
+/* --------------------------------------------------------
+   4. Checkpoints written before Grackle derived fields
+       were dumped: exclude them while reading.
+   -------------------------------------------------------- */
+
+  #if COOLING == GRACKLE
+  for (nv = 0; nv < output->nvar; nv++){
+    if (strcmp(output->var_name[nv], "Tgrac") == 0) ngrac = nv;
+  }
+  if (!has_grac && ngrac >= 0){
+    output->dump_var[ngrac] = output->dump_var[ngrac+1] = NO;
+  }
+  #endif
+
   if (type == DBL_H5_OUTPUT){
     #ifdef USE_HDF5
     ReadHDF5 (output, grid);
     #endif
-    return;
+  }else{
+    RestartReadDBL (output, subfiles, swap_endian, grid);
   }
 
+  #if COOLING == GRACKLE
+  if (ngrac >= 0) output->dump_var[ngrac] = output->dump_var[ngrac+1] = YES;
+  #endif
+}
+
+/* *********************************************************************  */
+static void RestartReadDBL (Output *output, int subfiles, int swap_endian,
+                            Grid *grid)
+/*!
+ * Read double precision binary data (.dbl) for restart.
+ *
+ * \param [in] output       pointer to the dbl Output structure
+ * \param [in] subfiles     1 if data was written using subfiles
+ * \param [in] swap_endian  swap endianity if set to 1
+ * \param [in] grid         pointer to an array of Grid structures
+ *
+ *********************************************************************** */
+{
+  int     nv, single_file;
+  char    fname[512];
+  void   *Vpt;
+  FILE   *fbin;
+
   print ("> Restarting from file #%d (dbl)\n",output->nfile);
   single_file = strcmp(output->mode,"single_file") == 0;
+
+/* --------------------------------------------------------
+   1. Subfile checkpoints are recognized from the mode
+       recorded in dbl.out, regardless of the current
+       setting in pluto.ini.
+   -------------------------------------------------------- */
+
+  if (subfiles){
+    ReadSubfiles (output, swap_endian, grid);
+    return;
+  }
   
 /* --------------------------------------------------------
-   4. For .dbl output, read data from disk
+   2. Read data from single or multiple files
    -------------------------------------------------------- */
 
   if (single_file){ 
@@ -179,7 +276,6 @@ void RestartFromFile (Runtime *ini, int nrestart, int type, Grid *grid)
 
 }
 
-static int counter = -1;
 /* ********************************************************************* */
 void RestartGet (Runtime *ini, int nrestart, int out_type, int swap_endian)
 /*!
@@ -204,6 +300,8 @@ void RestartGet (Runtime *ini, int nrestart, int out_type, int swap_endian)
     nfile = nrestart.
     counter will contain the line number where this
     occurs. Processor 0 does the actual reading.
+    If the record number is already known from the
+    output index, it is read directly.
    ------------------------------------------------- */
 
   if (prank == 0) {
@@ -214,6 +312,17 @@ void RestartGet (Runtime *ini, int nrestart, int out_type, int swap_endian)
       QUIT_PLUTO(1);
     }
 
+    if (counter >= 0){
+      fseek (fr, counter*sizeof(Restart), SEEK_SET);
+      if (fread (&restart, sizeof (Restart), 1, fr) != 1) counter = -1;
+      for (n = 0; n < MAX_OUTPUT_TYPES; n++){
+        if (swap_endian) SWAP_VAR(restart.nfile[n]);
+        if (ini->output[n].type == out_type && restart.nfile[n] != nrestart){
+          counter = -1;   /* -- index out of date: scan the file -- */
+        }
+      }
+    }
+
     origin = (nrestart < 0 ? SEEK_END:SEEK_SET);
     k = 0;
     while (counter == -1){
@@ -237,6 +346,9 @@ void RestartGet (Runtime *ini, int nrestart, int out_type, int swap_endian)
       SWAP_VAR(restart.dt);
       SWAP_VAR(restart.nstep);
     }
+    #if COOLING == GRACKLE
+    GrackleParamsCheck (ini, counter, swap_endian);
+    #endif
   }
 
 /* printf ("counter = %d\n",counter); */
@@ -249,6 +361,10 @@ void RestartGet (Runtime *ini, int nrestart, int out_type, int swap_endian)
   g_dt         = restart.dt;
   g_stepNumber = restart.nstep;
 
+#if FORCED_TURB == YES
+  ForcedTurb_StateRead (ini, counter, swap_endian);
+#endif
+
   for (n = 0; n < MAX_OUTPUT_TYPES; n++){
     ini->output[n].nfile = restart.nfile[n];
   }
@@ -300,5 +416,118 @@ void RestartDump (Runtime *ini)
 
     fwrite (&restart, sizeof(Restart), 1, fr);
     fclose(fr);
+
+  /* -- store the record number in the dbl and dbl.h5 indexes -- */
+
+    for (n = 0; n < MAX_OUTPUT_TYPES; n++){
+      if (   ini->output[n].type == DBL_OUTPUT
+          || ini->output[n].type == DBL_H5_OUTPUT){
+        OutputIndexSetRestart (ini->output + n, counter);
+      }
+    }
+    #if COOLING == GRACKLE
+    GrackleParamsDump (ini, counter);
+    #endif
+    #if FORCED_TURB == YES
+    ForcedTurb_StateDump (ini, counter);
+    #endif
   }
 }
+
+#if COOLING == GRACKLE
+/* ********************************************************************* */
+void GrackleParamsDump (Runtime *ini, int nrec)
+/*!
+ * Write Grackle runtime parameters to "grackle.out", one record
+ * per restart.out entry, so that they can be checked on restart.
+ *
+ *********************************************************************** */
+{
+  char fout[512];
+  FILE *fr;
+
+  sprintf (fout,"%s/grackle.out",ini->output_dir);
+  if (nrec == 0) {
+    fr = fopen (fout, "wb");
+  }else {
+    fr = fopen (fout, "r+b");
+    if (fr == NULL) fr = fopen (fout, "wb");
+    fseek (fr, nrec*sizeof(grackle_params), SEEK_SET);
+  }
+  fwrite (&g_grackle_params, sizeof(grackle_params), 1, fr);
+  fclose(fr);
+}
+
+/* ********************************************************************* */
+void GrackleParamsCheck (Runtime *ini, int nrec, int swap_endian)
+/*!
+ * Compare the Grackle parameters saved with the checkpoint with
+ * the current ones.
+ * A different chemistry network changes the set of variables in the
+ * checkpoint and is a fatal error; other differences are reported.
+ *
+ *********************************************************************** */
+{
+  int  nbad = 0;
+  char fout[512];
+  grackle_params gp, *cp = &g_grackle_params;
+  FILE *fr;
+
+  sprintf (fout,"%s/grackle.out",ini->output_dir);
+  fr = fopen (fout, "rb");
+  if (fr == NULL){
+    print ("! GrackleParamsCheck(): cannot find grackle.out, ");
+    print ("parameters not checked\n");
+    return;
+  }
+  fseek (fr, nrec*sizeof(grackle_params), SEEK_SET);
+  if (fread (&gp, sizeof(grackle_params), 1, fr) != 1){
+    print ("! GrackleParamsCheck(): record #%d not found in grackle.out\n", nrec);
+    fclose(fr);
+    return;
+  }
+  fclose(fr);
+
+  if (swap_endian){
+    SWAP_VAR(gp.grackle_primordial_chemistry);
+    SWAP_VAR(gp.grackle_dust_chemistry);
+    SWAP_VAR(gp.grackle_metal_cooling);
+    SWAP_VAR(gp.grackle_UVbackground);
+    SWAP_VAR(gp.grackle_use_temperature_floor);
+    SWAP_VAR(gp.grackle_temperature_floor_scalar);
+  }
+
+  if (   gp.grackle_primordial_chemistry != cp->grackle_primordial_chemistry
+      || gp.grackle_metal_cooling        != cp->grackle_metal_cooling){
+    print ("! GrackleParamsCheck(): chemistry network differs from checkpoint\n");
+    print ("!   primordial_chemistry = %d (checkpoint: %d)\n",
+            cp->grackle_primordial_chemistry, gp.grackle_primordial_chemistry);
+    print ("!   metal_cooling        = %d (checkpoint: %d)\n",
+            cp->grackle_metal_cooling, gp.grackle_metal_cooling);
+    QUIT_PLUTO(1);
+  }
+
+  if (gp.grackle_dust_chemistry != cp->grackle_dust_chemistry){
+    print ("! GrackleParamsCheck(): dust_chemistry changed (%d -> %d)\n",
+            gp.grackle_dust_chemistry, cp->grackle_dust_chemistry);
+    nbad++;
+  }
+  if (gp.grackle_UVbackground != cp->grackle_UVbackground){
+    print ("! GrackleParamsCheck(): UVbackground changed (%d -> %d)\n",
+            gp.grackle_UVbackground, cp->grackle_UVbackground);
+    nbad++;
+  }
+  if (   gp.grackle_use_temperature_floor != cp->grackle_use_temperature_floor
+      || gp.grackle_temperature_floor_scalar
+         != cp->grackle_temperature_floor_scalar){
+    print ("! GrackleParamsCheck(): temperature floor changed\n");
+    nbad++;
+  }
+  if (strcmp(gp.grackle_data_file, cp->grackle_data_file)){
+    print ("! GrackleParamsCheck(): data file changed\n");
+    print ("!   %s -> %s\n", gp.grackle_data_file, cp->grackle_data_file);
+    nbad++;
+  }
+  if (nbad == 0) print ("> GrackleParamsCheck(): parameters match checkpoint\n");
+}
+#endif
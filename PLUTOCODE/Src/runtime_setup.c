@@ -18,6 +18,10 @@
 #define COMPARE(s1,s2,ii) \
         for ( (ii) = 1 ; (ii) < NOPT && !(strcmp ( (s1), (s2)) == 0); (ii)++);
 
+static Output *NewOutput (Runtime *, int *);
+static void HistDefRead (const char *, HistDef *);
+static void ProjDefRead (const char *, ProjDef *);
+
 /* ********************************************************************* */
 int RuntimeSetup (Runtime *runtime, cmdLine *cmd_line, char *ini_file)
 /*!
@@ -32,7 +36,7 @@ int RuntimeSetup (Runtime *runtime, cmdLine *cmd_line, char *ini_file)
  *
  *********************************************************************** */
 {
-  int    idim, ip, ipos, itype, nlines, dummy;
+  int    idim, ip, ipos, itype, nlines, dummy, nw;
   int    include_dir[] = {INCLUDE_IDIR, INCLUDE_JDIR, INCLUDE_KDIR};
   char   *bound_opt[NOPT], str_var[512], *str;
   char  *glabel[]     = {"X1-grid", "X2-grid","X3-grid"};
@@ -237,23 +241,24 @@ printf ("%f  %d %s\n",runtime->patch_left_node[idim][ip],runtime->patch_npoint[i
   
   ipos = 0;
 
-  output = runtime->output + (ipos++);
+  output = NewOutput (runtime, &ipos);
   output->type  = DBL_OUTPUT;
   output->cgs   = 0;  /* cannot write .dbl using cgs units */
   GetOutputFrequency(output, "dbl");
 
   strcpy (output->mode, ParamFileGet("dbl",3));
   if (   strcmp(output->mode,"single_file")
-      && strcmp(output->mode,"multiple_files")){
+      && strcmp(output->mode,"multiple_files")
+      && strcmp(output->mode,"subfiles")){
      printf (
-     "! RuntimeSetup(): expecting 'single_file' or 'multiple_files' in dbl output\n");
+     "! RuntimeSetup(): expecting 'single_file', 'multiple_files' or 'subfiles' in dbl output\n");
      QUIT_PLUTO(1);
   }     
 
  /* ---- flt output ---- */
 
   if (ParamExist("flt")){
-    output = runtime->output + (ipos++);
+    output = NewOutput (runtime, &ipos);
     output->type  = FLT_OUTPUT;
     GetOutputFrequency(output, "flt");
 
@@ -271,13 +276,13 @@ printf ("%f  %d %s\n",runtime->patch_left_node[idim][ip],runtime->patch_npoint[i
  /* -- hdf5 output -- */
 
   if (ParamExist("dbl.h5")){
-    output = runtime->output + (ipos++);
+    output = NewOutput (runtime, &ipos);
     output->type  = DBL_H5_OUTPUT;
     output->cgs   = 0;  /* cannot write .h5 using cgs units */
     GetOutputFrequency(output, "dbl.h5");
   }
   if (ParamExist("flt.h5")){
-    output = runtime->output + (ipos++);
+    output = NewOutput (runtime, &ipos);
     output->type  = FLT_H5_OUTPUT;
     output->cgs   = 0;  /* cannot write .h5 using cgs units */
     GetOutputFrequency(output, "flt.h5");
@@ -286,7 +291,7 @@ printf ("%f  %d %s\n",runtime->patch_left_node[idim][ip],runtime->patch_npoint[i
  /* -- vtk output -- */
 
   if (ParamExist ("vtk")){
-    output = runtime->output + (ipos++);
+    output = NewOutput (runtime, &ipos);
     output->type  = VTK_OUTPUT;
     GetOutputFrequency(output, "vtk");
 
@@ -303,12 +308,13 @@ printf ("%f  %d %s\n",runtime->patch_left_node[idim][ip],runtime->patch_npoint[i
     }
     if (ParamFileHasBoth ("vtk","cgs")) output->cgs = 1;
     else                                output->cgs = 0;
+    output->xdmf = ParamFileHasBoth ("vtk","xdmf");
   }
 
  /* -- tab output -- */
 
   if (ParamExist ("tab")){
-    output = runtime->output + (ipos++);
+    output = NewOutput (runtime, &ipos);
     output->type  = TAB_OUTPUT;
     GetOutputFrequency(output, "tab");
     if (ParamFileHasBoth ("tab","cgs")) output->cgs = 1;
@@ -318,7 +324,7 @@ printf ("%f  %d %s\n",runtime->patch_left_node[idim][ip],runtime->patch_npoint[i
  /* -- ppm output -- */
 
   if (ParamExist ("ppm")){
-    output = runtime->output + (ipos++);
+    output = NewOutput (runtime, &ipos);
     output->type  = PPM_OUTPUT;
     output->cgs   = 0;   /* Cannot write ppm in cgs units */
     GetOutputFrequency(output, "ppm");
@@ -327,12 +333,112 @@ printf ("%f  %d %s\n",runtime->patch_left_node[idim][ip],runtime->patch_npoint[i
  /* -- png output -- */
 
   if (ParamExist ("png")){
-    output = runtime->output + (ipos++);
+    output = NewOutput (runtime, &ipos);
     output->type  = PNG_OUTPUT;
     output->cgs   = 0;   /* Cannot write png in cgs units */
     GetOutputFrequency(output, "png");
   }
 
+ /* -- hist output: the 3rd field onwards are the names of the
+       lines defining each histogram (see write_hist.c) -- */
+
+  runtime->nhist = 0;
+  if (ParamExist ("hist")){
+    output = NewOutput (runtime, &ipos);
+    output->type  = HIST_OUTPUT;
+    output->cgs   = 0;
+    GetOutputFrequency(output, "hist");
+    for (ip = 3; ip <= ParamFileNWords("hist"); ip++){
+      str = ParamFileGet("hist", ip);
+      if (runtime->nhist == MAX_HIST_OUTPUTS){
+        printf ("! RuntimeSetup(): too many histograms (max %d)\n",
+                MAX_HIST_OUTPUTS);
+        QUIT_PLUTO(1);
+      }
+      strcpy (str_var, str);   /* -- str is overwritten by ParamFileGet() -- */
+      HistDefRead (str_var, runtime->hist + runtime->nhist);
+      runtime->nhist++;
+    }
+  }
+
+ /* -- proj output: the 3rd field onwards are the directions of
+       integration (x1, x2, x3) and the names of the lines defining
+       each map (see write_proj.c) -- */
+
+  runtime->nproj = 0;
+  for (idim = 0; idim < 3; idim++) runtime->proj_axis[idim] = 0;
+  if (ParamExist ("proj")){
+    output = NewOutput (runtime, &ipos);
+    output->type  = PROJ_OUTPUT;
+    output->cgs   = 0;
+    GetOutputFrequency(output, "proj");
+    for (ip = 3; ip <= ParamFileNWords("proj"); ip++){
+      str = ParamFileGet("proj", ip);
+      if (str[0] == 'x' && str[1] >= '1' && str[1] <= '3' && str[2] == '\0'){
+        idim = str[1] - '1';
+        if (idim >= DIMENSIONS){
+          printf ("! RuntimeSetup(): cannot project along %s in %dD\n",
+                  str, DIMENSIONS);
+          QUIT_PLUTO(1);
+        }
+        runtime->proj_axis[idim] = 1;
+        continue;
+      }
+      if (runtime->nproj == MAX_PROJ_OUTPUTS){
+        printf ("! RuntimeSetup(): too many projected maps (max %d)\n",
+                MAX_PROJ_OUTPUTS);
+        QUIT_PLUTO(1);
+      }
+      strcpy (str_var, str);   /* -- str is overwritten by ParamFileGet() -- */
+      ProjDefRead (str_var, runtime->proj + runtime->nproj);
+      runtime->nproj++;
+    }
+    if (!(runtime->proj_axis[IDIR] || runtime->proj_axis[JDIR] ||
+          runtime->proj_axis[KDIR])){
+      printf ("! RuntimeSetup(): no direction of integration in proj output\n");
+      QUIT_PLUTO(1);
+    }
+  }
+
+ /* -- sub-volume outputs: sub1, sub2, ... give precision, coarsening
+       factor and (optionally) the region of interest (see
+       write_subvol.c) -- */
+
+  for (itype = 1; itype <= MAX_SUBVOL_OUTPUTS; itype++){
+    char label[8];
+
+    sprintf (label, "sub%d", itype);
+    if (!ParamExist (label)) continue;
+    output = NewOutput (runtime, &ipos);
+    output->type = SUBVOL_OUTPUT;
+    GetOutputFrequency(output, label);
+    strcpy (output->ext, label);
+
+    output->cgs = ParamFileHasBoth (label, "cgs");
+    nw = ParamFileNWords (label) - output->cgs;
+    if (nw != 4 && nw != 4 + 2*DIMENSIONS){
+      printf ("! RuntimeSetup(): wrong number of fields in %s output\n", label);
+      QUIT_PLUTO(1);
+    }
+    strcpy (output->mode, ParamFileGet(label, 3));
+    if (strcmp(output->mode, "dbl") && strcmp(output->mode, "flt")){
+      printf ("! RuntimeSetup(): expecting 'dbl' or 'flt' in %s output\n",
+              label);
+      QUIT_PLUTO(1);
+    }
+    output->coarsen = atoi(ParamFileGet(label, 4));
+    if (output->coarsen < 1){
+      printf ("! RuntimeSetup(): invalid coarsening factor in %s output\n",
+              label);
+      QUIT_PLUTO(1);
+    }
+    for (idim = 0; idim < 3; idim++){
+      output->box[2*idim]     = -1.e38;  /* -- default is the whole domain -- */
+      output->box[2*idim + 1] =  1.e38;
+    }
+    for (ip = 5; ip <= nw; ip++) output->box[ip-5] = atof(ParamFileGet(label, ip));
+  }
+
  /* -- log frequency -- */
 
   strcpy (runtime->log_dir, runtime->output_dir);
@@ -353,6 +459,31 @@ printf ("%f  %d %s\n",runtime->patch_left_node[idim][ip],runtime->patch_npoint[i
     runtime->anl_dt = -1.0;   /* -- defaults -- */
     runtime->anl_dn = -1;
   }
+
+ /* -- in-situ plugin -- */
+
+  runtime->insitu_dt = -1.0;   /* -- defaults -- */
+  runtime->insitu_dn = -1;
+  runtime->insitu_lib[0]  = '\0';
+  runtime->insitu_args[0] = '\0';
+  if (ParamExist ("insitu")){
+    runtime->insitu_dt = atof(ParamFileGet("insitu", 1));
+    runtime->insitu_dn = atoi(ParamFileGet("insitu", 2));
+    if (ParamFileNWords("insitu") < 3){
+      printf ("! RuntimeSetup(): plugin library missing in insitu\n");
+      QUIT_PLUTO(1);
+    }
+    strcpy (runtime->insitu_lib, ParamFileGet("insitu", 3));
+    for (ip = 4; ip <= ParamFileNWords("insitu"); ip++){
+      str = ParamFileGet("insitu", ip);
+      if (strlen(runtime->insitu_args) + strlen(str) + 2 > 256){
+        printf ("! RuntimeSetup(): too many arguments in insitu\n");
+        QUIT_PLUTO(1);
+      }
+      if (ip > 4) strcat (runtime->insitu_args, " ");
+      strcat (runtime->insitu_args, str);
+    }
+  }
 #endif /* #ifndef CHOMBO */
 
 /* ------------------------------------------------------------
@@ -379,7 +510,7 @@ printf ("%f  %d %s\n",runtime->patch_left_node[idim][ip],runtime->patch_npoint[i
  /* ---- particles dbl output ---- */
 
   if (ParamExist("particles_dbl")){
-    output = runtime->output + (ipos++);
+    output = NewOutput (runtime, &ipos);
     output->type  = PARTICLES_DBL_OUTPUT;
     GetOutputFrequency(output, "particles_dbl");
   }
@@ -387,7 +518,7 @@ printf ("%f  %d %s\n",runtime->patch_left_node[idim][ip],runtime->patch_npoint[i
 /* ---- particles flt output ---- */
 
   if (ParamExist("particles_flt")){
-    output = runtime->output + (ipos++);
+    output = NewOutput (runtime, &ipos);
     output->type  = PARTICLES_FLT_OUTPUT;
     GetOutputFrequency(output, "particles_flt");
   }
@@ -395,7 +526,7 @@ printf ("%f  %d %s\n",runtime->patch_left_node[idim][ip],runtime->patch_npoint[i
 /* ---- particles vtk output ---- */
 
   if (ParamExist("particles_vtk")){
-    output = runtime->output + (ipos++);
+    output = NewOutput (runtime, &ipos);
     output->type  = PARTICLES_VTK_OUTPUT;
     GetOutputFrequency(output, "particles_vtk");
   }
@@ -403,7 +534,7 @@ printf ("%f  %d %s\n",runtime->patch_left_node[idim][ip],runtime->patch_npoint[i
 /* ---- particles tab output ---- */
 
   if (ParamExist("particles_tab")){
-    output = runtime->output + (ipos++);
+    output = NewOutput (runtime, &ipos);
     output->type  = PARTICLES_TAB_OUTPUT;
     GetOutputFrequency(output, "particles_tab");
   }
@@ -411,7 +542,7 @@ printf ("%f  %d %s\n",runtime->patch_left_node[idim][ip],runtime->patch_npoint[i
 /* ---- particles h5part output ---- */
 
   if (ParamExist("particles_hdf5")){
-    output = runtime->output + (ipos++);
+    output = NewOutput (runtime, &ipos);
     output->type  = PARTICLES_HDF5_OUTPUT;
     GetOutputFrequency(output, "particles_hdf5");
   }
@@ -586,3 +717,101 @@ Runtime *RuntimeGet(void)
 {
   return &q;
 }
+
+/* ********************************************************************* */
+Output *NewOutput (Runtime *runtime, int *ipos)
+/*
+ * Return the next free entry of runtime->output and increment *ipos,
+ * or abort if all MAX_OUTPUT_TYPES entries are taken.
+ *********************************************************************** */
+{
+  if (*ipos >= MAX_OUTPUT_TYPES){
+    printf ("! RuntimeSetup(): too many output types (max %d)\n",
+            MAX_OUTPUT_TYPES);
+    QUIT_PLUTO(1);
+  }
+  return runtime->output + (*ipos)++;
+}
+
+/* ********************************************************************* */
+void HistDefRead (const char *label, HistDef *hist)
+/*!
+ *  Read the definition of a histogram from the line beginning with
+ *  label:
+ *
+ *  <tt> label  x  xmin  xmax  nx  lin|log  [y  ymin  ymax  ny  lin|log]
+ *       weight </tt>
+ *
+ *********************************************************************** */
+{
+  int  nw, n, pos;
+
+  nw = ParamFileNWords (label);
+  if (nw < 0){
+    printf ("! HistDefRead(): histogram '%s' is not defined\n", label);
+    QUIT_PLUTO(1);
+  }
+  if (nw != 6 && nw != 11){
+    printf ("! HistDefRead(): wrong number of fields in histogram '%s'\n",
+            label);
+    QUIT_PLUTO(1);
+  }
+
+  memset (hist, 0, sizeof(HistDef));
+  strncpy (hist->name, label, 31);
+  hist->nbin[1] = 1;
+  for (n = 0; n < nw/5; n++){
+    pos = 5*n;
+    strncpy (hist->var[n], ParamFileGet(label, pos + 1), 31);
+    hist->min[n]      = atof(ParamFileGet(label, pos + 2));
+    hist->max[n]      = atof(ParamFileGet(label, pos + 3));
+    hist->nbin[n]     = atoi(ParamFileGet(label, pos + 4));
+    hist->logscale[n] = (strcmp(ParamFileGet(label, pos + 5), "log") == 0);
+    if (   hist->nbin[n] < 1 || hist->max[n] <= hist->min[n]
+        || (hist->logscale[n] && hist->min[n] <= 0.0)){
+      printf ("! HistDefRead(): invalid range in histogram '%s'\n", label);
+      QUIT_PLUTO(1);
+    }
+  }
+  strncpy (hist->weight, ParamFileGet(label, nw), 15);
+  if (   strcmp(hist->weight, "none")   && strcmp(hist->weight, "volume")
+      && strcmp(hist->weight, "mass")   && strcmp(hist->weight, "cooling")){
+    printf ("! HistDefRead(): unknown weight '%s' in histogram '%s'\n",
+            hist->weight, label);
+    QUIT_PLUTO(1);
+  }
+  #if COOLING != GRACKLE
+  if (strcmp(hist->weight, "cooling") == 0){
+    printf ("! HistDefRead(): 'cooling' weight requires Grackle cooling\n");
+    QUIT_PLUTO(1);
+  }
+  #endif
+}
+
+/* ********************************************************************* */
+void ProjDefRead (const char *label, ProjDef *proj)
+/*!
+ *  Read the definition of a projected map from the line beginning
+ *  with label:
+ *
+ *  <tt> label  quantity  column|mass_column|mass|volume </tt>
+ *
+ *********************************************************************** */
+{
+  if (ParamFileNWords (label) != 2){
+    printf ("! ProjDefRead(): map '%s' is not defined or has wrong number "
+            "of fields\n", label);
+    QUIT_PLUTO(1);
+  }
+
+  memset (proj, 0, sizeof(ProjDef));
+  strncpy (proj->name, label, 31);
+  strncpy (proj->var,  ParamFileGet(label, 1), 31);
+  strncpy (proj->mode, ParamFileGet(label, 2), 15);
+  if (   strcmp(proj->mode, "column") && strcmp(proj->mode, "mass_column")
+      && strcmp(proj->mode, "mass")   && strcmp(proj->mode, "volume")){
+    printf ("! ProjDefRead(): unknown mode '%s' in map '%s'\n",
+            proj->mode, label);
+    QUIT_PLUTO(1);
+  }
+}
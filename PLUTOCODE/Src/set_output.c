@@ -32,6 +32,12 @@
  #define VTK_VECTOR_DUMP NO
 #endif
 
+#define QUANTITY_UNIT   (-1)   /* Derived quantities, see GetOutputQuantityIndex() */
+#define QUANTITY_NDENS  (-2)
+#define QUANTITY_NSQ    (-3)
+#define QUANTITY_TCOOL  (-4)
+#define QUANTITY_EDOT   (-5)
+
 static Output *all_outputs;
 /* ********************************************************************* */
 void SetOutput (Data *d, Runtime *runtime)
@@ -45,6 +51,9 @@ void SetOutput (Data *d, Runtime *runtime)
  *********************************************************************** */
 {
   int nv, i, k;
+#if COOLING == GRACKLE
+  int ngrac;
+#endif
   Output *output;
 
   if (runtime->user_var > 0)
@@ -146,6 +155,18 @@ void SetOutput (Data *d, Runtime *runtime)
      output->V[nv]          = d->Ax3;
      output->stag_var[nv++] = -1;  
     #endif
+
+  /* -- Grackle derived fields (needed for restart) -- */
+
+    #if COOLING == GRACKLE
+    ngrac = nv;
+    strcpy(output->var_name[nv], "Tgrac");
+    output->V[nv]          = d->Vgrac[TEMP];
+    output->stag_var[nv++] = -1;
+    strcpy(output->var_name[nv], "mugrac");
+    output->V[nv]          = d->Vgrac[MU];
+    output->stag_var[nv++] = -1;
+    #endif
     output->nvar = nv;
 
   /* --------------------------------------------
@@ -222,7 +243,7 @@ void SetOutput (Data *d, Runtime *runtime)
         strcpy (output->ext,"flt.h5");
         break;
       case VTK_OUTPUT:   /* -- do not dump staggered fields (below) -- */
-        strcpy (output->ext,"vtk");
+        strcpy (output->ext, output->xdmf ? "raw":"vtk");
         #if VTK_VECTOR_DUMP == YES
          DIM_EXPAND(output->dump_var[VX1] = VTK_VECTOR;  ,
                   output->dump_var[VX2] = NO;          ,
@@ -245,6 +266,19 @@ void SetOutput (Data *d, Runtime *runtime)
         strcpy (output->ext,"png");
         for (nv = output->nvar; nv--; ) output->dump_var[nv] = NO;
         break;
+      case HIST_OUTPUT:  /* -- histograms only (see write_hist.c) -- */
+        strcpy (output->ext,"hist.h5");
+        for (nv = output->nvar; nv--; ) output->dump_var[nv] = NO;
+        break;
+      case PROJ_OUTPUT:  /* -- projected maps only (see write_proj.c) -- */
+        strcpy (output->ext,"proj.h5");
+        for (nv = output->nvar; nv--; ) output->dump_var[nv] = NO;
+        break;
+      case SUBVOL_OUTPUT:  /* -- ext (sub1, sub2, ...) set in RuntimeSetup() -- */
+        for (nv = output->nvar; nv--; ){
+          if (output->stag_var[nv] != -1) output->dump_var[nv] = NO;
+        }
+        break;
     }
     
   /* ---------------------------------------------------------------
@@ -265,6 +299,17 @@ void SetOutput (Data *d, Runtime *runtime)
        #endif       
      }
     #endif
+
+  /* ---------------------------------------------------------------
+      Grackle temperature and mean molecular weight are dumped only
+      to output types that can be used for restart
+     --------------------------------------------------------------- */
+
+    #if COOLING == GRACKLE
+    output->dump_var[ngrac]     = (   output->type == DBL_OUTPUT
+                                   || output->type == DBL_H5_OUTPUT);
+    output->dump_var[ngrac + 1] = output->dump_var[ngrac];
+    #endif
   }
  
 /* -- Exclude staggered components from all output except .dbl and .h5.dbl -- */
@@ -392,3 +437,90 @@ double ***GetUserVar (char *var_name)
   }
   return (all_outputs->V[indx]);
 }
+
+/* ********************************************************************* */
+int GetOutputQuantityIndex (Output *output, const char *name)
+/*!
+ * Return the index of a quantity used by the in-situ outputs
+ * (histograms, projections): either the position of name in the
+ * variable list of output or, for derived quantities, one of the
+ * negative values below.
+ * An empty name gives the constant 1.
+ * Derived quantities are
+ * - ndens: total particle number density (cm^-3);
+ * - nsq:   ndens^2 (cm^-6), e.g. for the emission measure;
+ * - tcool: (Grackle) signed cooling time (code units);
+ * - edot:  (Grackle) cooling rate per unit volume
+ *          \f$ p/((\Gamma-1)|t_{\rm cool}|) \f$ (erg cm^-3 s^-1).
+ *
+ * \param [in] output  an output structure (for the variable names)
+ * \param [in] name    the quantity name
+ *********************************************************************** */
+{
+  int nv;
+
+  if (name[0] == '\0') return QUANTITY_UNIT;
+  for (nv = 0; nv < output->nvar; nv++){
+    if (strcmp(output->var_name[nv], name) == 0) return nv;
+  }
+  if (strcmp(name, "ndens") == 0) return QUANTITY_NDENS;
+  if (strcmp(name, "nsq")   == 0) return QUANTITY_NSQ;
+  #if COOLING == GRACKLE
+  if (strcmp(name, "tcool") == 0) return QUANTITY_TCOOL;
+  if (strcmp(name, "edot")  == 0) return QUANTITY_EDOT;
+  #endif
+
+  print ("! GetOutputQuantityIndex(): unknown quantity '%s'\n", name);
+  QUIT_PLUTO(1);
+  return 0;
+}
+
+/* ********************************************************************* */
+double *GetOutputQuantityRow (const Data *d, Output *output, int id,
+                              int k, int j, double *q)
+/*!
+ * Return a pointer to row (k,j) of the quantity id returned by
+ * GetOutputQuantityIndex(); derived quantities are computed in
+ * q[IBEG...IEND].
+ *********************************************************************** */
+{
+  int    i;
+  double mu;
+  #if COOLING == GRACKLE
+  double tc;
+  #else
+  int    nv;
+  double v[NVAR], dummy[4];
+  #endif
+
+  if (id >= 0) return output->V[id][k][j];
+
+  IDOM_LOOP(i){
+    if (id == QUANTITY_UNIT){
+      q[i] = 1.0;
+    }else if (id == QUANTITY_NDENS || id == QUANTITY_NSQ){
+      #if COOLING == GRACKLE
+      mu = d->Vgrac[MU][k][j][i];
+      #else
+      NVAR_LOOP(nv) v[nv] = d->Vc[nv][k][j][i];
+      #if COOLING == NO || COOLING == TABULATED || COOLING == TOWNSEND
+      mu = MeanMolecularWeight(v, dummy);
+      #else
+      mu = MeanMolecularWeight(v);
+      #endif
+      #endif
+      q[i] = d->Vc[RHO][k][j][i]*UNIT_DENSITY/(mu*CONST_amu);
+      if (id == QUANTITY_NSQ) q[i] *= q[i];
+    #if COOLING == GRACKLE
+    }else if (id == QUANTITY_TCOOL){
+      q[i] = d->Vgrac[TCOOL][k][j][i];
+    }else if (id == QUANTITY_EDOT){
+      tc   = fabs(d->Vgrac[TCOOL][k][j][i]);
+      q[i] = (tc > 0.0 ? d->Vc[PRS][k][j][i]/((g_gamma-1.0)*tc):0.0)
+             *UNIT_DENSITY*UNIT_VELOCITY*UNIT_VELOCITY*UNIT_VELOCITY
+             /UNIT_LENGTH;
+    #endif
+    }
+  }
+  return q;
+}
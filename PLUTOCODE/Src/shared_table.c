@@ -0,0 +1,164 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Node-shared storage for large read-only lookup tables.
+
+  Tables that are identical on every processor (EOS tables, tabulated
+  cooling functions) are built or read only once per compute node and
+  stored in an MPI-3 shared memory window (MPI_Win_allocate_shared()).
+  The other processors on the same node obtain a pointer to the same
+  memory with MPI_Win_shared_query() and only read from it.
+
+  A table is created with the following collective sequence (all the
+  processors of MPI_COMM_WORLD must take part):
+  \code
+    builder = SharedTableBuilder();
+    if (builder) n = ...;          // only the builder needs the size
+    tab = SharedTableAlloc(n, &n); // on output n is the size on all procs
+    if (builder) { fill tab[0..n-1] }
+    SharedTableSync();
+  \endcode
+
+  Shared tables are released by SharedTableFree() at the end of the
+  run.
+  Setting \c SHARED_TABLES to \c NO in definitions.h makes every
+  processor its own builder (one private copy per processor), which
+  is also the behavior of the serial code.
+
+  \date   Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+
+#ifndef SHARED_TABLES
+  #define SHARED_TABLES  YES  /**< Share read-only tables among the
+                                   processors of the same node. */
+#endif
+
+#define SHARED_TABLE_MAX  32  /**< Max number of shared tables */
+
+#if (defined PARALLEL) && (SHARED_TABLES == YES)
+static MPI_Comm s_node_comm = MPI_COMM_NULL;
+static int      s_node_rank;
+static MPI_Win  s_win[SHARED_TABLE_MAX];
+#else
+static double  *s_tab[SHARED_TABLE_MAX];
+#endif
+static int      s_ntab;
+
+/* ********************************************************************* */
+int SharedTableBuilder (void)
+/*!
+ * Create (once) the node communicator and return 1 if the calling
+ * processor is in charge of filling shared tables on its node,
+ * 0 otherwise.
+ * Collective on MPI_COMM_WORLD at the first call.
+ *
+ *********************************************************************** */
+{
+#if (defined PARALLEL) && (SHARED_TABLES == YES)
+  if (s_node_comm == MPI_COMM_NULL){
+    int node_size;
+    MPI_Comm_split_type (MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, prank,
+                         MPI_INFO_NULL, &s_node_comm);
+    MPI_Comm_rank (s_node_comm, &s_node_rank);
+    MPI_Comm_size (s_node_comm, &node_size);
+    print ("> SharedTableBuilder(): tables shared by %d proc(s) per node\n",
+            node_size);
+  }
+  return (s_node_rank == 0);
+#else
+  return 1;
+#endif
+}
+
+/* ********************************************************************* */
+double *SharedTableAlloc (long int n, long int *nshared)
+/*!
+ * Allocate a table of \c n doubles in node-shared memory.
+ * Collective on MPI_COMM_WORLD.
+ *
+ * \param [in]  n        number of elements (significant only on the
+ *                       builder, see SharedTableBuilder())
+ * \param [out] nshared  number of elements of the table as allocated
+ *                       by the builder (may be NULL)
+ *
+ * \return A pointer to the table. It must be written only by the
+ *         builder and read by the other processors only after
+ *         SharedTableSync() has been called.
+ *********************************************************************** */
+{
+  double *tab;
+
+  if (s_ntab == SHARED_TABLE_MAX){
+    printLog ("! SharedTableAlloc(): too many tables (max = %d)\n",
+               SHARED_TABLE_MAX);
+    QUIT_PLUTO(1);
+  }
+
+#if (defined PARALLEL) && (SHARED_TABLES == YES)
+{
+  int      disp_unit;
+  MPI_Aint size = (SharedTableBuilder() ? n*sizeof(double):0);
+
+  if (MPI_Win_allocate_shared (size, sizeof(double), MPI_INFO_NULL,
+                               s_node_comm, &tab, s_win + s_ntab)
+      != MPI_SUCCESS){
+    printLog ("! SharedTableAlloc(): cannot allocate %ld bytes\n",
+               (long int)size);
+    QUIT_PLUTO(1);
+  }
+  MPI_Win_shared_query (s_win[s_ntab], 0, &size, &disp_unit, &tab);
+  MPI_Win_lock_all (MPI_MODE_NOCHECK, s_win[s_ntab]);  /* Passive target 
+                                                          epoch for Win_sync */
+  n = size/sizeof(double);
+}
+#else
+  tab = ARRAY_1D(n, double);
+  s_tab[s_ntab] = tab;
+#endif
+
+  s_ntab++;
+  if (nshared != NULL) *nshared = n;
+  return tab;
+}
+
+/* ********************************************************************* */
+void SharedTableSync (void)
+/*!
+ * Make the content written by the builder in the last allocated
+ * table visible to all the processors of the node.
+ * Collective on MPI_COMM_WORLD.
+ *
+ *********************************************************************** */
+{
+#if (defined PARALLEL) && (SHARED_TABLES == YES)
+  MPI_Win_sync (s_win[s_ntab-1]);
+  MPI_Barrier  (s_node_comm);
+  MPI_Win_sync (s_win[s_ntab-1]);
+#endif
+}
+
+/* ********************************************************************* */
+void SharedTableFree (void)
+/*!
+ * Release all shared tables.
+ * Collective on MPI_COMM_WORLD.
+ *
+ *********************************************************************** */
+{
+  int n;
+
+  for (n = 0; n < s_ntab; n++){
+#if (defined PARALLEL) && (SHARED_TABLES == YES)
+    MPI_Win_unlock_all (s_win[n]);
+    MPI_Win_free (s_win + n);
+#else
+    FreeArray1D ((void *)s_tab[n]);
+#endif
+  }
+  s_ntab = 0;
+#if (defined PARALLEL) && (SHARED_TABLES == YES)
+  if (s_node_comm != MPI_COMM_NULL) MPI_Comm_free (&s_node_comm);
+#endif
+}
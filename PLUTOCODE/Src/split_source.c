@@ -36,12 +36,14 @@ void SplitSource (const Data *d, double dt, timeStep *Dts, Grid *grid)
  *
  *********************************************************************** */
 {
+  PROFILE_BEG(PROF_SPLIT_SOURCE);
 
 /*  ---------------------------------------------
              Cooling/Heating losses
     ---------------------------------------------  */
 
 #if COOLING != NO
+  PROFILE_BEG(PROF_COOLING);
   #if COOLING == POWER_LAW  /* -- solve exactly -- */
   PowerLawCooling (d->Vc, dt, Dts, grid);
   #elif COOLING == KROME /* -- Interfaced krome solvers -- */
@@ -49,6 +51,7 @@ void SplitSource (const Data *d, double dt, timeStep *Dts, Grid *grid)
   #else
   CoolingSource (d, dt, Dts, grid);
   #endif
+  PROFILE_END(PROF_COOLING);
 #endif
 
 /* ----------------------------------------------
@@ -60,11 +63,16 @@ void SplitSource (const Data *d, double dt, timeStep *Dts, Grid *grid)
    ---------------------------------------------- */
 
 #if (PARABOLIC_FLUX & SUPER_TIME_STEPPING)
+  PROFILE_BEG(PROF_PARABOLIC);
   STS (d, dt, Dts, grid);
+  PROFILE_END(PROF_PARABOLIC);
 #endif
 
 #if (PARABOLIC_FLUX & RK_LEGENDRE)
+  PROFILE_BEG(PROF_PARABOLIC);
   RKL (d, dt, Dts, grid);
+  PROFILE_END(PROF_PARABOLIC);
 #endif
 
+  PROFILE_END(PROF_SPLIT_SOURCE);
 }
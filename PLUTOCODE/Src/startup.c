@@ -238,15 +238,14 @@ void Startup (Data *d, Grid *grid)
 /* --------------------------------------------------------
    4. Initialize Forced-Turbulence module
    -------------------------------------------------------- */
-/*
 #if FORCED_TURB == YES
-  struct ForcedTurb *Ft;
+  ForcedTurb *Ft;
   Ft = d->Ft;
   ForcedTurb_Init(Ft);
   printLog("> Initialized Forced Turbulence %d Modes\n",Ft->NModes);
   ForcedTurb_OUNoiseInit(Ft->OUPhases, 6*(Ft->NModes), Ft->OUVar);
+  ForcedTurb_CalcPhases(Ft);
 #endif
-*/
 
 /* ------------------------------------------------------
    5. Set boundary conditions.
@@ -254,6 +254,30 @@ typedef struct Restart_{
   char   fill[40];  /* Align the structure to power of 2 */
 } Restart;
 
+/* ********************************************************************* */
+/*! The OutputIndex structure is a fixed-size record of the binary
+    output index <ext>.idx written by WriteData() next to the text
+    file <ext>.out.
+    Record n describes file number n so that it can be located on
+    restart without parsing the text files (see output_index.c).
+    As for Restart, the size is a power of 2.
+   ********************************************************************* */
+
+typedef struct OutputIndex_{
+  int       nfile;          /**< File number */
+  int       mode;           /**< IDX_SINGLE_FILE, IDX_MULTIPLE_FILES or
+                                 IDX_SUBFILES */
+  int       little_endian;  /**< 1 if data was written in little endian */
+  int       grackle;        /**< 1 if Grackle fields (Tgrac, ...) were dumped */
+  long long nstep;          /**< Integration step */
+  double    t;              /**< Simulation time */
+  double    dt;             /**< Time step */
+  long long txt_end;        /**< Offset of the end of line nfile in <ext>.out */
+  int       nproc[3];       /**< Domain decomposition */
+  int       restart;        /**< Record in restart.out, -1 if none */
+  char      fill[64];       /* Align the structure to power of 2 */
+} OutputIndex;
+
 /* ********************************************************************* */
 /*! The State structure contains one-dimensional vectors of fluid
     quantities, often used during 1D computations (Riemann solver,
@@ -415,9 +439,40 @@ typedef struct Output_{
   double dclock;       /**< Time increment in clock hours. */
   double ***V[MAX_OUTPUT_VARS]; /**< (Fluid only) Array of pointers to 3D arrays
                                      to be written - same for all outputs. */
-  char   fill[140];    /**< Useless, just to make the structure size a power of 2 */
+  int    coarsen;      /**< (Sub-volume only) Coarsening factor. */
+  double box[6];       /**< (Sub-volume only) Region of interest
+                            (x1beg, x1end, x2beg, ...). */
+  int    xdmf;         /**< (VTK only) When set to 1, write raw binary
+                            data described by an XDMF file instead. */
+  char   fill[80];    /**< Useless, just to make the structure size a power of 2 */
 } Output;
 
+/* ********************************************************************* */
+/*! The HistDef structure describes one histogram of the hist output
+    (see write_hist.c).
+   ********************************************************************* */
+
+typedef struct HistDef_{
+  char   name[32];      /**< Histogram (dataset) name */
+  char   var[2][32];    /**< Quantities along x and y (var[1] is empty in 1D) */
+  char   weight[16];    /**< "none", "volume", "mass" or "cooling" */
+  int    nbin[2];       /**< Number of bins along x and y (nbin[1] = 1 in 1D) */
+  int    logscale[2];   /**< 1 for logarithmic bins */
+  double min[2];        /**< Lower limits */
+  double max[2];        /**< Upper limits */
+} HistDef;
+
+/* ********************************************************************* */
+/*! The ProjDef structure describes one map of the proj output
+    (see write_proj.c).
+   ********************************************************************* */
+
+typedef struct ProjDef_{
+  char   name[32];      /**< Map name */
+  char   var[32];       /**< Projected quantity */
+  char   mode[16];      /**< "column", "mass_column", "mass" or "volume" */
+} ProjDef;
+
 /* ********************************************************************* */
 /*! The Runtime structure contains runtime initialization parameters
     read from pluto.ini (or equivalent). 
@@ -446,6 +501,12 @@ typedef struct Runtime_{
                                        where log files will be written to.
                                        Default is output_dir. */
   Output output[MAX_OUTPUT_TYPES];  
+  int     nhist;                    /**< Number of histograms in hist output */
+  HistDef hist[MAX_HIST_OUTPUTS];   /**< Histograms of hist output */
+  int     nproj;                    /**< Number of maps in proj output */
+  int     proj_axis[3];             /**< 1 if proj output integrates along
+                                         the given direction */
+  ProjDef proj[MAX_PROJ_OUTPUTS];   /**< Maps of proj output */
   double patch_left_node[5][16];  /*  self-expl. */
   double  cfl;               /**< Hyperbolic cfl number (\c CFL) */
   double  cfl_max_var;       /**< Maximum increment between consecutive time
@@ -458,6 +519,10 @@ typedef struct Runtime_{
   double  first_dt;        /**< The initial time step (\c first_dt) */
   double  anl_dt;          /**< Time step increment for Analysis()
                                 ( <tt> analysis (double) </tt> )*/
+  double  insitu_dt;       /**< Time increment between in-situ plugin calls */
+  int     insitu_dn;       /**< Step increment between in-situ plugin calls */
+  char    insitu_lib[256]; /**< In-situ plugin library (empty if none) */
+  char    insitu_args[256];/**< Arguments passed to the in-situ plugin */
 
   int     Nparticles_glob;  /**< Total number of particles in the whole domain */
   int     Nparticles_cell;  /**< Total number of particles per cell */
@@ -588,3 +653,7 @@ typedef struct Data_{
   char fill[78];  /* make the structure a power of two.  */
 } Data;
 
+/*! User-defined diagnostics field: fills q[i] along row (k,j),
+    see DiagFieldFunction().                                    */
+typedef void (*DiagFieldFunc)(const Data *, int, int, double *, Grid *);
+
@@ -0,0 +1,445 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Node-aggregated subfile I/O for double precision checkpoints.
+
+  When the \c dbl output is given the \c subfiles mode in pluto.ini,
+
+      dbl    1.0  -1   subfiles
+
+  processors sharing the same compute node (as returned by
+  MPI_Comm_split_type()) send their portion of the domain to a single
+  aggregator rank which writes its own subfile with plain POSIX I/O.
+  This avoids lock contention on a single shared file when thousands
+  of processors write at the same time.
+  The number of processors per aggregator can be further limited by
+  defining \c SUBFILE_GROUP_SIZE in definitions.h (useful to test
+  several subfiles on a single node with an oversubscribed mpirun).
+
+  For the n-th output the following files are created:
+
+  - <tt>data.nnnn.dbl.sub</tt>: ASCII master index written by rank 0
+    containing the number of subfiles and the global grid size;
+  - <tt>data.nnnn.dbl.sXXXX</tt>: one binary file per aggregator.
+    Each subfile starts with a small index (the number of blocks and,
+    for each block, the global interior start index and size) followed
+    by data.
+    Data is stored variable by variable and, for each variable,
+    block after block with \c i running fastest.
+
+  Since the block index is stored in the subfiles, ReadSubfiles() lets
+  every processor read only the portions overlapping its own
+  sub-domain. Restarting with a different number of processors
+  or a different domain decomposition is therefore possible.
+
+  \note Only cell-centered variables are supported.
+
+  \date   Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+
+#ifndef SUBFILE_GROUP_SIZE
+  #define SUBFILE_GROUP_SIZE  0  /* Max number of procs per aggregator
+                                    (0 = all processors on the node) */
+#endif
+
+typedef struct SubfileBlock_{
+  int beg[3];  /* Zero-based global start index of the interior block */
+  int np[3];   /* Number of interior zones in each direction          */
+} SubfileBlock;
+
+static void SubfileSetup (int *, int *, int *, int *);
+static void SubfileOverlapRead (FILE *, long, SubfileBlock *, Output *,
+                                int, int, Grid *);
+
+#ifdef PARALLEL
+static MPI_Comm node_comm = MPI_COMM_NULL;
+#endif
+
+/* ********************************************************************* */
+void WriteSubfiles (Output *output, Grid *grid)
+/*!
+ * Write double precision data using one subfile per aggregator.
+ *
+ * \param [in] output  pointer to the (dbl) Output structure
+ * \param [in] grid    pointer to an array of Grid structures
+ *********************************************************************** */
+{
+  int  i, j, k, nv, n, idim;
+  int  node_rank, node_size, isub, nsub;
+  int  nblocks = 1;
+  int  *counts = NULL, *displs = NULL;
+  long nelem, nelem_tot;
+  char fname[512];
+  double *buf, *gbuf = NULL;
+  SubfileBlock blk, *blocks = &blk;
+  FILE *fp = NULL;
+
+  SubfileSetup (&node_rank, &node_size, &isub, &nsub);
+
+/* --------------------------------------------------------
+   1. Define the local block and gather block information
+      on the aggregator
+   -------------------------------------------------------- */
+
+  for (idim = 0; idim < 3; idim++){
+    blk.beg[idim] = grid->beg[idim] - grid->gbeg[idim];
+    blk.np[idim]  = grid->np_int[idim];
+  }
+  nelem = (long)NX1*NX2*NX3;
+
+  #ifdef PARALLEL
+  nblocks = node_size;
+  if (node_rank == 0){
+    blocks = (SubfileBlock *) malloc(nblocks*sizeof(SubfileBlock));
+    counts = ARRAY_1D(nblocks, int);
+    displs = ARRAY_1D(nblocks, int);
+  }
+  MPI_Gather (&blk, sizeof(SubfileBlock), MPI_BYTE,
+              blocks, sizeof(SubfileBlock), MPI_BYTE, 0, node_comm);
+  #endif
+
+  nelem_tot = nelem;
+  if (node_rank == 0){
+    nelem_tot = 0;
+    for (n = 0; n < nblocks; n++){
+      if (counts != NULL){
+        counts[n] = blocks[n].np[IDIR]*blocks[n].np[JDIR]*blocks[n].np[KDIR];
+        displs[n] = (int)nelem_tot;
+        nelem_tot += counts[n];
+      }else{
+        nelem_tot += nelem;
+      }
+    }
+    gbuf = ARRAY_1D(nelem_tot, double);
+  }
+  buf = ARRAY_1D(nelem, double);
+
+/* --------------------------------------------------------
+   2. Aggregator opens the subfile and writes the index.
+      Rank 0 writes the ASCII master index.
+   -------------------------------------------------------- */
+
+  if (node_rank == 0){
+    sprintf (fname, "%s/data.%04d.%s.s%04d", output->dir, output->nfile,
+                                             output->ext, isub);
+    fp = fopen (fname, "wb");
+    if (fp == NULL){
+      printLog ("! WriteSubfiles(): cannot open %s\n", fname);
+      QUIT_PLUTO(1);
+    }
+    fwrite (&nblocks, sizeof(int), 1, fp);
+    fwrite (blocks, sizeof(SubfileBlock), nblocks, fp);
+  }
+
+  if (prank == 0){
+    FILE *fidx;
+    sprintf (fname, "%s/data.%04d.%s.sub", output->dir, output->nfile,
+                                           output->ext);
+    fidx = fopen (fname, "w");
+    fprintf (fidx, "nsub    %d\n", nsub);
+    fprintf (fidx, "npoint  %d %d %d\n", grid->np_int_glob[IDIR],
+                                        grid->np_int_glob[JDIR],
+                                        grid->np_int_glob[KDIR]);
+    fclose(fidx);
+  }
+
+/* --------------------------------------------------------
+   3. Gather and write one variable at a time so that the
+      aggregator buffer never exceeds a single 3D array
+      for the whole node.
+   -------------------------------------------------------- */
+
+  for (nv = 0; nv < output->nvar; nv++){
+    if (!output->dump_var[nv]) continue;
+    if (output->stag_var[nv] != -1){
+      printLog ("! WriteSubfiles(): staggered variable '%s' not supported\n",
+                 output->var_name[nv]);
+      QUIT_PLUTO(1);
+    }
+
+    n = 0;
+    DOM_LOOP(k,j,i) buf[n++] = output->V[nv][k][j][i];
+
+    #ifdef PARALLEL
+    MPI_Gatherv (buf, (int)nelem, MPI_DOUBLE,
+                 gbuf, counts, displs, MPI_DOUBLE, 0, node_comm);
+    #else
+    for (n = 0; n < nelem; n++) gbuf[n] = buf[n];
+    #endif
+
+    if (node_rank == 0) fwrite (gbuf, sizeof(double), nelem_tot, fp);
+  }
+
+  if (node_rank == 0){
+    fclose(fp);
+    FreeArray1D(gbuf);
+    #ifdef PARALLEL
+    free (blocks);
+    FreeArray1D(counts);
+    FreeArray1D(displs);
+    #endif
+  }
+  FreeArray1D(buf);
+}
+
+/* ********************************************************************* */
+void ReadSubfiles (Output *output, int swap_endian, Grid *grid)
+/*!
+ * Read double precision data previously written by WriteSubfiles().
+ * Rank 0 reads the block index of each subfile and broadcasts it.
+ * Every processor then reads, from each subfile, only the blocks
+ * that overlap with its own sub-domain.
+ *
+ * \param [in] output       pointer to the (dbl) Output structure
+ * \param [in] swap_endian  when set to 1, swap endianity after reading
+ * \param [in] grid         pointer to an array of Grid structures
+ *********************************************************************** */
+{
+  int  n, s, nsub, nblocks, idim;
+  int  npoint[3];
+  long nread = 0, nelem_tot, hdr_size;
+  char fname[512], str[64];
+  SubfileBlock *blocks;
+  FILE *fp = NULL;
+
+/* --------------------------------------------------------
+   1. Read master index and check global grid size
+   -------------------------------------------------------- */
+
+  if (prank == 0){
+    sprintf (fname, "%s/data.%04d.%s.sub", output->dir, output->nfile,
+                                           output->ext);
+    fp = fopen (fname, "r");
+    if (fp == NULL){
+      printLog ("! ReadSubfiles(): cannot find %s\n", fname);
+      QUIT_PLUTO(1);
+    }
+    if (fscanf (fp, "%s %d", str, &nsub) != 2 ||
+        fscanf (fp, "%s %d %d %d", str, npoint, npoint+1, npoint+2) != 4){
+      printLog ("! ReadSubfiles(): corrupted index file %s\n", fname);
+      QUIT_PLUTO(1);
+    }
+    fclose(fp);
+    for (idim = 0; idim < 3; idim++){
+      if (npoint[idim] != grid->np_int_glob[idim]){
+        printLog ("! ReadSubfiles(): grid size in %s (%d) differs from\n",
+                   fname, npoint[idim]);
+        printLog ("!                 current grid (%d) in direction %d\n",
+                   grid->np_int_glob[idim], idim+1);
+        QUIT_PLUTO(1);
+      }
+    }
+  }
+  #ifdef PARALLEL
+  MPI_Bcast (&nsub, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  #endif
+
+/* --------------------------------------------------------
+   2. Loop over subfiles, share the block index and read
+      overlapping portions.
+   -------------------------------------------------------- */
+
+  for (s = 0; s < nsub; s++){
+    sprintf (fname, "%s/data.%04d.%s.s%04d", output->dir, output->nfile,
+                                             output->ext, s);
+    if (prank == 0){
+      fp = fopen (fname, "rb");
+      if (fp == NULL){
+        printLog ("! ReadSubfiles(): cannot find %s\n", fname);
+        QUIT_PLUTO(1);
+      }
+      if (fread (&nblocks, sizeof(int), 1, fp) != 1){
+        printLog ("! ReadSubfiles(): cannot read index of %s\n", fname);
+        QUIT_PLUTO(1);
+      }
+      if (swap_endian) SWAP_VAR(nblocks);
+    }
+    #ifdef PARALLEL
+    MPI_Bcast (&nblocks, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    #endif
+
+    blocks = (SubfileBlock *) malloc(nblocks*sizeof(SubfileBlock));
+    if (prank == 0){
+      if (fread (blocks, sizeof(SubfileBlock), nblocks, fp) != nblocks){
+        printLog ("! ReadSubfiles(): cannot read index of %s\n", fname);
+        QUIT_PLUTO(1);
+      }
+      fclose(fp);
+      if (swap_endian){
+        for (n = 0; n < nblocks; n++){
+          for (idim = 0; idim < 3; idim++){
+            SWAP_VAR(blocks[n].beg[idim]);
+            SWAP_VAR(blocks[n].np[idim]);
+          }
+        }
+      }
+    }
+    #ifdef PARALLEL
+    MPI_Bcast (blocks, nblocks*sizeof(SubfileBlock), MPI_BYTE,
+               0, MPI_COMM_WORLD);
+    #endif
+
+    hdr_size  = sizeof(int) + nblocks*sizeof(SubfileBlock);
+    nelem_tot = 0;
+    for (n = 0; n < nblocks; n++){
+      nelem_tot += (long)blocks[n].np[IDIR]*blocks[n].np[JDIR]*blocks[n].np[KDIR];
+    }
+
+  /* -- Read portions of blocks overlapping the local domain -- */
+
+    fp = NULL;
+    for (n = 0; n < nblocks; n++){
+      int overlap = 1;
+      for (idim = 0; idim < 3; idim++){
+        int lbeg = grid->beg[idim] - grid->gbeg[idim];
+        int lend = lbeg + grid->np_int[idim] - 1;
+        int bbeg = blocks[n].beg[idim];
+        int bend = bbeg + blocks[n].np[idim] - 1;
+        overlap = overlap && (bbeg <= lend) && (bend >= lbeg);
+      }
+      if (!overlap) continue;
+      if (fp == NULL){
+        fp = fopen (fname, "rb");
+        if (fp == NULL){
+          printLog ("! ReadSubfiles(): cannot open %s\n", fname);
+          QUIT_PLUTO(1);
+        }
+      }
+
+    /* -- Offset (in elements) of the block within each variable -- */
+
+      long boffset = 0;
+      int  m;
+      for (m = 0; m < n; m++){
+        boffset += (long)blocks[m].np[IDIR]*blocks[m].np[JDIR]*blocks[m].np[KDIR];
+      }
+      SubfileOverlapRead (fp, hdr_size + boffset*sizeof(double), blocks + n,
+                          output, (int)nelem_tot, swap_endian, grid);
+      nread += (long)blocks[n].np[IDIR]*blocks[n].np[JDIR]*blocks[n].np[KDIR];
+    }
+    if (fp != NULL) fclose(fp);
+    free (blocks);
+  }
+
+  if (nread == 0){
+    printLog ("! ReadSubfiles(): no data found for the local domain\n");
+    QUIT_PLUTO(1);
+  }
+}
+
+/* ********************************************************************* */
+void SubfileOverlapRead (FILE *fp, long offset, SubfileBlock *b,
+                         Output *output, int nelem_tot, int swap_endian,
+                         Grid *grid)
+/*!
+ * Read the portion of block \c b overlapping the local domain
+ * for all the variables being dumped.
+ * Data is read one contiguous row (along i) at a time.
+ *
+ * \param [in] fp           pointer to the (open) subfile
+ * \param [in] offset       byte offset of the block for the first
+ *                          variable
+ * \param [in] b            pointer to the block descriptor
+ * \param [in,out] output   pointer to the (dbl) Output structure
+ * \param [in] nelem_tot    total number of elements (per variable)
+ *                          in the subfile
+ * \param [in] swap_endian  swap endianity if set to 1
+ * \param [in] grid         pointer to an array of Grid structures
+ *********************************************************************** */
+{
+  int  i, j, k, nv, ivar, idim;
+  int  lo[3], hi[3], loff[3];
+  long pos;
+  double ***V;
+
+  for (idim = 0; idim < 3; idim++){
+    loff[idim] = grid->beg[idim] - grid->gbeg[idim];
+    lo[idim]   = MAX(b->beg[idim], loff[idim]);
+    hi[idim]   = MIN(b->beg[idim] + b->np[idim],
+                     loff[idim] + grid->np_int[idim]) - 1;
+  }
+
+  ivar = 0;
+  for (nv = 0; nv < output->nvar; nv++){
+    if (!output->dump_var[nv]) continue;
+    V = output->V[nv];
+    for (k = lo[KDIR]; k <= hi[KDIR]; k++){
+    for (j = lo[JDIR]; j <= hi[JDIR]; j++){
+      pos =   (long)(k - b->beg[KDIR])*b->np[JDIR]*b->np[IDIR]
+            + (long)(j - b->beg[JDIR])*b->np[IDIR]
+            + (lo[IDIR] - b->beg[IDIR]);
+      pos = offset + ((long)ivar*nelem_tot + pos)*sizeof(double);
+
+      double *row = V[k - loff[KDIR] + KBEG][j - loff[JDIR] + JBEG]
+                     + lo[IDIR] - loff[IDIR] + IBEG;
+      fseek (fp, pos, SEEK_SET);
+      if (fread (row, sizeof(double), hi[IDIR]-lo[IDIR]+1, fp)
+          != hi[IDIR]-lo[IDIR]+1){
+        printLog ("! SubfileOverlapRead(): unexpected end of file\n");
+        QUIT_PLUTO(1);
+      }
+      if (swap_endian){
+        for (i = 0; i <= hi[IDIR]-lo[IDIR]; i++) SWAP_VAR(row[i]);
+      }
+    }}
+    ivar++;
+  }
+}
+
+/* ********************************************************************* */
+void SubfileSetup (int *node_rank, int *node_size, int *isub, int *nsub)
+/*!
+ * Create (once) the communicator of the processors sharing the same
+ * aggregator and return the local rank and size, the subfile index
+ * and the total number of subfiles.
+ *
+ *********************************************************************** */
+{
+#ifdef PARALLEL
+  static int first_call = 1;
+  static int rank, size, id, nagg;
+
+  if (first_call){
+    MPI_Comm shm_comm, agg_comm;
+
+    MPI_Comm_split_type (MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, prank,
+                         MPI_INFO_NULL, &shm_comm);
+    #if SUBFILE_GROUP_SIZE > 0
+    MPI_Comm_rank  (shm_comm, &rank);
+    MPI_Comm_split (shm_comm, rank/SUBFILE_GROUP_SIZE, prank, &node_comm);
+    MPI_Comm_free  (&shm_comm);
+    #else
+    node_comm = shm_comm;
+    #endif
+    MPI_Comm_rank (node_comm, &rank);
+    MPI_Comm_size (node_comm, &size);
+
+  /* -- Aggregators (rank 0 on each node) get a subfile index -- */
+
+    MPI_Comm_split (MPI_COMM_WORLD, (rank == 0 ? 0:MPI_UNDEFINED), prank,
+                    &agg_comm);
+    if (rank == 0){
+      MPI_Comm_rank (agg_comm, &id);
+      MPI_Comm_size (agg_comm, &nagg);
+      MPI_Comm_free (&agg_comm);
+    }
+    MPI_Bcast (&id, 1, MPI_INT, 0, node_comm);
+    MPI_Bcast (&nagg, 1, MPI_INT, 0, MPI_COMM_WORLD);  /* prank 0 is always
+                                                          an aggregator */
+    print ("> SubfileSetup(): %d subfile(s), %d proc(s) on this aggregator\n",
+            nagg, size);
+    first_call = 0;
+  }
+  *node_rank = rank;
+  *node_size = size;
+  *isub      = id;
+  *nsub      = nagg;
+#else
+  *node_rank = 0;
+  *node_size = 1;
+  *isub      = 0;
+  *nsub      = 1;
+#endif
+}
@@ -11,9 +11,12 @@
   - HDF5 files are handled by hdf5_io.c.
   - image files are handled by write_img.c
   - tabulated ascii files are handled by write_tab.c
+  - histograms are handled by write_hist.c
+  - projected maps are handled by write_proj.c
+  - sub-volume and coarsened snapshots are handled by write_subvol.c
 
   This function also updates the corresponding .out file associated 
-  with the output data format.
+  with the output data format and its binary index (output_index.c).
 
   \authors A. Mignone (mignone@to.infn.it)\n
            G. Muscianisi (g.muscianisi@cineca.it)
@@ -37,7 +40,7 @@ void WriteData (const Data *d, Output *output, Grid *grid)
  *********************************************************************** */
 {
   int    i, j, k, nv;
-  int    single_file;
+  int    single_file, subfiles = 0;
   size_t dsize;
   char   filename[512], sline[512];
   static int last_computed_var = -1;
@@ -110,6 +113,8 @@ void WriteData (const Data *d, Output *output, Grid *grid)
           has been dumped.
         - when writing multiple files we open, write to and close the
           file one each loop cycle.
+        - with subfiles, processors on the same node send their data
+          to an aggregator writing one file per node (see subfile_io.c).
         \note In all cases, the pointer to the data array that has to be 
               written must be cast into (void *) and the starting index of 
               the array must be zero.
@@ -118,9 +123,14 @@ void WriteData (const Data *d, Output *output, Grid *grid)
 
     int sz;
     single_file = strcmp(output->mode,"single_file") == 0;
+    subfiles    = strcmp(output->mode,"subfiles") == 0;
     dsize = sizeof(double);
 
-    if (single_file){  /* -- single output file -- */
+    if (subfiles){  /* -- node-aggregated subfiles -- */
+
+      WriteSubfiles (output, grid);
+
+    }else if (single_file){  /* -- single output file -- */
 
       sprintf (filename, "%s/data.%04d.%s", output->dir,output->nfile, 
                                             output->ext);
@@ -258,10 +268,9 @@ BOV_Header(output, filename);
      3d. VTK Output
      ------------------------------------------------------------------- */
   /*! - \b VTK output:  
-      in order to enable parallel writing, files must be closed and
-      opened again for scalars, since the distributed array descriptors 
-      used by ArrayLib (Float_Vect) and (float) are different. This is
-      done using the AL_Get_offset() and AL_Set_offset() functions.      */
+      each file is written by WriteVTK_Stream() with a single MPI-IO
+      file handle; with the \c xdmf keyword data is written as raw
+      binary (native byte order) together with an XDMF description. */
   /* ------------------------------------------------------------------- */
     
     single_file = strcmp(output->mode,"single_file") == 0;
@@ -270,28 +279,7 @@ BOV_Header(output, filename);
 
     if (single_file){  /* -- single output file -- */
 
-      FileDelete (filename);  /* Avoid partial fill of pre-existing files */
-      fbin  = FileOpen(filename, SZ_Float_Vect, "w");
-      WriteVTK_Header(fbin, grid);
-      for (nv = 0; nv < output->nvar; nv++) {  /* -- write vectors -- */
-        if (output->dump_var[nv] != VTK_VECTOR) continue;
-        WriteVTK_Vector (fbin, output->V + nv, units[nv],
-                         output->var_name[nv], grid);
-      }
-
-      #ifdef PARALLEL
-      offset = AL_Get_offset(SZ_Float_Vect);
-      FileClose(fbin, SZ_Float_Vect);
-      fbin  = FileOpen(filename, SZ_float, "w");
-      AL_Set_offset(SZ_float, offset);
-      #endif
-      
-      for (nv = 0; nv < output->nvar; nv++) { /* -- write scalars -- */
-        if (output->dump_var[nv] != YES) continue;
-        WriteVTK_Scalar (fbin, output->V[nv], units[nv],
-                         output->var_name[nv], grid);
-      }
-      FileClose(fbin, SZ_float);
+      WriteVTK_Stream (output, -1, units, filename, grid);
 
     }else{          /* -- multiple output files -- */
 
@@ -307,31 +295,14 @@ BOV_Header(output, filename);
           print ("! WriteData: unknown vector type in VTK output\n"); 
           QUIT_PLUTO(1);
         }
-
-        FileDelete (filename);  /* Avoid partial fill of pre-existing files */
-        fbin = FileOpen(filename, SZ_Float_Vect, "w");
-        WriteVTK_Header(fbin, grid);
-        WriteVTK_Vector(fbin, output->V + nv, units[nv],
-                        output->var_name[nv], grid);
-        FileClose(fbin, SZ_Float_Vect);
+        WriteVTK_Stream (output, nv, units, filename, grid);
       }
 
       for (nv = 0; nv < output->nvar; nv++) {  /* -- write scalars -- */
         if (output->dump_var[nv] != YES) continue;
         sprintf (filename, "%s/%s.%04d.%s", output->dir, output->var_name[nv], 
                                             output->nfile,  output->ext);
-        FileDelete (filename);  /* Avoid partial fill of pre-existing files */
-        fbin = FileOpen(filename, SZ_Float_Vect, "w");
-        WriteVTK_Header(fbin, grid);
-        #ifdef PARALLEL
-        offset = AL_Get_offset(SZ_Float_Vect);
-        FileClose(fbin, SZ_Float_Vect);
-        fbin  = FileOpen(filename, SZ_float, "w");
-        AL_Set_offset(SZ_float, offset);
-        #endif
-        WriteVTK_Scalar(fbin, output->V[nv], units[nv],
-                        output->var_name[nv], grid);
-        FileClose (fbin, SZ_float);
+        WriteVTK_Stream (output, nv, units, filename, grid);
       }
     }
 
@@ -378,6 +349,47 @@ BOV_Header(output, filename);
     print ("! PNG library not available\n");
     return;
     #endif
+
+  }else if (output->type == HIST_OUTPUT) { 
+
+  /* ------------------------------------------------------
+                   Histogram output
+     ------------------------------------------------------ */
+
+    #ifdef USE_HDF5
+    single_file = YES;
+    sprintf (filename, "%s/hist.%04d.h5", output->dir, output->nfile);
+    WriteHistograms (d, output, filename, grid);
+    #else
+    print ("! WriteData: HDF5 library not available\n");
+    return;
+    #endif
+
+  }else if (output->type == PROJ_OUTPUT) { 
+
+  /* ------------------------------------------------------
+                   Projected (column) maps
+     ------------------------------------------------------ */
+
+    #ifdef USE_HDF5
+    single_file = YES;
+    sprintf (filename, "%s/proj.%04d.h5", output->dir, output->nfile);
+    WriteProjections (d, output, filename, grid);
+    #else
+    print ("! WriteData: HDF5 library not available\n");
+    return;
+    #endif
+
+  }else if (output->type == SUBVOL_OUTPUT) { 
+
+  /* ------------------------------------------------------
+           Sub-volume and/or coarsened snapshots
+     ------------------------------------------------------ */
+
+    single_file = YES;
+    sprintf (filename, "%s/%s.%04d.%s", output->dir, output->ext,
+                                        output->nfile, output->mode);
+    WriteSubVolume (output, units, filename, grid);
   }       
 
 /* -------------------------------------------------------------
@@ -387,12 +399,18 @@ BOV_Header(output, filename);
   sprintf (filename,"%s/%s.out",output->dir, output->ext);
 
   if (prank == 0) {
+    OutputIndex rec;
+
     if (output->nfile == 0) {
       fout = fopen (filename, "w");
     }else {
       fout = fopen (filename, "r+");
-      for (nv = 0; nv < output->nfile; nv++) { if ( fgets (sline, 512, fout) == NULL ) {print("Unexpected exit! input_data.c:%d\n",132); QUIT_PLUTO(1);} }
-      fseek (fout, ftell(fout), SEEK_SET);
+      if (OutputIndexGet (output, output->nfile-1, &rec)){
+        fseek (fout, rec.txt_end, SEEK_SET);  /* Skip lines using the index */
+      }else{
+        for (nv = 0; nv < output->nfile; nv++) { if ( fgets (sline, 512, fout) == NULL ) {print("Unexpected exit! input_data.c:%d\n",132); QUIT_PLUTO(1);} }
+        fseek (fout, ftell(fout), SEEK_SET);
+      }
     }
 
   /* -- write a multi-column file -- */
@@ -400,8 +418,9 @@ BOV_Header(output, filename);
     fprintf (fout, "%d %12.6e %12.6e %ld ",
              output->nfile, g_time, g_dt, g_stepNumber);
 
-    if (single_file) fprintf (fout,"single_file ");
-    else             fprintf (fout,"multiple_files ");
+    if      (subfiles)    fprintf (fout,"subfiles ");
+    else if (single_file) fprintf (fout,"single_file ");
+    else                  fprintf (fout,"multiple_files ");
 
     if (IsLittleEndian()) fprintf (fout, "little ");
     else                  fprintf (fout, "big ");
@@ -411,6 +430,12 @@ BOV_Header(output, filename);
     }
 
     fprintf (fout,"\n");
+
+  /* -- append the same information to the binary index -- */
+
+    OutputIndexAppend (output, subfiles ? IDX_SUBFILES :
+                       (single_file ? IDX_SINGLE_FILE:IDX_MULTIPLE_FILES),
+                       ftell(fout), grid);
     fclose (fout);
   }
 
@@ -0,0 +1,237 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Write in-situ 1D/2D histograms in HDF5 format.
+
+  The hist output type computes histograms (e.g. density-temperature
+  phase diagrams or cooling-rate PDFs) on the fly, so that they can be
+  saved at a much higher cadence than full snapshots.
+  It is enabled in the [Static Grid Output] section of pluto.ini by
+  a line giving the output interval followed by the list of
+  histograms; each histogram is then defined on a line beginning with
+  its name:
+
+  \verbatim
+  hist       0.01  -1   rho_T  pdf_cool
+  rho_T      rho    1.e-3  1.e3  128  log   Tgrac  10.  1.e8  128  log  mass
+  pdf_cool   edot   1.e-30 1.e-20 100 log   volume
+  \endverbatim
+
+  The first quantity is binned along x and the (optional) second one
+  along y, between the given limits with linear (\c lin) or
+  logarithmic (\c log) spacing.
+  Quantities are those accepted by GetOutputQuantityIndex(): the
+  output variable names (e.g. rho, prs, Tgrac) and derived quantities
+  such as ndens or, with Grackle, edot (cooling rate per unit volume).
+  The last field is the weight added to each bin: \c none (zone
+  count), \c volume (dV), \c mass (rho dV) or \c cooling (Grackle,
+  energy lost per unit time, \f$ p\,dV/((\Gamma-1)|t_{\rm cool}|) \f$,
+  in code units).
+  Zones falling outside the limits are not counted.
+  Bins are filled with DiagHistogramRow(), shared with the histograms
+  of the diagnostics module (diagnostics.c).
+
+  All histograms are accumulated by each processor in a single pass
+  over its domain, combined with one MPI_Reduce() and written by
+  processor 0 to "hist.nnnn.h5".
+  Each histogram is a dataset of shape (ny, nx) (or nx in 1D) with the
+  bin edges and the quantity names as attributes.
+
+  \note The cooling time is stored by Grackle at every step and is
+        not saved to disk: after a restart it is zero (no cooling)
+        until the first step.
+
+  \date   Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+#ifdef USE_HDF5
+#define H5_USE_16_API
+#include "hdf5.h"
+
+void WriteHDF5Attribute (hid_t, const char *, hid_t, int, void *);
+
+/* ********************************************************************* */
+void WriteHistograms (const Data *d, Output *output, char *filename,
+                      Grid *grid)
+/*!
+ * Compute the histograms of the hist output and write them to disk.
+ * Collective on MPI_COMM_WORLD.
+ *
+ * \param [in] d         pointer to Data structure
+ * \param [in] output    the output structure of the hist format
+ * \param [in] filename  the name of the HDF5 file
+ * \param [in] grid      pointer to Grid structure
+ *********************************************************************** */
+{
+  int    i, j, k, n, m, nh, ntot;
+  long int step;
+  double scrh;
+  double *qx, *qy, *w, *bins;
+  static int    **qid, *offset;
+  static double *bins_loc, *bins_glob;
+  static double *one, *wvol, *wmass, *wcool, **sx, **sy;
+  static double qmin[MAX_HIST_OUTPUTS][2], dinv[MAX_HIST_OUTPUTS][2];
+  Runtime *runtime = RuntimeGet();
+  HistDef *hist;
+  hid_t  file, space, dataset;
+  hsize_t dims[2];
+
+  nh = runtime->nhist;
+  if (nh == 0) return;
+
+/* --------------------------------------------------------
+   0. At the first call, resolve quantity names, set bin
+      offsets and allocate memory.
+   -------------------------------------------------------- */
+
+  if (offset == NULL){
+    qid    = ARRAY_2D(nh, 2, int);
+    offset = ARRAY_1D(nh + 1, int);
+    offset[0] = 0;
+    for (n = 0; n < nh; n++){
+      hist = runtime->hist + n;
+      qmin[n][1] = 0.0;    /* -- 1D: y = 1 falls in the single bin -- */
+      dinv[n][1] = 0.5;
+      for (m = 0; m < 2; m++){
+        qid[n][m] = GetOutputQuantityIndex (output, hist->var[m]);
+        if (hist->var[m][0] == '\0') continue;
+        if (hist->logscale[m]){
+          qmin[n][m] = log10(hist->min[m]);
+          dinv[n][m] = hist->nbin[m]/(log10(hist->max[m]) - qmin[n][m]);
+        }else{
+          qmin[n][m] = hist->min[m];
+          dinv[n][m] = hist->nbin[m]/(hist->max[m] - qmin[n][m]);
+        }
+      }
+      offset[n+1] = offset[n] + hist->nbin[0]*hist->nbin[1];
+    }
+    ntot = offset[nh];
+    bins_loc  = ARRAY_1D(ntot, double);
+    bins_glob = ARRAY_1D(ntot, double);
+    one   = ARRAY_1D(NX1_TOT, double);
+    wvol  = ARRAY_1D(NX1_TOT, double);
+    wmass = ARRAY_1D(NX1_TOT, double);
+    wcool = ARRAY_1D(NX1_TOT, double);
+    sx    = ARRAY_2D(nh, NX1_TOT, double);
+    sy    = ARRAY_2D(nh, NX1_TOT, double);
+    for (i = 0; i < NX1_TOT; i++) one[i] = 1.0;
+  }
+  ntot = offset[nh];
+
+/* --------------------------------------------------------
+   1. Accumulate all histograms in a single pass
+   -------------------------------------------------------- */
+
+  for (m = 0; m < ntot; m++) bins_loc[m] = 0.0;
+
+  KDOM_LOOP(k) JDOM_LOOP(j){
+    IDOM_LOOP(i){
+      wvol[i]  = grid->dV[k][j][i];
+      wmass[i] = d->Vc[RHO][k][j][i]*wvol[i];
+      #if COOLING == GRACKLE
+      scrh     = fabs(d->Vgrac[TCOOL][k][j][i]);
+      wcool[i] = (scrh > 0.0 ? d->Vc[PRS][k][j][i]*wvol[i]/((g_gamma-1.0)*scrh)
+                             : 0.0);
+      #endif
+    }
+
+    for (n = 0; n < nh; n++){
+      hist = runtime->hist + n;
+      bins = bins_loc + offset[n];
+      qx   = GetOutputQuantityRow (d, output, qid[n][0], k, j, sx[n]);
+      qy   = GetOutputQuantityRow (d, output, qid[n][1], k, j, sy[n]);
+      if      (hist->weight[0] == 'v') w = wvol;
+      else if (hist->weight[0] == 'm') w = wmass;
+      else if (hist->weight[0] == 'c') w = wcool;
+      else                             w = one;
+
+      DiagHistogramRow (qx, qy, w, qmin[n], dinv[n], hist->nbin,
+                        hist->logscale, bins);
+    }
+  }
+
+/* --------------------------------------------------------
+   2. Sum on processor 0
+   -------------------------------------------------------- */
+
+  #ifdef PARALLEL
+  MPI_Reduce (bins_loc, bins_glob, ntot, MPI_DOUBLE, MPI_SUM, 0,
+              MPI_COMM_WORLD);
+  #else
+  for (m = 0; m < ntot; m++) bins_glob[m] = bins_loc[m];
+  #endif
+
+  if (prank != 0) return;
+
+/* --------------------------------------------------------
+   3. Write one dataset per histogram
+   -------------------------------------------------------- */
+
+  file = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+  if (file < 0){
+    printLog ("! WriteHistograms(): cannot create %s\n", filename);
+    QUIT_PLUTO(1);
+  }
+  step = g_stepNumber;
+  WriteHDF5Attribute (file, "time", H5T_NATIVE_DOUBLE, 1, &g_time);
+  WriteHDF5Attribute (file, "step", H5T_NATIVE_LONG, 1, &step);
+
+  for (n = 0; n < nh; n++){
+    int    nd = (hist = runtime->hist + n)->var[1][0] == '\0' ? 1:2;
+    double *edges;
+
+    dims[0] = hist->nbin[nd-1];
+    dims[1] = hist->nbin[0];
+    space   = H5Screate_simple(nd, dims, NULL);
+    dataset = H5Dcreate(file, hist->name, H5T_NATIVE_DOUBLE, space,
+                        H5P_DEFAULT);
+    H5Dwrite(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+             bins_glob + offset[n]);
+
+    for (m = 0; m < nd; m++){
+      edges = ARRAY_1D(hist->nbin[m] + 1, double);
+      for (i = 0; i <= hist->nbin[m]; i++){
+        scrh     = qmin[n][m] + i/dinv[n][m];
+        edges[i] = hist->logscale[m] ? pow(10.0, scrh):scrh;
+      }
+      WriteHDF5Attribute (dataset, m == 0 ? "x_edges":"y_edges",
+                      H5T_NATIVE_DOUBLE, hist->nbin[m] + 1, edges);
+      WriteHDF5Attribute (dataset, m == 0 ? "x":"y", H5T_C_S1,
+                      strlen(hist->var[m]), hist->var[m]);
+      FreeArray1D ((void *)edges);
+    }
+    WriteHDF5Attribute (dataset, "weight", H5T_C_S1, strlen(hist->weight),
+                    hist->weight);
+    H5Dclose(dataset);
+    H5Sclose(space);
+  }
+  H5Fclose(file);
+}
+
+/* ********************************************************************* */
+void WriteHDF5Attribute (hid_t obj, const char *name, hid_t type, int n,
+                     void *buf)
+/*!
+ * Attach an attribute with n elements (string length for H5T_C_S1)
+ * to an HDF5 object. Also used by write_proj.c.
+ *********************************************************************** */
+{
+  hid_t   space, attr, atype;
+  hsize_t dim = n;
+
+  if (type == H5T_C_S1){
+    atype = H5Tcopy(H5T_C_S1);
+    H5Tset_size(atype, MAX(n, 1));
+    space = H5Screate(H5S_SCALAR);
+  }else{
+    atype = H5Tcopy(type);
+    space = H5Screate_simple(1, &dim, NULL);
+  }
+  attr = H5Acreate(obj, name, atype, space, H5P_DEFAULT);
+  H5Awrite(attr, atype, buf);
+  H5Aclose(attr);
+  H5Sclose(space);
+  H5Tclose(atype);
+}
+#endif /* USE_HDF5 */
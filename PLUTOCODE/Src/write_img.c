@@ -147,9 +147,10 @@ void GetSlice (double ***Vdbl, Image *image, Grid *grid)
  * PURPOSE
  *
  *  get a 2D slice from the 3D array Vdbl.
- *  The array is actually written to disk and
- *  re-open for reading immediately after by
- *  proc #0. 
+ *  Only the processors intersecting the slice plane
+ *  copy their portion of the plane (in single precision)
+ *  into a buffer; the pieces are then collected by
+ *  proc #0 with MPI_Gatherv().
  *  Store its content as 2D rgb structure inside 
  *  image->rgb.
  *   
@@ -157,36 +158,24 @@ void GetSlice (double ***Vdbl, Image *image, Grid *grid)
  * 
  ************************************************************* */
 {
-  int i, j, k;
+  int i;
   int nx, ny, nz;
-  int col_offset, row_offset;
-  int offset, ir, ic;
-  char filename[256];
+  int ir, ic, n, dn, dc, dr, islice;
+  int loff[3], nloc[3], ind[3];
+  int meta[4];         /* col offset, row offset, ncol, nrow */
   float xflt, slice_min, slice_max;
+  float *sbuf;
   static float **slice;
   static RGB **rgb;
-  FILE *fl;
-  size_t dsize = sizeof(float);
+  #ifdef PARALLEL
+  static float *rbuf;
+  #endif
 
   #if DIMENSIONS == 1
    printLog ("! PPM output disabled in 1-D\n");
    return;    
   #endif    
 
-/* ------------------------------------------------ 
-    Write the whole array in single precision
-    Slice are post-processed later 
-   ------------------------------------------------ */
-  
-  fl = FileOpen ("tmp_file.out", SZ_float, "w");
-  FileWriteData ((Convert_dbl2flt(Vdbl,1.0, 0))[0][0], dsize, SZ_float, fl, -1); 
-  FileClose (fl, SZ_float);
-  #ifdef PARALLEL
-   MPI_Barrier (MPI_COMM_WORLD);
-  #endif
-
-  if (prank != 0) return; /* -- rank 0 will do the rest -- */
-
 /* ------------------------------------------------
           get global dimensions
    ------------------------------------------------ */
@@ -201,67 +190,108 @@ void GetSlice (double ***Vdbl, Image *image, Grid *grid)
      sizes.
    ----------------------------------------- */
 
-  if (slice == NULL) {
+  if (slice == NULL && prank == 0) {
     ic = MAX(nx,ny); 
     ir = MAX(ny,nz);
     slice = ARRAY_2D(ir, ic, float);
     rgb   = ARRAY_2D(ir, ic, RGB);
+    #ifdef PARALLEL
+    rbuf  = ARRAY_1D(ir*ic, float);
+    #endif
   }
 
 /* --------------------------------------------
-       set offsets for slice reading
+    Set normal (dn), column (dc) and row (dr)
+    directions of the slice plane
    -------------------------------------------- */
 
-  fl = fopen ("tmp_file.out", "rb");
   if (image->slice_plane == X12_PLANE){
-
-    k = GET_SLICE_INDEX (image->slice_plane, image->slice_coord, grid);
-    offset = k*nx*ny*dsize; 
-    fseek (fl, offset, SEEK_SET);
-    col_offset = 0;
-    row_offset = 0;
+    dn = KDIR; dc = IDIR; dr = JDIR;
     image->ncol = nx;
     image->nrow = ny;
-
   } else if (image->slice_plane == X13_PLANE){
-
-    j = GET_SLICE_INDEX (image->slice_plane, image->slice_coord, grid);
-    offset = j*nx*dsize;
-    fseek (fl, offset, SEEK_CUR);
-    col_offset = 0;
-    row_offset = nx*(ny - 1)*dsize; 
+    dn = JDIR; dc = IDIR; dr = KDIR;
     image->ncol = nx;
     image->nrow = nz;
-
-  } else if (image->slice_plane == X23_PLANE){
-    
-    i = GET_SLICE_INDEX (image->slice_plane, image->slice_coord, grid);
-    offset = i*dsize;
-    fseek (fl, offset, SEEK_CUR);
-    col_offset = (nx - 1)*dsize; 
-    row_offset = 0;
+  } else {
+    dn = IDIR; dc = JDIR; dr = KDIR;
     image->ncol = ny;
     image->nrow = nz;
+  }
+  islice = GET_SLICE_INDEX (image->slice_plane, image->slice_coord, grid);
+
+/* -----------------------------------------
+    Copy the local portion of the plane, if
+    any (global index of a local zone l is
+    loff + l - lbeg).
+   ----------------------------------------- */
+
+  for (n = 0; n < 3; n++){
+    loff[n] = grid->beg[n] - grid->gbeg[n];
+    nloc[n] = grid->np_int[n];
+  }
 
+  meta[0] = loff[dc];
+  meta[1] = loff[dr];
+  meta[2] = meta[3] = 0;
+  sbuf    = NULL;
+  if (islice >= loff[dn] && islice < loff[dn] + nloc[dn]){
+    meta[2] = nloc[dc];
+    meta[3] = nloc[dr];
+    sbuf = ARRAY_1D(meta[2]*meta[3], float);
+    ind[dn] = grid->lbeg[dn] + islice - loff[dn];
+    n = 0;
+    for (ir = 0; ir < meta[3]; ir++){
+    for (ic = 0; ic < meta[2]; ic++){
+      ind[dc] = grid->lbeg[dc] + ic;
+      ind[dr] = grid->lbeg[dr] + ir;
+      sbuf[n++] = (float)Vdbl[ind[KDIR]][ind[JDIR]][ind[IDIR]];
+    }}
   }
 
 /* -----------------------------------------
-            Read slice  
+    Gather the pieces on proc #0
    ----------------------------------------- */
 
-  for (ir = 0; ir < image->nrow; ir++) {
-    for (ic = 0; ic < image->ncol; ic++) {     
-      if ( fread (&xflt, dsize, 1, fl) != 1 ) { print("Unexpected exit! write_img.c:%d\n",254); QUIT_PLUTO(1);}
-      if (feof(fl)){
-         printf (" ! end of file reached\n");
-         QUIT_PLUTO(1);
+  #ifdef PARALLEL
+  {
+    static int *rmeta, *rcount, *rdispl;
+    int j, p, npc;
+
+    MPI_Comm_size (MPI_COMM_WORLD, &npc);
+    if (prank == 0 && rmeta == NULL){
+      rmeta  = ARRAY_1D(4*npc, int);
+      rcount = ARRAY_1D(npc, int);
+      rdispl = ARRAY_1D(npc, int);
+    }
+    MPI_Gather (meta, 4, MPI_INT, rmeta, 4, MPI_INT, 0, MPI_COMM_WORLD);
+    if (prank == 0){
+      for (p = 0; p < npc; p++){
+        rcount[p] = rmeta[4*p+2]*rmeta[4*p+3];
+        rdispl[p] = (p == 0 ? 0:rdispl[p-1] + rcount[p-1]);
       }
-      slice[image->nrow - 1 - ir][ic] = xflt;  /* -- swap row order -- */
-      if (col_offset > 0) fseek(fl, col_offset, SEEK_CUR);
     }
-    if (row_offset > 0) fseek(fl, row_offset, SEEK_CUR);
+    MPI_Gatherv (sbuf, meta[2]*meta[3], MPI_FLOAT, 
+                 rbuf, rcount, rdispl, MPI_FLOAT, 0, MPI_COMM_WORLD);
+    if (sbuf != NULL) FreeArray1D ((void *)sbuf);
+    if (prank != 0) return; /* -- rank 0 will do the rest -- */
+
+    for (p = 0; p < npc; p++){
+      float *q = rbuf + rdispl[p];
+      for (ir = 0; ir < rmeta[4*p+3]; ir++){
+      for (ic = 0; ic < rmeta[4*p+2]; ic++){
+        j = rmeta[4*p+1] + ir;     /* -- swap row order -- */
+        slice[image->nrow - 1 - j][rmeta[4*p] + ic] = *(q++);
+      }}
+    }
   }
-  fclose(fl);
+  #else
+  for (ir = 0; ir < meta[3]; ir++){
+  for (ic = 0; ic < meta[2]; ic++){
+    slice[image->nrow - 1 - ir][ic] = sbuf[ir*meta[2] + ic];  /* -- swap row order -- */
+  }}
+  if (sbuf != NULL) FreeArray1D ((void *)sbuf);
+  #endif
 
 /* -----------------------------------------------------------
          Get slice max and min 
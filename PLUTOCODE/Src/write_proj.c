@@ -0,0 +1,306 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Write in-situ line-of-sight projections in HDF5 format.
+
+  The proj output type integrates quantities along one or more
+  coordinate directions and writes only the resulting 2D maps
+  (column densities, emission measure, mass-weighted temperature...),
+  which are much smaller than full snapshots.
+  It is enabled in the [Static Grid Output] section of pluto.ini by
+  a line giving the output interval, the directions of integration
+  and the list of maps; each map is then defined on a line beginning
+  with its name:
+
+  \verbatim
+  proj       0.01  -1   x1  x3   Sigma  EM  Tmass
+  Sigma      rho     column
+  EM         nsq     column
+  Tmass      Tgrac   mass
+  \endverbatim
+
+  Quantities are those accepted by GetOutputQuantityIndex().
+  With \f$ dl \f$ the zone width along the direction of integration,
+  the modes are
+  - \c column:      \f$ \int q\,dl \f$;
+  - \c mass_column: \f$ \int \rho q\,dl \f$ (e.g. the column density
+                    of a species whose mass fraction is q);
+  - \c mass:        \f$ \int \rho q\,dl / \int \rho\,dl \f$;
+  - \c volume:      \f$ \int q\,dl / \int dl \f$.
+
+  Lengths are in code units and \f$ dl \f$ is the coordinate width
+  \c grid->dx, so that column modes are meaningful in Cartesian
+  coordinates only.
+
+  Each processor integrates its own sub-domain in a single pass over
+  all maps and directions; partial maps are then summed over the
+  processors sharing the same column along the direction of
+  integration and the resulting tiles are collected by processor 0,
+  which writes "proj.nnnn.h5".
+  The map of \c name integrated along \c xn is the dataset
+  "name_xn", with rows and columns following the remaining directions
+  in increasing order (e.g. (x2, x1) for a projection along x3).
+
+  \date   Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+#ifdef USE_HDF5
+#define H5_USE_16_API
+#include "hdf5.h"
+
+void WriteHDF5Attribute (hid_t, const char *, hid_t, int, void *);
+
+/* ********************************************************************* */
+void WriteProjections (const Data *d, Output *output, char *filename,
+                       Grid *grid)
+/*!
+ * Compute the projected maps of the proj output and write them to
+ * disk. Collective on MPI_COMM_WORLD.
+ *
+ * \param [in] d         pointer to Data structure
+ * \param [in] output    the output structure of the proj format
+ * \param [in] filename  the name of the HDF5 file
+ * \param [in] grid      pointer to Grid structure
+ *********************************************************************** */
+{
+  int    i, j, k, n, m, nm, l, ind[3];
+  int    dn, dc[3], dr[3], nc[3], nr[3], npix[3];
+  int    ncol, nrow;
+  long int step;
+  double *q, *w, dl, *num, *den, *map, *sbuf, *rbuf;
+  double *tile[3], *one;
+  static int *qid, *weighted;
+  static double **sq;
+  Runtime *runtime = RuntimeGet();
+  ProjDef *proj;
+  hid_t  file = 0, space, dataset;
+  hsize_t dims[2];
+  char   dname[64];
+  #ifdef PARALLEL
+  static MPI_Comm column_comm[3];
+  static int *rmeta, *rcount, *rdispl;
+  int    p, npc, col_rank, is_root;
+  int    ic, ir, meta[4];
+  #endif
+
+  nm = runtime->nproj;
+  if (nm == 0) return;
+
+/* --------------------------------------------------------
+   0. At the first call, resolve quantity names and build
+      the communicators of the processors sharing the same
+      column along each direction of integration.
+   -------------------------------------------------------- */
+
+  if (qid == NULL){
+    qid      = ARRAY_1D(nm, int);
+    weighted = ARRAY_1D(nm, int);
+    sq       = ARRAY_2D(nm, NX1_TOT, double);
+    for (m = 0; m < nm; m++){
+      proj = runtime->proj + m;
+      qid[m]      = GetOutputQuantityIndex (output, proj->var);
+      weighted[m] = (proj->mode[0] == 'm');  /* mass, mass_column */
+    }
+    #ifdef PARALLEL
+    {
+      MPI_Comm cartcomm;
+      int remain[3];
+
+      AL_Get_cart_comm(SZ, &cartcomm);
+      for (dn = 0; dn < DIMENSIONS; dn++){
+        if (!runtime->proj_axis[dn]) continue;
+        for (n = 0; n < DIMENSIONS; n++) remain[n] = (n == dn);
+        MPI_Cart_sub (cartcomm, remain, column_comm + dn);
+      }
+    }
+    #endif
+  }
+
+/* --------------------------------------------------------
+   1. Set the column (dc) and row (dr) directions of each
+      map and allocate the local partial sums:
+      tile[dn] = {num[0], den[0], num[1], den[1], ...}
+   -------------------------------------------------------- */
+
+  for (dn = 0; dn < 3; dn++){
+    tile[dn] = NULL;
+    if (!runtime->proj_axis[dn]) continue;
+    if      (dn == KDIR) {dc[dn] = IDIR; dr[dn] = JDIR;}
+    else if (dn == JDIR) {dc[dn] = IDIR; dr[dn] = KDIR;}
+    else                 {dc[dn] = JDIR; dr[dn] = KDIR;}
+    nc[dn]   = grid->np_int[dc[dn]];
+    nr[dn]   = grid->np_int[dr[dn]];
+    npix[dn] = nc[dn]*nr[dn];
+    tile[dn] = ARRAY_1D(2*nm*npix[dn], double);
+    for (l = 0; l < 2*nm*npix[dn]; l++) tile[dn][l] = 0.0;
+  }
+
+/* --------------------------------------------------------
+   2. Integrate all maps along all directions in a single
+      pass over the local domain
+   -------------------------------------------------------- */
+
+  one = ARRAY_1D(NX1_TOT, double);
+  for (i = 0; i < NX1_TOT; i++) one[i] = 1.0;
+
+  KDOM_LOOP(k) JDOM_LOOP(j){
+    ind[KDIR] = k - grid->lbeg[KDIR];
+    ind[JDIR] = j - grid->lbeg[JDIR];
+    for (m = 0; m < nm; m++){
+      q = GetOutputQuantityRow (d, output, qid[m], k, j, sq[m]);
+      w = weighted[m] ? d->Vc[RHO][k][j]:one;
+      for (dn = 0; dn < 3; dn++){
+        if (tile[dn] == NULL) continue;
+        num = tile[dn] + 2*m*npix[dn];
+        den = num + npix[dn];
+        IDOM_LOOP(i){
+          ind[IDIR] = i - grid->lbeg[IDIR];
+          l  = ind[dr[dn]]*nc[dn] + ind[dc[dn]];
+          dl = grid->dx[dn][grid->lbeg[dn] + ind[dn]]*w[i];
+          num[l] += q[i]*dl;
+          den[l] += dl;
+        }
+      }
+    }
+  }
+  FreeArray1D ((void *)one);
+
+  if (prank == 0){
+    file = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    if (file < 0){
+      printLog ("! WriteProjections(): cannot create %s\n", filename);
+      QUIT_PLUTO(1);
+    }
+    step = g_stepNumber;
+    WriteHDF5Attribute (file, "time", H5T_NATIVE_DOUBLE, 1, &g_time);
+    WriteHDF5Attribute (file, "step", H5T_NATIVE_LONG, 1, &step);
+  }
+
+  for (dn = 0; dn < 3; dn++){
+    if (tile[dn] == NULL) continue;
+
+  /* --------------------------------------------------------
+     3. Sum the partial maps over the processors of the
+        column; its first processor holds the result.
+     -------------------------------------------------------- */
+
+    #ifdef PARALLEL
+    MPI_Comm_rank (column_comm[dn], &col_rank);
+    is_root = (col_rank == 0);
+    MPI_Reduce (is_root ? MPI_IN_PLACE:tile[dn], tile[dn], 2*nm*npix[dn],
+                MPI_DOUBLE, MPI_SUM, 0, column_comm[dn]);
+    #endif
+
+  /* --------------------------------------------------------
+     4. Normalize averages and pack the maps as
+        sbuf[m][row][col]
+     -------------------------------------------------------- */
+
+    sbuf = tile[dn];    /* -- packed in place -- */
+    for (m = 0; m < nm; m++){
+      proj = runtime->proj + m;
+      num  = tile[dn] + 2*m*npix[dn];
+      den  = num + npix[dn];
+      map  = sbuf + m*npix[dn];
+      for (l = 0; l < npix[dn]; l++){
+        if (   strcmp(proj->mode, "mass") == 0
+            || strcmp(proj->mode, "volume") == 0){
+          map[l] = (den[l] != 0.0 ? num[l]/den[l]:0.0);
+        }else{
+          map[l] = num[l];
+        }
+      }
+    }
+
+  /* --------------------------------------------------------
+     5. Gather the tiles on processor 0
+     -------------------------------------------------------- */
+
+    ncol = grid->gend[dc[dn]] + 1 - grid->nghost[dc[dn]];
+    nrow = grid->gend[dr[dn]] + 1 - grid->nghost[dr[dn]];
+
+    #ifdef PARALLEL
+    meta[0] = grid->beg[dc[dn]] - grid->gbeg[dc[dn]];
+    meta[1] = grid->beg[dr[dn]] - grid->gbeg[dr[dn]];
+    meta[2] = is_root ? nc[dn]:0;
+    meta[3] = is_root ? nr[dn]:0;
+    MPI_Comm_size (MPI_COMM_WORLD, &npc);
+    if (prank == 0 && rmeta == NULL){
+      rmeta  = ARRAY_1D(4*npc, int);
+      rcount = ARRAY_1D(npc, int);
+      rdispl = ARRAY_1D(npc, int);
+    }
+    rbuf = NULL;
+    if (prank == 0) rbuf = ARRAY_1D(nm*ncol*nrow, double);
+    MPI_Gather (meta, 4, MPI_INT, rmeta, 4, MPI_INT, 0, MPI_COMM_WORLD);
+    if (prank == 0){
+      for (p = 0; p < npc; p++){
+        rcount[p] = nm*rmeta[4*p+2]*rmeta[4*p+3];
+        rdispl[p] = (p == 0 ? 0:rdispl[p-1] + rcount[p-1]);
+      }
+    }
+    MPI_Gatherv (sbuf, nm*meta[2]*meta[3], MPI_DOUBLE,
+                 rbuf, rcount, rdispl, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    #else
+    rbuf = sbuf;
+    #endif
+
+  /* --------------------------------------------------------
+     6. Assemble and write one dataset per map
+     -------------------------------------------------------- */
+
+    if (prank == 0){
+      double range[2];
+      int    axis = dn + 1;
+
+      map = ARRAY_1D(ncol*nrow, double);
+      for (m = 0; m < nm; m++){
+        proj = runtime->proj + m;
+        #ifdef PARALLEL
+        for (p = 0; p < npc; p++){
+          int *pm = rmeta + 4*p;
+          q = rbuf + rdispl[p] + m*pm[2]*pm[3];
+          for (ir = 0; ir < pm[3]; ir++){
+          for (ic = 0; ic < pm[2]; ic++){
+            map[(pm[1] + ir)*ncol + pm[0] + ic] = *(q++);
+          }}
+        }
+        #else
+        for (l = 0; l < ncol*nrow; l++) map[l] = rbuf[m*ncol*nrow + l];
+        #endif
+
+        n       = (nrow > 1 ? 2:1);
+        dims[0] = (n == 2 ? nrow:ncol);
+        dims[1] = ncol;
+        sprintf (dname, "%s_x%d", proj->name, axis);
+        space   = H5Screate_simple(n, dims, NULL);
+        dataset = H5Dcreate(file, dname, H5T_NATIVE_DOUBLE, space,
+                            H5P_DEFAULT);
+        H5Dwrite(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                 map);
+        WriteHDF5Attribute (dataset, "quantity", H5T_C_S1, strlen(proj->var),
+                            proj->var);
+        WriteHDF5Attribute (dataset, "mode", H5T_C_S1, strlen(proj->mode),
+                            proj->mode);
+        WriteHDF5Attribute (dataset, "axis", H5T_NATIVE_INT, 1, &axis);
+        range[0] = g_domBeg[dc[dn]];
+        range[1] = g_domEnd[dc[dn]];
+        WriteHDF5Attribute (dataset, "col_range", H5T_NATIVE_DOUBLE, 2, range);
+        range[0] = g_domBeg[dr[dn]];
+        range[1] = g_domEnd[dr[dn]];
+        WriteHDF5Attribute (dataset, "row_range", H5T_NATIVE_DOUBLE, 2, range);
+        H5Dclose(dataset);
+        H5Sclose(space);
+      }
+      FreeArray1D ((void *)map);
+      #ifdef PARALLEL
+      FreeArray1D ((void *)rbuf);
+      #endif
+    }
+    FreeArray1D ((void *)tile[dn]);
+  }
+
+  if (prank == 0) H5Fclose(file);
+}
+#endif /* USE_HDF5 */
@@ -0,0 +1,266 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Write sub-volume and/or coarsened snapshots.
+
+  Sub-volume outputs save the cell-centered output variables in a
+  region of interest and/or at a reduced resolution, e.g. a full
+  resolution view around a cloud together with a cheap, coarse view
+  of the whole box at high cadence.
+  Up to ::MAX_SUBVOL_OUTPUTS of them can be defined in the
+  [Static Grid Output] section of pluto.ini with the labels
+  \c sub1, \c sub2, ...:
+
+  \verbatim
+  sub1    0.01  -1   flt   4
+  sub2    0.1   -1   dbl   1   -0.5 0.5  -0.5 0.5  -0.5 0.5   cgs
+  \endverbatim
+
+  The fields are the output interval, the precision (\c dbl or
+  \c flt), an integer coarsening factor and, optionally, the
+  region of interest given by its lower and upper coordinates in
+  each direction (the whole domain by default).
+  The region contains the zones whose centers lie inside the box,
+  enlarged to a whole number of coarse zones; coarse zones are
+  aligned with the global grid (coarse zone \c n covers the zones
+  with global index \c n*f ... \c n*f+f-1) and hold the volume
+  average of the zones they contain, so that conserved densities
+  are preserved.
+  The coarsening factor must divide the size of each local domain
+  (the check is done at the first write).
+
+  Each processor averages its part of the region and writes it with
+  MPI-IO through a subarray file view, using the same layout as
+  single_file .dbl/.flt output: "subn.nnnn.dbl" (or .flt) contains
+  one array per variable, with variable names and endianity in
+  "subn.out".
+  The coordinates of the coarse zones are written to
+  "subn.grid.out", with the same format as grid.out.
+
+  \date   Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+
+static void WriteSubVolumeGrid (Output *, int *, int *, Grid *);
+
+/* ********************************************************************* */
+void WriteSubVolume (Output *output, double *units, char *filename,
+                     Grid *grid)
+/*!
+ * Average the output variables over the coarse zones of the region
+ * of interest and write them to disk.
+ * Collective on MPI_COMM_WORLD.
+ *
+ * \param [in] output    the output structure
+ * \param [in] units     the units of each variable
+ * \param [in] filename  the name of the data file
+ * \param [in] grid      pointer to Grid structure
+ *********************************************************************** */
+{
+  int    i, j, k, ic, jc, kc, nv, n, dir, misaligned;
+  int    f[3], ibeg[3], iend[3];    /* -- global region (fine zones) -- */
+  int    lo, hi, a, b;
+  int    fbeg[3], fend[3];          /* -- local region (local indices) -- */
+  int    nglob[3], nloc[3], start[3];
+  int    i0, i1, j0, j1, k0, k1;
+  long int ntot, ncell;
+  size_t dsize;
+  double sum, vol, ***V;
+  void   *buf;
+  static double *vbuf;
+  static float  *fbuf;
+  static long int nalloc;
+
+  dsize = strcmp(output->mode, "flt") == 0 ? sizeof(float):sizeof(double);
+
+/* --------------------------------------------------------
+   1. Find the region of interest (global indices, starting
+      at 0 in the first interior zone), its intersection
+      with the local domain and the coarse grid sizes.
+   -------------------------------------------------------- */
+
+  misaligned = 0;
+  ncell = 1;
+  ntot  = 1;
+  for (dir = 0; dir < 3; dir++){
+    double *x = grid->x_glob[dir] + grid->nghost[dir];
+    int    np = grid->np_int_glob[dir];
+
+    f[dir] = (dir < DIMENSIONS ? output->coarsen:1);
+    ibeg[dir] = 0;
+    iend[dir] = np - 1;
+    if (dir < DIMENSIONS){
+      while (ibeg[dir] < np && x[ibeg[dir]] < output->box[2*dir]) ibeg[dir]++;
+      while (iend[dir] >= 0 && x[iend[dir]] > output->box[2*dir+1]) iend[dir]--;
+    }
+    if (ibeg[dir] > iend[dir]){
+      print ("! WriteSubVolume(): empty region in %s output\n", output->ext);
+      QUIT_PLUTO(1);
+    }
+    ibeg[dir] = (ibeg[dir]/f[dir])*f[dir];
+    iend[dir] = MIN(np - 1, (iend[dir]/f[dir] + 1)*f[dir] - 1);
+    nglob[dir] = (iend[dir] - ibeg[dir])/f[dir] + 1;
+
+    lo = grid->beg[dir] - grid->gbeg[dir];
+    hi = lo + grid->np_int[dir] - 1;
+    a  = MAX(lo, ibeg[dir]);
+    b  = MIN(hi, iend[dir]);
+    if (a > b){
+      nloc[dir]  = 0;
+      start[dir] = 0;
+      fbeg[dir]  = 0;
+      fend[dir]  = -1;
+    }else{
+      if (   (a - ibeg[dir])%f[dir] != 0
+          || (b != iend[dir] && (b + 1 - ibeg[dir])%f[dir] != 0)) misaligned = 1;
+      start[dir] = (a - ibeg[dir])/f[dir];
+      nloc[dir]  = (b - a + f[dir])/f[dir];
+      fbeg[dir]  = grid->lbeg[dir] + a - lo;
+      fend[dir]  = grid->lbeg[dir] + b - lo;
+    }
+    ncell *= nloc[dir];
+    ntot  *= nglob[dir];
+  }
+
+  #ifdef PARALLEL
+  MPI_Allreduce (MPI_IN_PLACE, &misaligned, 1, MPI_INT, MPI_MAX,
+                 MPI_COMM_WORLD);
+  #endif
+  if (misaligned){
+    print ("! WriteSubVolume(): the coarsening factor of %s output (%d)\n",
+           output->ext, output->coarsen);
+    print ("!                   must divide the local domain size\n");
+    QUIT_PLUTO(1);
+  }
+
+  if (output->nfile == 0) WriteSubVolumeGrid (output, ibeg, iend, grid);
+
+  if (ncell > nalloc){
+    if (nalloc > 0){
+      FreeArray1D ((void *)vbuf);
+      FreeArray1D ((void *)fbuf);
+    }
+    nalloc = ncell;
+    vbuf   = ARRAY_1D(nalloc, double);
+    fbuf   = ARRAY_1D(nalloc, float);
+  }
+  buf = (dsize == sizeof(float) ? (void *)fbuf:(void *)vbuf);
+
+/* --------------------------------------------------------
+   2. Open the file and set the file view of the local
+      portion of the coarse arrays
+   -------------------------------------------------------- */
+
+  FileDelete (filename);  /* Avoid partial fill of pre-existing files */
+
+  #ifdef PARALLEL
+  MPI_File     fh;
+  MPI_Datatype etype, ftype;
+  MPI_Offset   offset = 0;
+  int gsize[3], lsize[3], lstart[3];
+
+  etype = (dsize == sizeof(float) ? MPI_FLOAT:MPI_DOUBLE);
+  ftype = etype;
+  if (ncell > 0){
+    for (dir = 0; dir < 3; dir++){   /* -- C order: [k][j][i] -- */
+      gsize[2-dir]  = nglob[dir];
+      lsize[2-dir]  = nloc[dir];
+      lstart[2-dir] = start[dir];
+    }
+    MPI_Type_create_subarray (3, gsize, lsize, lstart, MPI_ORDER_C, etype,
+                              &ftype);
+    MPI_Type_commit (&ftype);
+  }
+  if (MPI_File_open (MPI_COMM_WORLD, filename, MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                     MPI_INFO_NULL, &fh) != MPI_SUCCESS){
+    print ("! WriteSubVolume(): cannot open %s\n", filename);
+    QUIT_PLUTO(1);
+  }
+  #else
+  FILE *fbin = FileOpen (filename, 0, "w");
+  #endif
+
+/* --------------------------------------------------------
+   3. Average and write each variable
+   -------------------------------------------------------- */
+
+  for (nv = 0; nv < output->nvar; nv++){
+    if (!output->dump_var[nv]) continue;
+    V = output->V[nv];
+
+    n = 0;
+    for (kc = 0; kc < nloc[KDIR]; kc++){
+    for (jc = 0; jc < nloc[JDIR]; jc++){
+    for (ic = 0; ic < nloc[IDIR]; ic++){
+      k0 = fbeg[KDIR] + kc*f[KDIR]; k1 = MIN(k0 + f[KDIR] - 1, fend[KDIR]);
+      j0 = fbeg[JDIR] + jc*f[JDIR]; j1 = MIN(j0 + f[JDIR] - 1, fend[JDIR]);
+      i0 = fbeg[IDIR] + ic*f[IDIR]; i1 = MIN(i0 + f[IDIR] - 1, fend[IDIR]);
+      sum = vol = 0.0;
+      for (k = k0; k <= k1; k++){
+      for (j = j0; j <= j1; j++){
+      for (i = i0; i <= i1; i++){
+        sum += V[k][j][i]*grid->dV[k][j][i];
+        vol += grid->dV[k][j][i];
+      }}}
+      vbuf[n++] = sum/vol*units[nv];
+    }}}
+    if (dsize == sizeof(float)){
+      for (n = 0; n < ncell; n++) fbuf[n] = (float)vbuf[n];
+    }
+
+    #ifdef PARALLEL
+    MPI_File_set_view (fh, offset, etype, ftype, "native", MPI_INFO_NULL);
+    MPI_File_write_all (fh, buf, (int)ncell, etype, MPI_STATUS_IGNORE);
+    offset += ntot*dsize;
+    #else
+    fwrite (buf, dsize, ncell, fbin);
+    #endif
+  }
+
+  #ifdef PARALLEL
+  MPI_File_close (&fh);
+  if (ncell > 0) MPI_Type_free (&ftype);
+  #else
+  fclose (fbin);
+  #endif
+}
+
+/* ********************************************************************* */
+void WriteSubVolumeGrid (Output *output, int *ibeg, int *iend, Grid *grid)
+/*!
+ * Write the coarse zone interfaces of a sub-volume output to
+ * "<ext>.grid.out" using the grid.out format.
+ *
+ * \param [in] output  the output structure
+ * \param [in] ibeg    global index of the first zone of the region
+ * \param [in] iend    global index of the last zone of the region
+ * \param [in] grid    pointer to Grid structure
+ *********************************************************************** */
+{
+  int  dir, f, n, ngh, i0, i1;
+  char fname[512];
+  FILE *fg;
+
+  if (prank != 0) return;
+
+  sprintf (fname, "%s/%s.grid.out", output->dir, output->ext);
+  fg = fopen (fname, "w");
+  fprintf (fg, "# ******************************************************\n");
+  fprintf (fg, "# PLUTO %s Sub-volume Grid File (%s output)\n",
+           PLUTO_VERSION, output->ext);
+  fprintf (fg, "# Coarsening factor: %d\n", output->coarsen);
+  fprintf (fg, "# DIMENSIONS: %d\n", DIMENSIONS);
+  fprintf (fg, "# ******************************************************\n");
+  for (dir = 0; dir < 3; dir++){
+    f   = (dir < DIMENSIONS ? output->coarsen:1);
+    ngh = grid->nghost[dir];
+    fprintf (fg, "%d \n", (iend[dir] - ibeg[dir])/f + 1);
+    for (n = 0, i0 = ibeg[dir]; i0 <= iend[dir]; n++, i0 += f){
+      i1 = MIN(i0 + f - 1, iend[dir]);
+      fprintf (fg, " %d   %18.12e    %18.12e\n", n + 1,
+               grid->xl_glob[dir][i0 + ngh], grid->xr_glob[dir][i1 + ngh]);
+    }
+  }
+  fclose (fg);
+}
@@ -33,13 +33,20 @@
   For this reason, in 2D spherical cordinates we swap the role of the  
   "y" and "z" coordinates.
             
-  The WriteVTK_Vector() is fully parallel and is used to write data with 
-  the vector attribute (by default these include velocity and magnetic 
-  fields).
-   
-  The WriteVTK_Scalar() is fully parallel and is used to write data with 
-  the scalar attribute (by default these include density, pressure, tracer
-  and user-defined variables).
+  WriteVTK_Stream() writes a whole file with a single MPI-IO file
+  handle (a plain FILE in serial): since the size of each attribute
+  section is known in advance, processor 0 writes the grid and all the
+  attribute headers at open and each variable is then converted to
+  single precision (and byte-swapped) in chunks of ::VTK_CHUNK_SIZE
+  floats that are written collectively through a subarray file view.
+  Attributes with the vector attribute (by default velocity and
+  magnetic fields) are written first, followed by scalars (density,
+  pressure, tracers and user-defined variables).
+  The same function writes the XDMF alternative (enabled by the
+  \c xdmf keyword on the vtk line of pluto.ini): data, node
+  coordinates included, are stored in native byte order in a raw
+  binary file (.raw) described by a small XML file (.xmf), which
+  ParaView and VisIt read without byte swapping.
 
   \b Reference
 
@@ -66,36 +73,45 @@
  #define VTK_TIME_INFO  NO  /* VisIt to display data results            */
 #endif
 
+#ifndef VTK_CHUNK_SIZE        /* Number of floats converted and written */
+ #define VTK_CHUNK_SIZE 65536 /* at once by WriteVTK_Stream()           */
+#endif
+
+#if VTK_FORMAT == VTK_STRUCTURED_GRID
+static void VTKNodeCoord (double, double, double, float *);
+#endif
+static void VTKWriteHeader (void *, int, int);
+static void VTKWriteVar (Data_Arr, int, double, long int, Grid *);
+static void VTKWriteXdmf (Output *, int *, long int *, int, char *, Grid *);
+
+static int s_swap;        /* 1 if data must be converted to big endian */
+static long int s_offset; /* Current header offset in bytes           */
+#ifdef PARALLEL
+static MPI_File s_fh;
+#else
+static FILE *s_fp;
+#endif
+
 /* ---------------------------------------------------------
     The following macros are specific to this file only 
     and are used to ease up serial/parallel implementation
     for writing strings and real arrays 
    --------------------------------------------------------- */   
     
-#ifdef PARALLEL
- #define VTK_HEADER_WRITE_STRING(header) \
-         AL_Write_header (header, strlen(header), MPI_CHAR, SZ_Float_Vect);
- #define VTK_HEADER_WRITE_FLTARR(arr, nelem) \
-         AL_Write_header (arr, nelem, MPI_FLOAT, SZ_Float_Vect);
- #define VTK_HEADER_WRITE_DBLARR(arr, nelem) \
-         AL_Write_header (arr, nelem, MPI_DOUBLE, SZ_Float_Vect);
-#else
- #define VTK_HEADER_WRITE_STRING(header) \
-         fprintf (fvtk,header);
- #define VTK_HEADER_WRITE_FLTARR(arr,nelem) \
-         fwrite(arr, sizeof(float), nelem, fvtk);
- #define VTK_HEADER_WRITE_DBLARR(arr,nelem) \
-         fwrite(arr, sizeof(double), nelem, fvtk);
-#endif
+#define VTK_HEADER_WRITE_STRING(header) \
+        VTKWriteHeader (header, strlen(header), sizeof(char));
+#define VTK_HEADER_WRITE_FLTARR(arr, nelem) \
+        VTKWriteHeader (arr, nelem, sizeof(float));
+#define VTK_HEADER_WRITE_DBLARR(arr, nelem) \
+        VTKWriteHeader (arr, nelem, sizeof(double));
 
 /* ********************************************************************* */
-void WriteVTK_Header (FILE *fvtk, Grid *grid)
+void WriteVTK_Header (Grid *grid)
 /*!
- * Write VTK header in parallel or serial mode.
- * In parallel mode only processor 0 does the actual writing 
- * (see al_io.c/AL_Write_header).
+ * Write VTK header in parallel or serial mode to the file opened by
+ * WriteVTK_Stream().
+ * In parallel mode only processor 0 does the actual writing.
  * 
- * \param [in]  fvtk  pointer to file
  * \param [in]  grid  pointer to an array of Grid structures
  *
  * \todo  Write the grid using several processors. 
@@ -105,7 +121,11 @@ void WriteVTK_Header (FILE *fvtk, Grid *grid)
   long int nx1, nx2, nx3;
   char     header[128];
   float    x1, x2, x3;
-  static float  **node_coord, *xnode, *ynode, *znode;
+#if VTK_FORMAT == VTK_RECTILINEAR_GRID
+  static float  *xnode, *ynode, *znode;
+#else
+  static float  **node_coord;
+#endif
 
 /* -- Get global domain sizes -- */
 
@@ -209,7 +229,7 @@ void WriteVTK_Header (FILE *fvtk, Grid *grid)
 
   if (node_coord == NULL) node_coord = ARRAY_2D(nx1 + INCLUDE_IDIR, 3, float);
 
-  sprintf(header,"POINTS %d float\n", (nx1+INCLUDE_IDIR)*(nx2+INCLUDE_JDIR)*(nx3+INCLUDE_KDIR));
+  sprintf(header,"POINTS %ld float\n", (nx1+INCLUDE_IDIR)*(nx2+INCLUDE_JDIR)*(nx3+INCLUDE_KDIR));
   VTK_HEADER_WRITE_STRING(header);
 
 /* -- Write structured grid information -- */
@@ -222,25 +242,7 @@ void WriteVTK_Header (FILE *fvtk, Grid *grid)
                  x2 = grid->xl_glob[JDIR][JBEG + j];  ,
                  x3 = grid->xl_glob[KDIR][KBEG + k];)
        
-      #if (GEOMETRY == CARTESIAN) || (GEOMETRY == CYLINDRICAL)
-      node_coord[i][0] = x1;
-      node_coord[i][1] = x2;
-      node_coord[i][2] = x3;
-      #elif GEOMETRY == POLAR
-      node_coord[i][0] = x1*cos(x2);
-      node_coord[i][1] = x1*sin(x2);
-      node_coord[i][2] = x3;
-      #elif GEOMETRY == SPHERICAL
-      #if DIMENSIONS == 2
-      node_coord[i][0] = x1*sin(x2);
-      node_coord[i][1] = x1*cos(x2);
-      node_coord[i][2] = 0.0;
-      #elif DIMENSIONS == 3
-      node_coord[i][0] = x1*sin(x2)*cos(x3);
-      node_coord[i][1] = x1*sin(x2)*sin(x3);
-      node_coord[i][2] = x1*cos(x2);
-      #endif
-      #endif
+      VTKNodeCoord (x1, x2, x3, node_coord[i]);
       
       if (IsLittleEndian()){
         SWAP_VAR(node_coord[i][0]);
@@ -254,126 +256,381 @@ void WriteVTK_Header (FILE *fvtk, Grid *grid)
 #endif
 
 /* -----------------------------------------------------
-   5. Dataset attributes [will continue by later calls
-      to WriteVTK_Vector() or WriteVTK_Scalar()...]
+   5. Dataset attributes [will continue in
+      WriteVTK_Stream()...]
    ----------------------------------------------------- */
 
   sprintf (header,"\nCELL_DATA %ld\n", nx1*nx2*nx3);
   VTK_HEADER_WRITE_STRING (header);
 }
-#undef VTK_STRUCTERED_GRID    
-#undef VTK_RECTILINEAR_GRID  
 
 /* ********************************************************************* */
-void WriteVTK_Vector (FILE *fvtk, Data_Arr V, double unit,
-                      char *var_name, Grid *grid)
+void WriteVTK_Stream (Output *output, int nsel, double *units,
+                      char *filename, Grid *grid)
 /*!
- * Write VTK vector field data.
- * This is enabled only when VTK_VECTOR_DUMP is set to \c YES.
- * For generality purposes, vectors are written always with 3 
- * components, even when there're only 2 being used.
- *
- * The following Maple script has been used to find vector 
- * components from cyl/sph to cartesian:
- *
- * \code
-   restart;
-   with(linalg);
-   Acyl := matrix (3,3,[ cos(phi), sin(phi),  0,
-                      -sin(phi), cos(phi),  0,
-                        0     ,    0    , 1]);
-   Asph := matrix (3,3,[ sin(theta)*cos(phi), sin(theta)*sin(phi),  cos(theta),
-                   cos(theta)*cos(phi), cos(theta)*sin(phi), -sin(theta),
-                   -sin(phi)          , cos(phi)           , 0]);
-   Bcyl := simplify(inverse(Acyl));
-   Bsph := simplify(inverse(Asph));
- * \endcode
+ * Write a complete VTK file (or the XDMF raw file + XML description
+ * when output->xdmf is set) containing all the vector and scalar
+ * variables of the output, or only variable \c nsel if nsel >= 0.
+ * Vectors are written first, followed by scalars.
+ * Collective on MPI_COMM_WORLD.
  *
- * \param [in]  fvtk    pointer to file
- * \param [in]  V       a 4D array [nv][k][j][i] containing the vector
- *                      components (nv) defined at cell centers (k,j,i).
- *                      The index nv = 0 marks the vector first component.
- * \param [in] unit     the corresponding cgs unit (if specified, 1 otherwise)
- * \param [in] var_name the variable name appearing in the VTK file
- * \param [in]    grid  pointer to an array of Grid structures
+ * \param [in] output    the output structure
+ * \param [in] nsel      index of the variable to be written, or -1 for
+ *                       all of them
+ * \param [in] units     the units of each variable
+ * \param [in] filename  the name of the data file
+ * \param [in] grid      pointer to Grid structure
  *********************************************************************** */
 {
-  int i,j,k;
-  int vel_field, mag_field;
+  int  nv, pass, nw, ncomp;
+  int  var[MAX_OUTPUT_VARS];
+  long int ntot, offset[MAX_OUTPUT_VARS];
   char header[128];
-  static Float_Vect ***vect3D;
-  double v[3], x1, x2, x3;
 
-  if (vect3D == NULL){
-    vect3D = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, Float_Vect);
+  ntot =   (long int)(grid->gend[IDIR] + 1 - grid->nghost[IDIR])
+          *(grid->gend[JDIR] + 1 - grid->nghost[JDIR])
+          *(grid->gend[KDIR] + 1 - grid->nghost[KDIR]);
+
+/* --------------------------------------------------------
+   1. Open the file
+   -------------------------------------------------------- */
+
+#ifdef PARALLEL
+  if (MPI_File_open (MPI_COMM_WORLD, filename, MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                     MPI_INFO_NULL, &s_fh) != MPI_SUCCESS){
+    print ("! WriteVTK_Stream(): cannot open %s\n", filename);
+    QUIT_PLUTO(1);
+  }
+  MPI_File_set_size (s_fh, 0);  /* Avoid partial fill of pre-existing files */
+#else
+  s_fp = fopen (filename, "wb");
+  if (s_fp == NULL){
+    print ("! WriteVTK_Stream(): cannot open %s\n", filename);
+    QUIT_PLUTO(1);
+  }
+#endif
+  s_swap   = IsLittleEndian() && !output->xdmf;
+  s_offset = 0;
+
+/* --------------------------------------------------------
+   2. Write the grid and all attribute headers (processor 0)
+      and compute the offset of each data section.
+   -------------------------------------------------------- */
+
+  if (output->xdmf){
+    int   i, n, nx[3];
+
+    for (n = 0; n < 3; n++) nx[n] = grid->gend[n] + 1 - grid->nghost[n];
+    #if VTK_FORMAT == VTK_RECTILINEAR_GRID
+    float xn;
+
+    for (n = 0; n < 3; n++){
+      for (i = 0; i <= nx[n]; i++){
+        xn = (float)(i < nx[n] ? grid->xl_glob[n][grid->nghost[n] + i]
+                               : grid->xr_glob[n][grid->nghost[n] + i - 1]);
+        VTKWriteHeader (&xn, 1, sizeof(float));
+      }
+    }
+    #else
+    {
+      int    j, k;
+      static float **node_coord;
+      double x[3];
+
+      if (node_coord == NULL) node_coord = ARRAY_2D(nx[IDIR] + 1, 3, float);
+      for (k = 0; k <= nx[KDIR]; k++){
+      for (j = 0; j <= nx[JDIR]; j++){
+        for (i = 0; i <= nx[IDIR]; i++){
+          x[IDIR] = i < nx[IDIR] ? grid->xl_glob[IDIR][IBEG + i]
+                                 : grid->xr_glob[IDIR][IBEG + i - 1];
+          x[JDIR] = x[KDIR] = 0.0;
+          #if DIMENSIONS > 1
+          x[JDIR] = j < nx[JDIR] ? grid->xl_glob[JDIR][JBEG + j]
+                                 : grid->xr_glob[JDIR][JBEG + j - 1];
+          #endif
+          #if DIMENSIONS > 2
+          x[KDIR] = k < nx[KDIR] ? grid->xl_glob[KDIR][KBEG + k]
+                                 : grid->xr_glob[KDIR][KBEG + k - 1];
+          #endif
+          VTKNodeCoord (x[IDIR], x[JDIR], x[KDIR], node_coord[i]);
+        }
+        VTKWriteHeader (node_coord[0], 3*(nx[IDIR] + 1), sizeof(float));
+      }}
+    }
+    #endif
+  }else{
+    WriteVTK_Header (grid);
+  }
+
+  nw = 0;
+  for (pass = 0; pass < 2; pass++){   /* -- vectors first, then scalars -- */
+    for (nv = 0; nv < output->nvar; nv++){
+      if (nsel >= 0 && nv != nsel) continue;
+      if (output->dump_var[nv] != (pass == 0 ? VTK_VECTOR:YES)) continue;
+      if (pass == 0){
+        if      (strcmp(output->var_name[nv],"vx1") == 0)
+          sprintf (header,"\nVECTORS %dD_Velocity_Field float\n", DIMENSIONS);
+        else if (strcmp(output->var_name[nv],"Bx1") == 0)
+          sprintf (header,"\nVECTORS %dD_Magnetic_Field float\n", DIMENSIONS);
+        else continue;
+      }else{
+        sprintf (header,"\nSCALARS %s float\n", output->var_name[nv]);
+        sprintf (header+strlen(header),"LOOKUP_TABLE default\n");
+      }
+      if (!output->xdmf) VTK_HEADER_WRITE_STRING(header);
+      ncomp = (pass == 0 ? 3:1);
+      var[nw]    = nv;
+      offset[nw] = s_offset;
+      s_offset  += ntot*ncomp*sizeof(float);
+      nw++;
+    }
   }
 
 /* --------------------------------------------------------
-               Write VTK vector fields 
+   3. Convert and write data
    -------------------------------------------------------- */
 
+  for (nv = 0; nv < nw; nv++){
+    ncomp = (output->dump_var[var[nv]] == VTK_VECTOR ? 3:1);
+    VTKWriteVar (output->V + var[nv], ncomp, units[var[nv]], offset[nv], grid);
+  }
+
+#ifdef PARALLEL
+  MPI_File_close (&s_fh);
+#else
+  fclose (s_fp);
+#endif
+
+  if (output->xdmf) VTKWriteXdmf (output, var, offset, nw, filename, grid);
+}
+
+/* ********************************************************************* */
+void VTKWriteHeader (void *buf, int nelem, int size)
+/*!
+ * Write nelem elements of the given size (1, 4 or 8 bytes) belonging
+ * to the file header at the current header offset of the file opened
+ * by WriteVTK_Stream().
+ * In parallel mode only processor 0 does the actual writing.
+ *********************************************************************** */
+{
+  #ifdef PARALLEL
+  if (prank == 0){
+    MPI_File_write_at (s_fh, s_offset, buf, nelem*size, MPI_BYTE,
+                       MPI_STATUS_IGNORE);
+  }
+  #else
+  fseek  (s_fp, s_offset, SEEK_SET);
+  fwrite (buf, size, nelem, s_fp);
+  #endif
+  s_offset += (long int)nelem*size;
+}
+
+/* ********************************************************************* */
+void VTKWriteVar (Data_Arr V, int ncomp, double unit, long int offset,
+                  Grid *grid)
+/*!
+ * Convert a scalar (ncomp = 1) or vector (ncomp = 3, V[0..2] are the
+ * three components) variable to single precision
+ * and write it at the given file offset, one chunk at a time.
+ *
+ * In parallel, the local domain is described by a subarray file view
+ * and chunks are written with MPI_File_write_all(): since processors
+ * may have a different number of chunks, those that are done call it
+ * with zero elements until the largest number of calls is reached.
+ *********************************************************************** */
+{
+  int    i, j, k, n, m, nw;
+  long int ncells;
+  double v[3], x1, x2, x3;
+  static float *buf;
+
+  if (buf == NULL) buf = ARRAY_1D(VTK_CHUNK_SIZE, float);
+
+  ncells = VTK_CHUNK_SIZE/ncomp;   /* Zones per chunk */
+
+#ifdef PARALLEL
+  MPI_Datatype ftype;
+  int gsize[3], lsize[3], start[3];
+  int nchunk;
+  long int nloc;
+  static int nchunk_max[4];
+
+  nloc   = (long int)NX1*NX2*NX3;
+  nchunk = (nloc + ncells - 1)/ncells;
+
+  if (nchunk_max[ncomp] == 0){  /* -- Local sizes do not change -- */
+    MPI_Allreduce (&nchunk, nchunk_max + ncomp, 1, MPI_INT, MPI_MAX,
+                   MPI_COMM_WORLD);
+  }
+  for (n = 0; n < 3; n++){   /* -- C order: [k][j][i*ncomp] -- */
+    gsize[2-n] = grid->gend[n] + 1 - grid->nghost[n];
+    lsize[2-n] = grid->np_int[n];
+    start[2-n] = grid->beg[n] - grid->gbeg[n];
+  }
+  gsize[2] *= ncomp;
+  lsize[2] *= ncomp;
+  start[2] *= ncomp;
+  MPI_Type_create_subarray (3, gsize, lsize, start, MPI_ORDER_C, MPI_FLOAT,
+                            &ftype);
+  MPI_Type_commit (&ftype);
+  MPI_File_set_view (s_fh, offset, MPI_FLOAT, ftype, "native", MPI_INFO_NULL);
+#else
+  fseek (s_fp, offset, SEEK_SET);
+#endif
+
+  n  = 0;
+  nw = 0;
   v[0] = v[1] = v[2] = 0.0;
   x1 = x2 = x3 = 0.0;
-
-  vel_field = (strcmp(var_name,"vx1") == 0);
-  mag_field = (strcmp(var_name,"Bx1") == 0);
-  if (vel_field || mag_field) { 
-    DOM_LOOP(k,j,i){ 
+  DOM_LOOP(k,j,i){
+    if (ncomp == 1){
+      buf[n++] = (float)(V[0][k][j][i]*unit);
+    }else{
       DIM_EXPAND(v[0] = V[0][k][j][i]; x1 = grid->x[IDIR][i]; ,
                  v[1] = V[1][k][j][i]; x2 = grid->x[JDIR][j]; ,
                  v[2] = V[2][k][j][i]; x3 = grid->x[KDIR][k];)
-   
       VectorCartesianComponents(v, x1, x2, x3);
-      vect3D[k][j][i].v1 = (float)v[0]*unit;
-      vect3D[k][j][i].v2 = (float)v[1]*unit;
-      vect3D[k][j][i].v3 = (float)v[2]*unit;
+      buf[n++] = (float)v[0]*unit;
+      buf[n++] = (float)v[1]*unit;
+      buf[n++] = (float)v[2]*unit;
+    }
+    if (n == ncells*ncomp || (k == KEND && j == JEND && i == IEND)){
+      if (s_swap) for (m = 0; m < n; m++) SWAP_VAR(buf[m]);
+      #ifdef PARALLEL
+      MPI_File_write_all (s_fh, buf, n, MPI_FLOAT, MPI_STATUS_IGNORE);
+      #else
+      fwrite (buf, sizeof(float), n, s_fp);
+      #endif
+      nw++;
+      n = 0;
+    }
+  }
 
-      if (IsLittleEndian()){
-        SWAP_VAR(vect3D[k][j][i].v1);
-        SWAP_VAR(vect3D[k][j][i].v2);
-        SWAP_VAR(vect3D[k][j][i].v3);
-      }
+#ifdef PARALLEL
+  for (; nw < nchunk_max[ncomp]; nw++){
+    MPI_File_write_all (s_fh, buf, 0, MPI_FLOAT, MPI_STATUS_IGNORE);
+  }
+  MPI_Type_free (&ftype);
+#endif
+}
+
+/* ********************************************************************* */
+void VTKWriteXdmf (Output *output, int *var, long int *offset, int nw,
+                   char *filename, Grid *grid)
+/*!
+ * Write the XML description (.xmf) of the raw binary file written by
+ * WriteVTK_Stream() in XDMF mode.
+ * Only processor 0 does the actual writing.
+ *
+ * \param [in] output    the output structure
+ * \param [in] var       indices of the nw variables in the file
+ * \param [in] offset    byte offset of each variable in the file
+ * \param [in] nw        the number of variables
+ * \param [in] filename  the name of the raw data file
+ * \param [in] grid      pointer to Grid structure
+ *********************************************************************** */
+{
+  int  n, nx[3];
+  char fxmf[512], *dname, *ext, item[256], name[64];
+  FILE *fp;
 
-    } /* endfor DOM_LOOP(k,j,i) */
+  if (prank != 0) return;
 
-    if (vel_field)
-      sprintf (header,"\nVECTORS %dD_Velocity_Field float\n", DIMENSIONS);
-    else
-      sprintf (header,"\nVECTORS %dD_Magnetic_Field float\n", DIMENSIONS);
+  for (n = 0; n < 3; n++) nx[n] = grid->gend[n] + 1 - grid->nghost[n];
+
+  strcpy (fxmf, filename);
+  ext = strrchr (fxmf, '.');
+  if (ext == NULL) ext = fxmf + strlen(fxmf);
+  strcpy (ext, ".xmf");
+  dname = strrchr (filename, '/');   /* -- same directory as .xmf -- */
+  dname = (dname == NULL ? filename:dname + 1);
+
+  sprintf (item, "NumberType=\"Float\" Precision=\"4\" Format=\"Binary\" "
+                 "Endian=\"Native\"");
+
+  fp = fopen (fxmf, "w");
+  if (fp == NULL){
+    printLog ("! VTKWriteXdmf(): cannot open %s\n", fxmf);
+    return;
+  }
+  fprintf (fp, "<?xml version=\"1.0\" ?>\n");
+  fprintf (fp, "<!DOCTYPE Xdmf SYSTEM \"Xdmf.dtd\" []>\n");
+  fprintf (fp, "<Xdmf Version=\"2.0\">\n");
+  fprintf (fp, " <Domain>\n");
+  fprintf (fp, "  <Grid Name=\"PLUTO %s\" GridType=\"Uniform\">\n",
+           PLUTO_VERSION);
+  fprintf (fp, "   <Time Value=\"%12.6e\"/>\n", g_time);
+
+#if VTK_FORMAT == VTK_RECTILINEAR_GRID
+  fprintf (fp, "   <Topology TopologyType=\"3DRectMesh\" "
+               "Dimensions=\"%d %d %d\"/>\n", nx[KDIR] + 1, nx[JDIR] + 1,
+               nx[IDIR] + 1);
+  fprintf (fp, "   <Geometry GeometryType=\"VXVYVZ\">\n");
+  fprintf (fp, "    <DataItem Dimensions=\"%d\" %s Seek=\"0\">%s</DataItem>\n",
+           nx[IDIR] + 1, item, dname);
+  fprintf (fp, "    <DataItem Dimensions=\"%d\" %s Seek=\"%ld\">%s</DataItem>\n",
+           nx[JDIR] + 1, item, (long)(nx[IDIR] + 1)*sizeof(float), dname);
+  fprintf (fp, "    <DataItem Dimensions=\"%d\" %s Seek=\"%ld\">%s</DataItem>\n",
+           nx[KDIR] + 1, item, (long)(nx[IDIR] + nx[JDIR] + 2)*sizeof(float),
+           dname);
+#else
+  fprintf (fp, "   <Topology TopologyType=\"3DSMesh\" "
+               "Dimensions=\"%d %d %d\"/>\n", nx[KDIR] + 1, nx[JDIR] + 1,
+               nx[IDIR] + 1);
+  fprintf (fp, "   <Geometry GeometryType=\"XYZ\">\n");
+  fprintf (fp, "    <DataItem Dimensions=\"%d %d %d 3\" %s Seek=\"0\">%s"
+               "</DataItem>\n", nx[KDIR] + 1, nx[JDIR] + 1, nx[IDIR] + 1,
+               item, dname);
+#endif
+  fprintf (fp, "   </Geometry>\n");
+
+  for (n = 0; n < nw; n++){
+    int vector = (output->dump_var[var[n]] == VTK_VECTOR);
 
-    VTK_HEADER_WRITE_STRING(header);
-    FileWriteData (vect3D[0][0], sizeof(Float_Vect), SZ_Float_Vect, fvtk, -1);
+    if (!vector) strcpy (name, output->var_name[var[n]]);
+    else if (strcmp(output->var_name[var[n]],"vx1") == 0)
+      sprintf (name, "%dD_Velocity_Field", DIMENSIONS);
+    else
+      sprintf (name, "%dD_Magnetic_Field", DIMENSIONS);
+    fprintf (fp, "   <Attribute Name=\"%s\" AttributeType=\"%s\" "
+                 "Center=\"Cell\">\n", name, vector ? "Vector":"Scalar");
+    fprintf (fp, "    <DataItem Dimensions=\"%d %d %d%s\" %s Seek=\"%ld\">"
+                 "%s</DataItem>\n", nx[KDIR], nx[JDIR], nx[IDIR],
+                 vector ? " 3":"", item, offset[n], dname);
+    fprintf (fp, "   </Attribute>\n");
   }
+  fprintf (fp, "  </Grid>\n");
+  fprintf (fp, " </Domain>\n");
+  fprintf (fp, "</Xdmf>\n");
+  fclose (fp);
 }
 
+#if VTK_FORMAT == VTK_STRUCTURED_GRID
 /* ********************************************************************* */
-void WriteVTK_Scalar (FILE *fvtk, double ***V, double unit,
-                      char *var_name, Grid *grid)
+void VTKNodeCoord (double x1, double x2, double x3, float *xyz)
 /*!
- * Write VTK scalar field.
- * 
- * \param [in]   fvtk       pointer to file (handle)
- * \param [in]   V          pointer to 3D data array
- * \param [in] unit     the corresponding cgs unit (if specified, 1 otherwise)
- * \param [in]   var_name   the variable name appearing in the VTK file
- * \param [in]   grid       pointer to an array of Grid structures
+ * Compute the Cartesian coordinates of a grid node used by the
+ * structured grid topology (see the note on 2D datasets above).
  *********************************************************************** */
 {
-  int i,j,k;
-  char header[128];
-  float ***Vflt;
-
-  sprintf (header,"\nSCALARS %s float\n", var_name);
-  sprintf (header+strlen(header),"LOOKUP_TABLE default\n");
-
-  #ifdef PARALLEL
-   MPI_Barrier (MPI_COMM_WORLD);
-   AL_Write_header (header, strlen(header), MPI_CHAR, SZ_float);
-   MPI_Barrier (MPI_COMM_WORLD);
-  #else
-   fprintf (fvtk, "%s",header);
+  #if (GEOMETRY == CARTESIAN) || (GEOMETRY == CYLINDRICAL)
+  xyz[0] = x1;
+  xyz[1] = x2;
+  xyz[2] = x3;
+  #elif GEOMETRY == POLAR
+  xyz[0] = x1*cos(x2);
+  xyz[1] = x1*sin(x2);
+  xyz[2] = x3;
+  #elif GEOMETRY == SPHERICAL
+  #if DIMENSIONS == 2
+  xyz[0] = x1*sin(x2);
+  xyz[1] = x1*cos(x2);
+  xyz[2] = 0.0;
+  #elif DIMENSIONS == 3
+  xyz[0] = x1*sin(x2)*cos(x3);
+  xyz[1] = x1*sin(x2)*sin(x3);
+  xyz[2] = x1*cos(x2);
+  #endif
   #endif
-
-  Vflt = Convert_dbl2flt(V, unit, IsLittleEndian());
-  FileWriteData (Vflt[0][0], sizeof(float), SZ_float, fvtk, -1);
 }
+#endif
@@ -676,6 +676,12 @@ class DefineProblem(object):
       self.pluto_path.append('MHD/ShearingBox/')
       self.additional_flags.append(' -DSHEARINGBOX')
     
+    # -- Add path for Forced Turbulence --
+
+    if ('FORCED_TURB' in self.udef_const and
+        self.udef_const_vals[self.udef_const.index('FORCED_TURB')] == 'YES'):
+      self.pluto_path.append('Forced_Turb/')
+
     # -- Add path for Body Force --
 
     bd_force = self.default[self.entries.index('BODY_FORCE')]
@@ -0,0 +1,6 @@
+/* ---------------------------------------------------------------------
+   Prototypes shared by the benchmark drivers (see bench_tools.c)
+   --------------------------------------------------------------------- */
+
+double BenchClock (void);
+void   BenchSetGrid (int *, Grid *);
@@ -0,0 +1,446 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Grackle cooling benchmark with reference curves.
+
+  Reproducible version of the cooling test described in the README
+  (problem directory init.c + cooling.py): a uniform box of gas at rest
+  with n = 1e-2 cm^-3, initially at T0 = 2e6 K and in ionization
+  equilibrium, cools for about 1 Gyr.
+  As in the README test, the default is the FG2011 UV background
+  (CloudyData_UVB=FG2011.h5, set by the makefile); other tables are
+  selected with \c -grackle_data and \c -grackle_uvb.
+  Only call_grackle() is advanced (no hydrodynamics), with a time step
+  equal to a fraction of the shortest cooling time.
+
+  The code reports
+  - chemistry throughput (cells per second);
+  - how call_grackle() time is split between solve_chemistry(), the
+    derived-field calls (cooling time, temperature, pressure) and
+    marshalling of PLUTO arrays to/from Grackle fields;
+  - the maximum deviation of T(t) and de/dt from a stored reference
+    curve.
+
+  The cooling history (t, T, e, de/dt, Lambda) is written to
+  \c grackle_cooling_p<P>_Z<Z>.dat, the summary to a JSON file.
+  Reference curves are read from (or, with \c -save_ref, written to)
+  \c reference/grackle_cooling_p<P>_Z<Z>.dat.
+  The program exits with status 2 when the deviation exceeds
+  \c -tol and with status 3 when the reference curve is missing
+  (unless \c -save_ref is given), so it can be used as a regression
+  test.
+
+  Usage:
+  \verbatim
+  ./bench_grackle_cooling [-n nx ny nz] [-primordial p] [-Z z]
+                          [-T0 T] [-tstop Myr] [-cfl c] [-tol tol]
+                          [-ref file] [-save_ref] [-o file.json]
+                          [-grackle_data file] [-grackle_uvb 0|1]
+  \endverbatim
+
+  \date   Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+#include "globals.h"
+#include "bench.h"
+
+#ifndef BENCH_GRACKLE_DATA
+ #define BENCH_GRACKLE_DATA  "CloudyData_UVB=FG2011.h5"
+#endif
+
+#define MAX_STEPS  100000
+#define UNIT_TIME  (UNIT_LENGTH/UNIT_VELOCITY)
+#define MYR        (1.e6*365.25*86400.0)
+
+typedef struct CoolCurve_{
+  int     n;
+  double *t;     /**< Time [Myr] */
+  double *T;     /**< Mass-weighted temperature [K] */
+  double *e;     /**< Thermal energy density [erg cm^-3] */
+  double *dedt;  /**< de/dt [erg cm^-3 s^-1] */
+} CoolCurve;
+
+static void   CoolInitData (Data *, Grid *, double, double);
+static void   CoolAverage  (Data *, Grid *, double *, double *);
+static void   CoolCurveAlloc (CoolCurve *, int);
+static int    CoolCurveRead  (char *, CoolCurve *);
+static int    CoolCurveWrite (char *, CoolCurve *, double);
+static double CoolCurveInterp (double *, double *, int, double);
+
+/* ********************************************************************* */
+int main (int argc, char *argv[])
+/*!
+ * Parse command line options, evolve the cooling box and compare
+ * with the reference curve.
+ *********************************************************************** */
+{
+  int    n, nstep, nbox[3] = {12, 12, 12};
+  int    save_ref = 0, ref_found = 0, pass = 1;
+  long   ncells;
+  char   fdat[256], fref[256], fjson[256];
+  double Z = 1.0, T0 = 2.e6, tstop = 1000.0, cfl = 0.1, tol = 0.05;
+  double t, dt, e_old, T_avg, e_avg, nH;
+  double t_total, t_solve, t_derived, nchem, t_wall;
+  double dT_max = 0.0, de_max = 0.0, de_ref_max = 0.0, Tr, der;
+  Grid     grid;
+  Data     data;
+  timeStep Dts;
+  CoolCurve cc, ref;
+  FILE *fp;
+
+  g_grackle_params.grackle_verbose              = 0;
+  g_grackle_params.grackle_primordial_chemistry = 0;
+  g_grackle_params.grackle_dust_chemistry       = 0;
+  g_grackle_params.grackle_metal_cooling        = 1;
+  g_grackle_params.grackle_UVbackground         = 1;
+  g_grackle_params.grackle_use_temperature_floor    = 1;
+  g_grackle_params.grackle_temperature_floor_scalar = 1.e4;
+  strcpy (g_grackle_params.grackle_data_file, BENCH_GRACKLE_DATA);
+  fref[0] = '\0';
+  sprintf (fjson, "bench_grackle_cooling.json");
+
+  for (n = 1; n < argc; n++){
+    if (!strcmp(argv[n], "-n") && n + 3 < argc){
+      nbox[IDIR] = atoi(argv[++n]);
+      nbox[JDIR] = atoi(argv[++n]);
+      nbox[KDIR] = atoi(argv[++n]);
+    }else if (!strcmp(argv[n], "-primordial") && n + 1 < argc){
+      g_grackle_params.grackle_primordial_chemistry = atoi(argv[++n]);
+    }else if (!strcmp(argv[n], "-Z") && n + 1 < argc){
+      Z = atof(argv[++n]);
+    }else if (!strcmp(argv[n], "-T0") && n + 1 < argc){
+      T0 = atof(argv[++n]);
+    }else if (!strcmp(argv[n], "-tstop") && n + 1 < argc){
+      tstop = atof(argv[++n]);
+    }else if (!strcmp(argv[n], "-cfl") && n + 1 < argc){
+      cfl = atof(argv[++n]);
+    }else if (!strcmp(argv[n], "-tol") && n + 1 < argc){
+      tol = atof(argv[++n]);
+    }else if (!strcmp(argv[n], "-ref") && n + 1 < argc){
+      strcpy (fref, argv[++n]);
+    }else if (!strcmp(argv[n], "-save_ref")){
+      save_ref = 1;
+    }else if (!strcmp(argv[n], "-o") && n + 1 < argc){
+      strcpy (fjson, argv[++n]);
+    }else if (!strcmp(argv[n], "-grackle_data") && n + 1 < argc){
+      strcpy (g_grackle_params.grackle_data_file, argv[++n]);
+    }else if (!strcmp(argv[n], "-grackle_uvb") && n + 1 < argc){
+      g_grackle_params.grackle_UVbackground = atoi(argv[++n]);
+    }else{
+      printf ("! Unknown or incomplete option '%s'\n", argv[n]);
+      printf ("  Usage: %s [-n nx ny nz] [-primordial p] [-Z z] [-T0 T]\n"
+              "         [-tstop Myr] [-cfl c] [-tol tol] [-ref file] [-save_ref]\n"
+              "         [-o file.json] [-grackle_data file] [-grackle_uvb 0|1]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+  if (nbox[IDIR] < 1 || nbox[JDIR] < 1 || nbox[KDIR] < 1 || cfl <= 0.0){
+    printf ("! Invalid box size or cfl\n");
+    return 1;
+  }
+
+  sprintf (fdat, "grackle_cooling_p%d_Z%.2f.dat",
+           g_grackle_params.grackle_primordial_chemistry, Z);
+  if (fref[0] == '\0') sprintf (fref, "reference/%s", fdat);
+
+  prank    = 0;
+  g_nprocs = 1;
+  g_gamma  = 5.0/3.0;
+  g_minCoolingTemp = 1.e4;
+
+/* --------------------------------------------------------
+   1. Grid and data, initial equilibrium
+   -------------------------------------------------------- */
+
+  memset (&grid, 0, sizeof(Grid));
+  memset (&data, 0, sizeof(Data));
+  memset (&Dts,  0, sizeof(timeStep));
+
+  BenchSetGrid (nbox, &grid);
+  ncells = (long)NX1*NX2*NX3;
+
+  data.Vc    = ARRAY_4D(NVAR, NX3_TOT, NX2_TOT, NX1_TOT, double);
+  data.Vgrac = ARRAY_4D(3, NX3_TOT, NX2_TOT, NX1_TOT, double);
+  data.flag  = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, unsigned char);
+
+  CoolInitData (&data, &grid, T0, Z);
+  call_grackle_equil (&data, &grid);
+  grackle_timing_info (&t_total, &t_solve, &t_derived, &nchem, 1);
+
+  printf ("> Grackle cooling benchmark\n");
+  printf ("  box = %d x %d x %d, primordial_chemistry = %d, Z = %g Zsun\n",
+          nbox[IDIR], nbox[JDIR], nbox[KDIR],
+          g_grackle_params.grackle_primordial_chemistry, Z);
+  printf ("  T0 = %g K, tstop = %g Myr, data = %s\n", T0, tstop,
+          g_grackle_params.grackle_data_file);
+
+/* --------------------------------------------------------
+   2. Evolve: dt = cfl x (shortest cooling time), allowed
+      to grow by at most a factor of two per step
+   -------------------------------------------------------- */
+
+  CoolCurveAlloc (&cc, MAX_STEPS + 1);
+  CoolAverage (&data, &grid, &T_avg, &e_avg);
+  cc.t[0] = 0.0; cc.T[0] = T_avg; cc.e[0] = e_avg; cc.dedt[0] = 0.0;
+
+  tstop *= MYR/UNIT_TIME;
+  t      = 0.0;
+  dt     = 1.e-6*tstop;
+  t_wall = BenchClock();
+  for (nstep = 1; nstep <= MAX_STEPS && t < tstop; nstep++){
+    dt    = MIN(dt, tstop - t);
+    e_old = e_avg;
+    call_grackle (&data, dt, &Dts, &grid, 0, 0, 0, 0);
+    t    += dt;
+
+    CoolAverage (&data, &grid, &T_avg, &e_avg);
+    cc.t[nstep]    = t*UNIT_TIME/MYR;
+    cc.T[nstep]    = T_avg;
+    cc.e[nstep]    = e_avg;
+    cc.dedt[nstep] = (e_avg - e_old)/(dt*UNIT_TIME);
+
+    dt = MIN(cfl*Dts.dt_cool, 2.0*dt);
+    if (dt <= 0.0 || dt != dt){
+      printf ("! Invalid time step (dt_cool = %e) at step %d\n", Dts.dt_cool, nstep);
+      return 1;
+    }
+  }
+  cc.n   = nstep;
+  t_wall = BenchClock() - t_wall;
+
+  nH = 0.71*UNIT_DENSITY/CONST_mp;   /* rho = 1, as in the problem Analysis() */
+  CoolCurveWrite (fdat, &cc, nH);
+  if (save_ref && !CoolCurveWrite (fref, &cc, nH)) return 1;
+
+/* --------------------------------------------------------
+   3. Performance summary
+   -------------------------------------------------------- */
+
+  grackle_timing_info (&t_total, &t_solve, &t_derived, &nchem, 0);
+  printf ("\n  steps              = %d\n", cc.n - 1);
+  printf ("  wall time          = %10.3e s\n", t_wall);
+  printf ("  chemistry cells/s  = %10.3e\n", nchem/t_total);
+  printf ("  solve_chemistry    = %10.3e s (%5.1f%%)\n", t_solve,
+          100.0*t_solve/t_total);
+  printf ("  derived fields     = %10.3e s (%5.1f%%)\n", t_derived,
+          100.0*t_derived/t_total);
+  printf ("  marshalling        = %10.3e s (%5.1f%%)\n",
+          t_total - t_solve - t_derived,
+          100.0*(t_total - t_solve - t_derived)/t_total);
+
+/* --------------------------------------------------------
+   4. Compare with reference: relative deviation of T and
+      deviation of de/dt normalized to max |de/dt|_ref
+   -------------------------------------------------------- */
+
+  if (!save_ref) ref_found = CoolCurveRead (fref, &ref);
+  if (ref_found){
+    for (n = 0; n < ref.n; n++) de_ref_max = MAX(de_ref_max, fabs(ref.dedt[n]));
+    for (n = 1; n < cc.n; n++){
+      if (cc.t[n] > ref.t[ref.n-1]) break;
+      Tr     = CoolCurveInterp (ref.t, ref.T, ref.n, cc.t[n]);
+      der    = CoolCurveInterp (ref.t, ref.dedt, ref.n, cc.t[n]);
+      dT_max = MAX(dT_max, fabs(cc.T[n]/Tr - 1.0));
+      if (de_ref_max > 0.0) de_max = MAX(de_max, fabs(cc.dedt[n] - der)/de_ref_max);
+    }
+    pass = (dT_max <= tol && de_max <= tol);
+    printf ("\n  reference          = %s\n", fref);
+    printf ("  max |T/T_ref - 1|  = %10.3e\n", dT_max);
+    printf ("  max |de/dt - ref|  = %10.3e (relative to max |de/dt|_ref)\n", de_max);
+    printf ("  tolerance          = %10.3e -> %s\n", tol, pass ? "PASSED":"FAILED");
+  }else if (save_ref){
+    printf ("\n  reference curve written to %s\n", fref);
+  }else{
+    printf ("\n  ! reference curve %s not found\n", fref);
+    pass = 0;
+  }
+
+/* --------------------------------------------------------
+   5. JSON summary
+   -------------------------------------------------------- */
+
+  fp = fopen(fjson, "w");
+  if (fp != NULL){
+    fprintf (fp, "{\n");
+    fprintf (fp, "  \"benchmark\": \"grackle_cooling\",\n");
+    fprintf (fp, "  \"box\": [%d, %d, %d],\n", nbox[IDIR], nbox[JDIR], nbox[KDIR]);
+    fprintf (fp, "  \"primordial_chemistry\": %d,\n",
+             g_grackle_params.grackle_primordial_chemistry);
+    fprintf (fp, "  \"metallicity\": %g,\n", Z);
+    fprintf (fp, "  \"T0\": %g,\n", T0);
+    fprintf (fp, "  \"steps\": %d,\n", cc.n - 1);
+    fprintf (fp, "  \"cells\": %ld,\n", ncells);
+    fprintf (fp, "  \"wall_time\": %.6e,\n", t_wall);
+    fprintf (fp, "  \"chemistry_cells_per_sec\": %.6e,\n", nchem/t_total);
+    fprintf (fp, "  \"time_solve_chemistry\": %.6e,\n", t_solve);
+    fprintf (fp, "  \"time_derived_fields\": %.6e,\n", t_derived);
+    fprintf (fp, "  \"time_marshalling\": %.6e,\n", t_total - t_solve - t_derived);
+    if (ref_found){
+      fprintf (fp, "  \"reference\": \"%s\",\n", fref);
+      fprintf (fp, "  \"max_dev_T\": %.6e,\n", dT_max);
+      fprintf (fp, "  \"max_dev_dedt\": %.6e,\n", de_max);
+      fprintf (fp, "  \"tolerance\": %g,\n", tol);
+    }
+    fprintf (fp, "  \"passed\": %s\n", save_ref ? "null":(pass ? "true":"false"));
+    fprintf (fp, "}\n");
+    fclose (fp);
+  }
+  printf ("\n> History written to %s, summary to %s\n", fdat, fjson);
+
+  if (!pass) return (ref_found ? 2:3);
+  return 0;
+}
+
+/* ********************************************************************* */
+void CoolInitData (Data *d, Grid *grid, double T0, double Z)
+/*!
+ * Fully ionized gas at rest with rho = 1 (n = 1e-2 cm^-3) and
+ * temperature T0, as in the problem InitDomain().
+ *********************************************************************** */
+{
+  int i, j, k, nv;
+  double tiny_number = 1.e-20;
+
+  TOT_LOOP(k,j,i){
+    d->Vc[RHO][k][j][i] = 1.0;
+    d->Vc[PRS][k][j][i] = ((d->Vc[RHO][k][j][i]*UNIT_DENSITY)/(0.609*CONST_mp)*CONST_kB*T0)
+                          /(UNIT_DENSITY*pow(UNIT_VELOCITY,2));
+    d->Vc[VX1][k][j][i] = 0.0;
+    d->Vc[VX2][k][j][i] = 0.0;
+    d->Vc[VX3][k][j][i] = 0.0;
+    NSCL_LOOP(nv) d->Vc[nv][k][j][i] = 0.0;
+
+    d->Vgrac[TEMP][k][j][i] = T0;
+    d->Vgrac[MU][k][j][i]   = 0.609;
+    d->Vgrac[TCOOL][k][j][i] = 0.0;
+
+    d->Vc[X_HI][k][j][i]    = tiny_number;
+    d->Vc[X_HII][k][j][i]   = 1.0;
+    d->Vc[Y_HeI][k][j][i]   = tiny_number;
+    d->Vc[Y_HeII][k][j][i]  = tiny_number;
+    d->Vc[Y_HeIII][k][j][i] = 1.0;
+    d->Vc[X_HM][k][j][i]    = tiny_number;
+    d->Vc[X_H2I][k][j][i]   = tiny_number;
+    d->Vc[X_H2II][k][j][i]  = tiny_number;
+    d->Vc[X_DI][k][j][i]    = tiny_number;
+    d->Vc[X_DII][k][j][i]   = 2.0*3.4e-05;
+    d->Vc[X_HDI][k][j][i]   = tiny_number;
+    d->Vc[Z_MET][k][j][i]   = Z;
+  }
+}
+
+/* ********************************************************************* */
+void CoolAverage (Data *d, Grid *grid, double *T_avg, double *e_avg)
+/*!
+ * Compute the mass-weighted temperature [K] and the average thermal
+ * energy density [erg cm^-3] over the box.
+ *********************************************************************** */
+{
+  int i, j, k;
+  double T = 0.0, m = 0.0, e = 0.0, vol = 0.0;
+
+  DOM_LOOP(k,j,i){
+    T   += d->Vc[RHO][k][j][i]*d->Vgrac[TEMP][k][j][i]*grid->dV[k][j][i];
+    m   += d->Vc[RHO][k][j][i]*grid->dV[k][j][i];
+    e   += d->Vc[PRS][k][j][i]/(g_gamma - 1.0)*grid->dV[k][j][i];
+    vol += grid->dV[k][j][i];
+  }
+  *T_avg = T/m;
+  *e_avg = e/vol*UNIT_DENSITY*UNIT_VELOCITY*UNIT_VELOCITY;
+}
+
+/* ********************************************************************* */
+void CoolCurveAlloc (CoolCurve *c, int n)
+/*!
+ * Allocate memory for a cooling curve with at most \c n points.
+ *********************************************************************** */
+{
+  c->n    = 0;
+  c->t    = ARRAY_1D(n, double);
+  c->T    = ARRAY_1D(n, double);
+  c->e    = ARRAY_1D(n, double);
+  c->dedt = ARRAY_1D(n, double);
+}
+
+/* ********************************************************************* */
+int CoolCurveWrite (char *fname, CoolCurve *c, double nH)
+/*!
+ * Write a cooling curve to disk in ASCII format.
+ *
+ * \return 1 on success, 0 if the file cannot be opened.
+ *********************************************************************** */
+{
+  int n;
+  FILE *fp;
+
+  fp = fopen(fname, "w");
+  if (fp == NULL){
+    printf ("! CoolCurveWrite(): cannot open %s\n", fname);
+    return 0;
+  }
+  fprintf (fp, "# primordial_chemistry = %d\n",
+           g_grackle_params.grackle_primordial_chemistry);
+  fprintf (fp, "# %-14s %14s %14s %14s %14s\n", "t [Myr]", "T [K]",
+           "e [erg/cm^3]", "de/dt [cgs]", "Lambda [cgs]");
+  for (n = 0; n < c->n; n++){
+    fprintf (fp, "  %14.7e %14.7e %14.7e %14.7e %14.7e\n", c->t[n], c->T[n],
+             c->e[n], c->dedt[n], -c->dedt[n]/(nH*nH));
+  }
+  fclose (fp);
+  return 1;
+}
+
+/* ********************************************************************* */
+int CoolCurveRead (char *fname, CoolCurve *c)
+/*!
+ * Read a cooling curve written by CoolCurveWrite().
+ *
+ * \return 1 on success, 0 if the file cannot be opened or is empty.
+ *********************************************************************** */
+{
+  int  n = 0;
+  char line[512];
+  double t, T, e, dedt;
+  FILE *fp;
+
+  fp = fopen(fname, "r");
+  if (fp == NULL) return 0;
+
+  while (fgets(line, sizeof(line), fp) != NULL){
+    if (line[0] == '#') continue;
+    if (sscanf(line, "%lf %lf %lf %lf", &t, &T, &e, &dedt) == 4) n++;
+  }
+  if (n < 2){
+    fclose (fp);
+    return 0;
+  }
+
+  CoolCurveAlloc (c, n);
+  rewind (fp);
+  while (fgets(line, sizeof(line), fp) != NULL && c->n < n){
+    if (line[0] == '#') continue;
+    if (sscanf(line, "%lf %lf %lf %lf", c->t + c->n, c->T + c->n,
+               c->e + c->n, c->dedt + c->n) == 4) c->n++;
+  }
+  fclose (fp);
+  return 1;
+}
+
+/* ********************************************************************* */
+double CoolCurveInterp (double *x, double *y, int n, double x0)
+/*!
+ * Linear interpolation of the tabulated function y(x) at x0.
+ * \c x must be monotonically increasing.
+ *********************************************************************** */
+{
+  int i;
+
+  if (x0 <= x[0])   return y[0];
+  if (x0 >= x[n-1]) return y[n-1];
+  i = LocateIndex(x, 0, n - 1, x0);
+  if (i < 0)      i = 0;
+  if (i >= n - 1) i = n - 2;
+  return y[i] + (y[i+1] - y[i])*(x0 - x[i])/(x[i+1] - x[i]);
+}
@@ -0,0 +1,554 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Stand-alone throughput benchmark for PLUTO computational kernels.
+
+  Time the main hydrodynamic kernels on a synthetic, uniform Cartesian
+  box without MPI, without a problem directory and without reading
+  pluto.ini.
+  The kernels are exactly the objects linked into PLUTO (they are
+  compiled from the same sources) and are called the same way
+  UpdateStage() calls them, one x1-pencil at a time:
+
+  - States()                              (reconstruction)
+  - HLLC, HLL, LF (tvdlf), Roe, AUSM+     (Riemann solvers)
+  - PrimToCons() / ConsToPrim()
+  - AdvectFlux()                          (only when NSCL > 0)
+  - Radiat()                              (TABULATED / TOWNSEND cooling)
+  - call_grackle()                        (GRACKLE cooling, whole box)
+
+  Reconstruction, cooling and the number of variables are compile-time
+  choices in PLUTO: each combination is built as a separate executable
+  by the makefile in this directory.
+
+  For every kernel the box is swept repeatedly until at least
+  \c -tmin seconds have been accumulated; the best repetition is
+  retained.
+  Only the kernel call is timed: filling the pencil from the 3D arrays
+  (and computing the input states, when needed) is excluded.
+  Results are printed on screen and written in JSON format: for each
+  kernel we give the throughput in cells per second and the nominal
+  number of bytes per cell, i.e., the size of the array operands read
+  and written by the kernel (not a hardware counter measurement).
+  Their product gives the effective bandwidth.
+
+  Usage:
+  \verbatim
+  ./bench_plm [-n nx ny nz] [-tmin t] [-o file.json]
+              [-grackle_data file] [-grackle_uvb 0|1]
+  \endverbatim
+  Use e.g. "-n 512 1 1" for a single pencil.
+
+  \date   Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+#include "globals.h"
+#include "bench.h"
+
+#ifndef BENCH_NAME
+ #define BENCH_NAME  "bench"
+#endif
+
+#ifndef BENCH_GRACKLE_DATA
+ #define BENCH_GRACKLE_DATA  "CloudyData_noUVB.h5"
+#endif
+
+#define BENCH_MAX_KERNELS  32
+
+typedef double (BenchKernel)(Data *, Sweep *, Grid *);
+
+typedef struct BenchResult_{
+  char   name[32];
+  long   ncells;   /**< Number of cells processed in one repetition */
+  long   nrep;     /**< Number of timed repetitions */
+  double tbest;    /**< Best (minimum) time per repetition */
+  double tavg;     /**< Average time per repetition */
+  double bytes;    /**< Nominal bytes per cell */
+} BenchResult;
+
+static BenchResult bench_result[BENCH_MAX_KERNELS];
+static int    bench_nresults = 0;
+static double bench_tmin     = 0.5;
+
+static Riemann_Solver *bench_solver;
+static double *bench_cmax;
+
+static void   BenchInitData (Data *, Grid *);
+static void   BenchLoadPencil (Data *, Sweep *, int, int);
+static void   BenchRun (const char *, BenchKernel *, double,
+                        Data *, Sweep *, Grid *);
+static void   BenchWriteJSON (char *, int *);
+
+static BenchKernel BenchStates, BenchRiemann, BenchPrimToCons,
+                   BenchConsToPrim;
+#if NSCL > 0
+static BenchKernel BenchAdvectFlux;
+#endif
+#if COOLING == TABULATED || COOLING == TOWNSEND
+static BenchKernel BenchRadiat;
+#elif COOLING == GRACKLE
+static BenchKernel BenchGrackle;
+static double ****bench_V0;
+#endif
+
+/* ********************************************************************* */
+int main (int argc, char *argv[])
+/*!
+ * Parse command line options, set up the synthetic box and run all
+ * the kernels available in this configuration.
+ *********************************************************************** */
+{
+  int    n, nbox[3] = {128, 32, 32};
+  char   fname[256];
+  Grid   grid;
+  Data   data;
+  Sweep  sweep;
+
+  sprintf (fname, "%s.json", BENCH_NAME);
+#if COOLING == GRACKLE
+  g_grackle_params.grackle_verbose              = 0;
+  g_grackle_params.grackle_primordial_chemistry = 0;
+  g_grackle_params.grackle_dust_chemistry       = 0;
+  g_grackle_params.grackle_metal_cooling        = 1;
+  g_grackle_params.grackle_UVbackground         = 0;
+  g_grackle_params.grackle_use_temperature_floor    = 1;
+  g_grackle_params.grackle_temperature_floor_scalar = 1.e4;
+  strcpy (g_grackle_params.grackle_data_file, BENCH_GRACKLE_DATA);
+#endif
+
+  for (n = 1; n < argc; n++){
+    if (!strcmp(argv[n], "-n") && n + 3 < argc){
+      nbox[IDIR] = atoi(argv[++n]);
+      nbox[JDIR] = atoi(argv[++n]);
+      nbox[KDIR] = atoi(argv[++n]);
+    }else if (!strcmp(argv[n], "-tmin") && n + 1 < argc){
+      bench_tmin = atof(argv[++n]);
+    }else if (!strcmp(argv[n], "-o") && n + 1 < argc){
+      strcpy (fname, argv[++n]);
+#if COOLING == GRACKLE
+    }else if (!strcmp(argv[n], "-grackle_data") && n + 1 < argc){
+      strcpy (g_grackle_params.grackle_data_file, argv[++n]);
+    }else if (!strcmp(argv[n], "-grackle_uvb") && n + 1 < argc){
+      g_grackle_params.grackle_UVbackground = atoi(argv[++n]);
+#endif
+    }else{
+      printf ("! Unknown or incomplete option '%s'\n", argv[n]);
+      printf ("  Usage: %s [-n nx ny nz] [-tmin t] [-o file.json]", argv[0]);
+#if COOLING == GRACKLE
+      printf (" [-grackle_data file] [-grackle_uvb 0|1]");
+#endif
+      printf ("\n");
+      return 1;
+    }
+  }
+  if (nbox[IDIR] < 1 || nbox[JDIR] < 1 || nbox[KDIR] < 1){
+    printf ("! Invalid box size\n");
+    return 1;
+  }
+
+  prank    = 0;
+  g_nprocs = 1;
+  g_dt     = 1.e-3;
+  g_time   = 0.0;
+  g_maxRiemannIter = 5;
+  g_maxRootIter    = 50;
+
+/* --------------------------------------------------------
+   1. Grid, data and sweep structures
+   -------------------------------------------------------- */
+
+  memset (&grid,  0, sizeof(Grid));
+  memset (&data,  0, sizeof(Data));
+  memset (&sweep, 0, sizeof(Sweep));
+
+  BenchSetGrid (nbox, &grid);
+
+  data.Vc   = ARRAY_4D(NVAR, NX3_TOT, NX2_TOT, NX1_TOT, double);
+  data.flag = ARRAY_3D(NX3_TOT, NX2_TOT, NX1_TOT, unsigned char);
+#if COOLING == GRACKLE
+  data.Vgrac = ARRAY_4D(3, NX3_TOT, NX2_TOT, NX1_TOT, double);
+  bench_V0   = ARRAY_4D(NVAR, NX3_TOT, NX2_TOT, NX1_TOT, double);
+#endif
+  BenchInitData (&data, &grid);
+
+  MakeState (&sweep);
+  bench_cmax = ARRAY_1D(NMAX_POINT, double);
+
+  g_dir = IDIR;
+  SetVectorIndices (IDIR);
+
+  printf ("> PLUTO kernel benchmark [%s]\n", BENCH_NAME);
+  printf ("  box = %d x %d x %d, nghost = %d, NVAR = %d, NTRACER = %d\n",
+          nbox[IDIR], nbox[JDIR], nbox[KDIR], grid.nghost[IDIR],
+          NVAR, NTRACER);
+  printf ("\n  %-14s %12s %12s %12s %10s\n", "kernel", "Mcells/s",
+          "ns/cell", "bytes/cell", "GB/s");
+
+/* --------------------------------------------------------
+   2. Run kernels
+   -------------------------------------------------------- */
+
+  BenchRun ("States", BenchStates, 5.0*NVAR*sizeof(double),
+            &data, &sweep, &grid);
+
+  bench_solver = HLLC_Solver;
+  BenchRun ("HLLC_Solver", BenchRiemann, (5.0*NVAR + 4)*sizeof(double),
+            &data, &sweep, &grid);
+  bench_solver = HLL_Solver;
+  BenchRun ("HLL_Solver", BenchRiemann, (5.0*NVAR + 4)*sizeof(double),
+            &data, &sweep, &grid);
+  bench_solver = LF_Solver;
+  BenchRun ("LF_Solver", BenchRiemann, (5.0*NVAR + 4)*sizeof(double),
+            &data, &sweep, &grid);
+  bench_solver = Roe_Solver;
+  BenchRun ("Roe_Solver", BenchRiemann, (5.0*NVAR + 4)*sizeof(double),
+            &data, &sweep, &grid);
+  bench_solver = AUSMp_Solver;
+  BenchRun ("AUSMp_Solver", BenchRiemann, (5.0*NVAR + 4)*sizeof(double),
+            &data, &sweep, &grid);
+
+  BenchRun ("PrimToCons", BenchPrimToCons, 2.0*NVAR*sizeof(double),
+            &data, &sweep, &grid);
+  BenchRun ("ConsToPrim", BenchConsToPrim,
+            2.0*NVAR*sizeof(double) + sizeof(unsigned char),
+            &data, &sweep, &grid);
+
+#if NSCL > 0
+  bench_solver = HLLC_Solver;
+  BenchRun ("AdvectFlux", BenchAdvectFlux, (3.0*NSCL + 1)*sizeof(double),
+            &data, &sweep, &grid);
+#endif
+
+#if COOLING == TABULATED || COOLING == TOWNSEND
+  BenchRun ("Radiat", BenchRadiat, 2.0*NVAR_COOLING*sizeof(double),
+            &data, &sweep, &grid);
+#elif COOLING == GRACKLE
+  BenchRun ("call_grackle", BenchGrackle, (2.0*NVAR + 2)*sizeof(double),
+            &data, &sweep, &grid);
+#endif
+
+  BenchWriteJSON (fname, nbox);
+  printf ("\n> Results written to %s\n", fname);
+  return 0;
+}
+
+/* ********************************************************************* */
+void BenchInitData (Data *d, Grid *grid)
+/*!
+ * Fill the box with a smooth, non-trivial flow.
+ * Temperature spans 1e4 - 1e8 K so that cooling kernels sample
+ * their full table range.
+ *********************************************************************** */
+{
+  int    i, j, k, nv;
+  double x, y, z, T, mu = 0.609;
+
+  TOT_LOOP(k,j,i){
+    x = grid->x[IDIR][i];
+    y = grid->x[JDIR][j];
+    z = grid->x[KDIR][k];
+
+    T = pow(10.0, 6.0 + 2.0*sin(2.0*CONST_PI*(x + y + z)));
+
+    d->Vc[RHO][k][j][i] = 1.0 + 0.5*sin(2.0*CONST_PI*x)*cos(2.0*CONST_PI*y);
+    d->Vc[VX1][k][j][i] = 10.0*sin(2.0*CONST_PI*y);
+    d->Vc[VX2][k][j][i] = 10.0*cos(2.0*CONST_PI*z);
+    d->Vc[VX3][k][j][i] = 10.0*sin(2.0*CONST_PI*x);
+    d->Vc[PRS][k][j][i] = d->Vc[RHO][k][j][i]*T/(KELVIN*mu);
+
+    NSCL_LOOP(nv) d->Vc[nv][k][j][i] = 0.5*(1.0 + sin(2.0*CONST_PI*x + nv));
+
+  #if COOLING == GRACKLE
+    NIONS_LOOP(nv) d->Vc[nv][k][j][i] = 1.e-10;
+    d->Vc[X_HI][k][j][i]  = 0.9;
+    d->Vc[X_HII][k][j][i] = 0.1;
+    d->Vc[Y_HeI][k][j][i] = 1.0;
+    d->Vc[Z_MET][k][j][i] = 1.0;
+    d->Vgrac[TEMP][k][j][i] = T;
+    d->Vgrac[MU][k][j][i]   = mu;
+    d->Vgrac[TCOOL][k][j][i] = 0.0;
+    NVAR_LOOP(nv) bench_V0[nv][k][j][i] = d->Vc[nv][k][j][i];
+  #endif
+  }
+}
+
+/* ********************************************************************* */
+void BenchLoadPencil (Data *d, Sweep *sweep, int j, int k)
+/*!
+ * Copy the x1-pencil (j,k) into the sweep structure, as done at the
+ * beginning of the direction loop in UpdateStage().
+ *********************************************************************** */
+{
+  int i, nv;
+  double **v = sweep->stateC.v;
+
+  g_j = j;
+  g_k = k;
+  for (i = 0; i < NX1_TOT; i++){
+    NVAR_LOOP(nv) v[i][nv] = d->Vc[nv][k][j][i];
+    sweep->flag[i] = 0;
+  }
+}
+
+/* ********************************************************************* */
+void BenchRun (const char *name, BenchKernel *kernel, double bytes,
+               Data *d, Sweep *sweep, Grid *grid)
+/*!
+ * Time \c kernel by repeating it until at least ::bench_tmin seconds
+ * have been accumulated.
+ * A first untimed call is used for warm-up (table reading, static
+ * allocation, cache).
+ *
+ * \param [in] name    the kernel label
+ * \param [in] kernel  a function sweeping the whole box once and
+ *                     returning the time spent in the kernel
+ * \param [in] bytes   nominal number of bytes per cell
+ *********************************************************************** */
+{
+  long   nrep = 0;
+  double t, tbest = 1.e30, ttot = 0.0;
+  BenchResult *r;
+
+  if (bench_nresults == BENCH_MAX_KERNELS) return;
+
+  kernel (d, sweep, grid);
+  while (ttot < bench_tmin || nrep < 3){
+    t      = kernel (d, sweep, grid);
+    tbest  = MIN(tbest, t);
+    ttot  += t;
+    nrep++;
+  }
+
+  r = bench_result + (bench_nresults++);
+  strcpy (r->name, name);
+  r->ncells = (long)NX1*NX2*NX3;
+  r->nrep   = nrep;
+  r->tbest  = tbest;
+  r->tavg   = ttot/(double)nrep;
+  r->bytes  = bytes;
+
+  printf ("  %-14s %12.3f %12.3f %12.1f %10.3f\n", name,
+          1.e-6*r->ncells/tbest, 1.e9*tbest/r->ncells, bytes,
+          1.e-9*bytes*r->ncells/tbest);
+}
+
+/* ********************************************************************* */
+double BenchStates (Data *d, Sweep *sweep, Grid *grid)
+/*!
+ * Interface reconstruction.
+ *********************************************************************** */
+{
+  int j, k;
+  double t0, t = 0.0;
+
+  KDOM_LOOP(k) JDOM_LOOP(j){
+    BenchLoadPencil (d, sweep, j, k);
+    t0 = BenchClock();
+    States (sweep, IBEG - 1, IEND + 1, grid);
+    t += BenchClock() - t0;
+  }
+  return t;
+}
+
+/* ********************************************************************* */
+double BenchRiemann (Data *d, Sweep *sweep, Grid *grid)
+/*!
+ * Riemann solver ::bench_solver (interface states are computed
+ * beforehand and not timed).
+ *********************************************************************** */
+{
+  int j, k;
+  double t0, t = 0.0;
+
+  KDOM_LOOP(k) JDOM_LOOP(j){
+    BenchLoadPencil (d, sweep, j, k);
+    States (sweep, IBEG - 1, IEND + 1, grid);
+    t0 = BenchClock();
+    bench_solver (sweep, IBEG - 1, IEND, bench_cmax, grid);
+    t += BenchClock() - t0;
+  }
+  return t;
+}
+
+/* ********************************************************************* */
+double BenchPrimToCons (Data *d, Sweep *sweep, Grid *grid)
+/*!
+ * Primitive to conservative conversion.
+ *********************************************************************** */
+{
+  int j, k;
+  double t0, t = 0.0;
+  State *stateC = &(sweep->stateC);
+
+  KDOM_LOOP(k) JDOM_LOOP(j){
+    BenchLoadPencil (d, sweep, j, k);
+    t0 = BenchClock();
+    PrimToCons (stateC->v, stateC->u, 0, NX1_TOT - 1);
+    t += BenchClock() - t0;
+  }
+  return t;
+}
+
+/* ********************************************************************* */
+double BenchConsToPrim (Data *d, Sweep *sweep, Grid *grid)
+/*!
+ * Conservative to primitive conversion.
+ *********************************************************************** */
+{
+  int j, k;
+  double t0, t = 0.0;
+  State *stateC = &(sweep->stateC);
+
+  KDOM_LOOP(k) JDOM_LOOP(j){
+    BenchLoadPencil (d, sweep, j, k);
+    PrimToCons (stateC->v, stateC->u, 0, NX1_TOT - 1);
+    t0 = BenchClock();
+    ConsToPrim (stateC->u, stateC->v, 0, NX1_TOT - 1, sweep->flag);
+    t += BenchClock() - t0;
+  }
+  return t;
+}
+
+#if NSCL > 0
+/* ********************************************************************* */
+double BenchAdvectFlux (Data *d, Sweep *sweep, Grid *grid)
+/*!
+ * Passive scalar upwind fluxes (states and mass flux are computed
+ * beforehand with ::bench_solver and not timed).
+ *********************************************************************** */
+{
+  int j, k;
+  double t0, t = 0.0;
+
+  KDOM_LOOP(k) JDOM_LOOP(j){
+    BenchLoadPencil (d, sweep, j, k);
+    States (sweep, IBEG - 1, IEND + 1, grid);
+    bench_solver (sweep, IBEG - 1, IEND, bench_cmax, grid);
+    t0 = BenchClock();
+    AdvectFlux (sweep, IBEG - 1, IEND, grid);
+    t += BenchClock() - t0;
+  }
+  return t;
+}
+#endif
+
+#if COOLING == TABULATED || COOLING == TOWNSEND
+/* ********************************************************************* */
+double BenchRadiat (Data *d, Sweep *sweep, Grid *grid)
+/*!
+ * Cooling right hand side, one cell at a time as in the ODE solvers
+ * of CoolingSource().
+ *********************************************************************** */
+{
+  int i, j, k, nv;
+  double t0, t = 0.0;
+  static double **v, **rhs;
+
+  if (v == NULL){
+    v   = ARRAY_2D(NMAX_POINT, NVAR_COOLING, double);
+    rhs = ARRAY_2D(NMAX_POINT, NVAR_COOLING, double);
+  }
+
+  KDOM_LOOP(k) JDOM_LOOP(j){
+    IDOM_LOOP(i){
+      NVAR_LOOP(nv) v[i][nv] = d->Vc[nv][k][j][i];
+      v[i][RHOE] = v[i][PRS]/(g_gamma - 1.0);
+    }
+    t0 = BenchClock();
+    IDOM_LOOP(i) Radiat (v[i], rhs[i]);
+    t += BenchClock() - t0;
+  }
+  return t;
+}
+#endif
+
+#if COOLING == GRACKLE
+/* ********************************************************************* */
+double BenchGrackle (Data *d, Sweep *sweep, Grid *grid)
+/*!
+ * Grackle chemistry and cooling update over the whole box.
+ * The initial state is restored before each call (not timed).
+ *********************************************************************** */
+{
+  int i, j, k, nv;
+  double t0;
+  timeStep Dts;
+
+  memset (&Dts, 0, sizeof(timeStep));
+  TOT_LOOP(k,j,i) NVAR_LOOP(nv) d->Vc[nv][k][j][i] = bench_V0[nv][k][j][i];
+
+  t0 = BenchClock();
+  call_grackle (d, g_dt, &Dts, grid, 0, 0, 0, 0);
+  return BenchClock() - t0;
+}
+#endif
+
+/* ********************************************************************* */
+void BenchWriteJSON (char *fname, int *nbox)
+/*!
+ * Write benchmark results to \c fname in JSON format.
+ *********************************************************************** */
+{
+  int n;
+  const char *recon, *cool;
+  BenchResult *r;
+  FILE *fp;
+
+#if RECONSTRUCTION == LINEAR
+  recon = "LINEAR";
+#elif RECONSTRUCTION == PARABOLIC
+  recon = "PARABOLIC";
+#elif RECONSTRUCTION == WENO3
+  recon = "WENO3";
+#elif RECONSTRUCTION == MP5
+  recon = "MP5";
+#elif RECONSTRUCTION == LimO3
+  recon = "LimO3";
+#else
+  recon = "OTHER";
+#endif
+
+#if COOLING == NO
+  cool = "NO";
+#elif COOLING == TABULATED
+  cool = "TABULATED";
+#elif COOLING == TOWNSEND
+  cool = "TOWNSEND";
+#elif COOLING == GRACKLE
+  cool = "GRACKLE";
+#else
+  cool = "OTHER";
+#endif
+
+  fp = fopen(fname, "w");
+  if (fp == NULL){
+    printf ("! BenchWriteJSON(): cannot open %s\n", fname);
+    return;
+  }
+
+  fprintf (fp, "{\n");
+  fprintf (fp, "  \"variant\": \"%s\",\n", BENCH_NAME);
+  fprintf (fp, "  \"physics\": \"HD\",\n");
+  fprintf (fp, "  \"reconstruction\": \"%s\",\n", recon);
+  fprintf (fp, "  \"cooling\": \"%s\",\n", cool);
+  fprintf (fp, "  \"nvar\": %d,\n", NVAR);
+  fprintf (fp, "  \"ntracer\": %d,\n", NTRACER);
+  fprintf (fp, "  \"nghost\": %d,\n", GetNghost());
+  fprintf (fp, "  \"box\": [%d, %d, %d],\n", nbox[IDIR], nbox[JDIR], nbox[KDIR]);
+  fprintf (fp, "  \"tmin\": %g,\n", bench_tmin);
+  fprintf (fp, "  \"kernels\": [\n");
+  for (n = 0; n < bench_nresults; n++){
+    r = bench_result + n;
+    fprintf (fp, "    {\"name\": \"%s\", \"cells\": %ld, \"reps\": %ld, "
+                 "\"time_best\": %.6e, \"time_avg\": %.6e, "
+                 "\"cells_per_sec\": %.6e, \"bytes_per_cell\": %.1f, "
+                 "\"bandwidth_GBs\": %.4f}%s\n",
+             r->name, r->ncells, r->nrep, r->tbest, r->tavg,
+             r->ncells/r->tbest, r->bytes,
+             1.e-9*r->bytes*r->ncells/r->tbest,
+             n < bench_nresults - 1 ? ",":"");
+  }
+  fprintf (fp, "  ]\n}\n");
+  fclose (fp);
+}
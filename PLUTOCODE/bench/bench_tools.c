@@ -0,0 +1,83 @@
+/* ///////////////////////////////////////////////////////////////////// */
+/*!
+  \file
+  \brief Set-up functions shared by the benchmark drivers.
+
+  Provide a monotonic clock and a synthetic uniform Cartesian grid
+  replacing what Initialize() does in PLUTO, so that kernels can be
+  called without a problem directory, pluto.ini or MPI.
+
+  \date   Oct 18, 2026
+*/
+/* ///////////////////////////////////////////////////////////////////// */
+#include "pluto.h"
+#include "bench.h"
+
+/* ********************************************************************* */
+double BenchClock(void)
+/*!
+ * Return the current value of a monotonic wall clock, in seconds.
+ *********************************************************************** */
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + 1.e-9*(double)ts.tv_nsec;
+}
+
+/* ********************************************************************* */
+void BenchSetGrid (int *nbox, Grid *grid)
+/*!
+ * Define a uniform Cartesian grid on the unit cube with \c nbox
+ * interior zones in each direction and set the global index
+ * variables (IBEG, NX1_TOT, NMAX_POINT, ...) as Initialize() does.
+ *********************************************************************** */
+{
+  int i, dir, ngh = GetNghost();
+  double dx;
+
+  for (dir = 0; dir < 3; dir++){
+    grid->nghost[dir]      = ngh;
+    grid->np_int[dir]      = grid->np_int_glob[dir] = nbox[dir];
+    grid->np_tot[dir]      = grid->np_tot_glob[dir] = nbox[dir] + 2*ngh;
+    grid->lbeg[dir]        = grid->gbeg[dir] = grid->beg[dir] = ngh;
+    grid->lend[dir]        = grid->gend[dir] = grid->end[dir] = ngh + nbox[dir] - 1;
+    grid->lbound[dir]      = grid->rbound[dir] = PERIODIC;
+    grid->xbeg[dir]        = grid->xbeg_glob[dir] = g_domBeg[dir] = 0.0;
+    grid->xend[dir]        = grid->xend_glob[dir] = g_domEnd[dir] = 1.0;
+    grid->uniform[dir]     = 1;
+    grid->nproc[dir]       = 1;
+    grid->rank_coord[dir]  = 0;
+
+    grid->x[dir]  = grid->x_glob[dir]  = ARRAY_1D(grid->np_tot[dir], double);
+    grid->xl[dir] = grid->xl_glob[dir] = ARRAY_1D(grid->np_tot[dir], double);
+    grid->xr[dir] = grid->xr_glob[dir] = ARRAY_1D(grid->np_tot[dir], double);
+    grid->dx[dir] = grid->dx_glob[dir] = ARRAY_1D(grid->np_tot[dir], double);
+
+    dx = 1.0/(double)nbox[dir];
+    for (i = 0; i < grid->np_tot[dir]; i++){
+      grid->xl[dir][i] = (i - ngh)*dx;
+      grid->xr[dir][i] = grid->xl[dir][i] + dx;
+      grid->x[dir][i]  = grid->xl[dir][i] + 0.5*dx;
+      grid->dx[dir][i] = dx;
+    }
+    grid->dl_min[dir] = dx;
+  }
+
+  IBEG = grid->lbeg[IDIR]; IEND = grid->lend[IDIR];
+  JBEG = grid->lbeg[JDIR]; JEND = grid->lend[JDIR];
+  KBEG = grid->lbeg[KDIR]; KEND = grid->lend[KDIR];
+
+  NX1 = grid->np_int[IDIR]; NX1_TOT = grid->np_tot[IDIR];
+  NX2 = grid->np_int[JDIR]; NX2_TOT = grid->np_tot[JDIR];
+  NX3 = grid->np_int[KDIR]; NX3_TOT = grid->np_tot[KDIR];
+
+  NMAX_POINT = MAX(NX1_TOT, NX2_TOT);
+  NMAX_POINT = MAX(NMAX_POINT, NX3_TOT);
+
+  SetGeometry (grid);
+  PLM_CoefficientsSet (grid);
+#if RECONSTRUCTION == PARABOLIC
+  PPM_CoefficientsSet (grid);
+#endif
+}
@@ -0,0 +1,45 @@
+/* ---------------------------------------------------------------------
+   Configuration header for the kernel benchmark suite.
+
+   Unlike a problem directory, the reconstruction scheme, cooling
+   module and number of passive scalars are not fixed here: each
+   benchmark variant is compiled by the makefile with its own
+   -DRECONSTRUCTION=..., -DCOOLING=... and -DNTRACER=... flags.
+   --------------------------------------------------------------------- */
+
+#define  PHYSICS                        HD
+#define  DIMENSIONS                     3
+#define  GEOMETRY                       CARTESIAN
+#define  BODY_FORCE                     NO
+#ifndef COOLING
+ #define  COOLING                       NO
+#endif
+#ifndef RECONSTRUCTION
+ #define  RECONSTRUCTION                LINEAR
+#endif
+#define  TIME_STEPPING                  RK2
+#ifndef NTRACER
+ #define  NTRACER                       1
+#endif
+#define  PARTICLES                      NO
+#define  USER_DEF_PARAMETERS            1
+
+/* -- physics dependent declarations -- */
+
+#define  DUST_FLUID                     NO
+#define  EOS                            IDEAL
+#define  ENTROPY_SWITCH                 NO
+#define  THERMAL_CONDUCTION             NO
+#define  VISCOSITY                      NO
+#define  ROTATING_FRAME                 NO
+
+/* -- user-defined parameters (labels) -- */
+
+#define  TINI                           0
+
+/* [Beg] user-defined constants (do not change this line) */
+#define  UNIT_DENSITY                   (1.0e-02*0.609*CONST_mp)
+#define  UNIT_LENGTH                    CONST_pc
+#define  UNIT_VELOCITY                  1.0e+05
+
+/* [End] user-defined constants (do not change this line) */
@@ -0,0 +1,4 @@
+/* ---------------------------------------------------------------------
+   Problem-specific header included by the Townsend cooling module.
+   The benchmark needs no additional declarations.
+   --------------------------------------------------------------------- */
@@ -110,10 +110,28 @@ void InitDomain (Data *d, Grid *grid)
   #endif
 }
 
+#if COOLING==GRACKLE
+/* ********************************************************************* */
+static void NumberDensity (const Data *d, int k, int j, double *n, Grid *grid)
+/*
+ * Total particle number density (cm^-3) along row (k,j), used by the
+ * temperature-density phase diagram.
+ *********************************************************************** */
+{
+  int i;
+  IDOM_LOOP(i){
+    n[i] = d->Vc[RHO][k][j][i]*UNIT_DENSITY/(d->Vgrac[MU][k][j][i]*CONST_mp);
+  }
+}
+#endif
+
 /* ********************************************************************* */
 void Analysis (const Data *d, Grid *grid)
 /*! 
  *  Perform runtime data analysis.
+ *  Volume averages are evaluated by the diagnostics engine (see
+ *  diagnostics.c), which also saves them with a mass-weighted
+ *  temperature-density phase diagram to "diagnostics.bin".
  *
  * \param [in] d the PLUTO Data structure
  * \param [in] grid   pointer to array of Grid structures  
@@ -121,37 +139,34 @@ void Analysis (const Data *d, Grid *grid)
  *********************************************************************** */
 {
   #if COOLING==GRACKLE
-  int k, j, i;
-  
-  double temp = 0., mass = 0., energy = 0., vol = 0., mu=0.;
+  static int id_temp = -1, id_mu, id_mass, id_energy, id_vol;
   static double energy_old = 0.;
   static double temperature_old = 0.;
   static double time_old = 0.;
+
+  if (id_temp < 0) {
+    id_temp   = DiagAdd ("temperature", DIAG_MEAN, DIAG_VGRAC(TEMP), DIAG_WEIGHT_MASS);
+    id_mu     = DiagAdd ("mu", DIAG_MEAN, DIAG_VGRAC(MU), DIAG_WEIGHT_MASS);
+    id_mass   = DiagAdd ("mass", DIAG_SUM, DIAG_UNIT, DIAG_WEIGHT_MASS);
+    id_energy = DiagAdd ("pressure", DIAG_SUM, PRS, DIAG_WEIGHT_VOLUME);
+    id_vol    = DiagAdd ("volume", DIAG_SUM, DIAG_UNIT, DIAG_WEIGHT_VOLUME);
+    DiagAdd ("temperature_min", DIAG_MIN, DIAG_VGRAC(TEMP), DIAG_WEIGHT_NONE);
+    DiagAdd ("temperature_max", DIAG_MAX, DIAG_VGRAC(TEMP), DIAG_WEIGHT_NONE);
+    DiagAddHistogram ("phase_T_n",
+                      DiagFieldFunction(NumberDensity), 1.e-6, 1.e4, 50, 1,
+                      DIAG_VGRAC(TEMP), 1.e1, 1.e9, 40, 1, DIAG_WEIGHT_MASS);
+  }
   if (g_stepNumber==0) {
     temperature_old = g_inputParam[TINI];
     energy_old = (d->Vc[PRS][0][0][0]/d->Vc[RHO][0][0][0])/(g_gamma-1);
   }
-  DOM_LOOP(k, j, i) {
-    temp   += (d->Vc[RHO][k][j][i]*d->Vgrac[TEMP][k][j][i]*grid->dV[k][j][i]);
-    mu     += (d->Vc[RHO][k][j][i]*d->Vgrac[MU][k][j][i]*grid->dV[k][j][i]);
-    mass   += (d->Vc[RHO][k][j][i]*grid->dV[k][j][i]);
-    energy += (d->Vc[PRS][k][j][i]*grid->dV[k][j][i]/(g_gamma-1));
-    vol    += grid->dV[k][j][i];
-  }
-  #ifdef PARALLEL
-  int transfer_size = 5;
-  int transfer = 0;
-  double sendArray[transfer_size], recvArray[transfer_size];
-  sendArray[transfer++] = temp; sendArray[transfer++] = mass; sendArray[transfer++] = energy; sendArray[transfer++] = vol;
-  sendArray[transfer++] = mu;
-  MPI_Allreduce (sendArray, recvArray, transfer_size, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-  transfer = 0;
-  temp = recvArray[transfer++]; mass = recvArray[transfer++]; energy = recvArray[transfer++]; vol = recvArray[transfer++];
-  mu = recvArray[transfer++];
-  #endif
-  double T_avg = temp/mass;
-  double energy_avg = energy/vol;
-  double mu_avg = mu/mass;
+  DiagCompute (d, grid);
+
+  double mass = DiagGet(id_mass);
+  double vol  = DiagGet(id_vol);
+  double T_avg = DiagGet(id_temp);
+  double energy_avg = DiagGet(id_energy)/(g_gamma-1)/vol;
+  double mu_avg = DiagGet(id_mu);
   double dE = 0., dT = 0.;
   double lambda = 0.;
   if (g_stepNumber>0) {